@@ -46,6 +46,14 @@ public class AssetHistory : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"DataTableEditor",
+				"CurveTableEditor",
+				"CurveAssetEditor",
+				"AssetRegistry",
+				"WorkspaceMenuStructure",
+				"DeveloperSettings",
+				"ContentBrowser",
+				"DesktopPlatform",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
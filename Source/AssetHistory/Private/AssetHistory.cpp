@@ -1,16 +1,79 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "AssetHistory.h"
+#include "AssetHistoryMemory.h"
 #include "IAssetTools.h"
 #include "FDataAssetTypeActions.h"
+#include "FDataTableTypeActions.h"
+#include "PrimaryAssetEditorToolkit.h"
+#include "DataTableEditorModule.h"
+#include "CurveTableEditorModule.h"
+#include "CurveAssetEditorModule.h"
+#include "PropertyHistorySearch.h"
+#include "ChurnStatistics.h"
+#include "HistoryWarmUp.h"
+#include "GitBatchFetcher.h"
+#include "LocalSnapshotStore.h"
+#include "PropertyDiff.h"
+#include "Framework/Docking/TabManager.h"
+#include "WorkspaceMenuStructure.h"
+#include "WorkspaceMenuStructureModule.h"
 
 #define LOCTEXT_NAMESPACE "FAssetHistoryModule"
 
+/** Stock editors that get the History toolbar button */
+template<typename FunctorType>
+static void ForEachExtendedEditor(bool bLoadModules, FunctorType&& Functor)
+{
+	if (IDataTableEditorModule* DataTableEditorModule = bLoadModules ? &FModuleManager::LoadModuleChecked<IDataTableEditorModule>("DataTableEditor") : FModuleManager::GetModulePtr<IDataTableEditorModule>("DataTableEditor"))
+	{
+		Functor(*DataTableEditorModule->GetToolBarExtensibilityManager());
+	}
+	if (ICurveTableEditorModule* CurveTableEditorModule = bLoadModules ? &FModuleManager::LoadModuleChecked<ICurveTableEditorModule>("CurveTableEditor") : FModuleManager::GetModulePtr<ICurveTableEditorModule>("CurveTableEditor"))
+	{
+		Functor(*CurveTableEditorModule->GetToolBarExtensibilityManager());
+	}
+	if (ICurveAssetEditorModule* CurveAssetEditorModule = bLoadModules ? &FModuleManager::LoadModuleChecked<ICurveAssetEditorModule>("CurveAssetEditor") : FModuleManager::GetModulePtr<ICurveAssetEditorModule>("CurveAssetEditor"))
+	{
+		Functor(*CurveAssetEditorModule->GetToolBarExtensibilityManager());
+	}
+}
+
 void FAssetHistoryModule::StartupModule()
 {
+	LLM_SCOPE_BYTAG(AssetHistory);
+
 	DataAssetTypeActions = MakeShared<FDataAssetTypeActions>();
+	DataTableTypeActions = MakeShared<FDataTableTypeActions>();
 	IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
 	AssetTools.RegisterAssetTypeActions(DataAssetTypeActions.ToSharedRef());
+	AssetTools.RegisterAssetTypeActions(DataTableTypeActions.ToSharedRef());
+
+	// Built before any diff runs on a worker
+	FPropertyComparators::Get();
+
+	FAssetEditorExtender ToolbarExtender = FAssetEditorExtender::CreateStatic(&AssetHistoryToolbar::MakeToolbarExtender);
+	ToolbarExtenderHandle = ToolbarExtender.GetHandle();
+	ForEachExtendedEditor(true, [&ToolbarExtender](FExtensibilityManager& ExtensibilityManager)
+		{
+			ExtensibilityManager.GetExtenderDelegates().Add(ToolbarExtender);
+		});
+
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(SPropertyHistorySearch::TabName, FOnSpawnTab::CreateStatic(&SPropertyHistorySearch::SpawnTab))
+		.SetDisplayName(LOCTEXT("PropertyHistorySearchTab", "Property History Search"))
+		.SetTooltipText(LOCTEXT("PropertyHistorySearchTabTooltip", "Find which data assets had a property changed recently"))
+		.SetGroup(WorkspaceMenu::GetMenuStructure().GetToolsCategory());
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(SChurnStatistics::TabName, FOnSpawnTab::CreateStatic(&SChurnStatistics::SpawnTab))
+		.SetDisplayName(LOCTEXT("ChurnStatisticsTab", "Asset Churn"))
+		.SetTooltipText(LOCTEXT("ChurnStatisticsTabTooltip", "How often assets and folders change, who changes them and which properties"))
+		.SetGroup(WorkspaceMenu::GetMenuStructure().GetToolsCategory());
+
+	if (GIsEditor && !IsRunningCommandlet())
+	{
+		HistoryWarmUp = MakeShared<FHistoryWarmUp>();
+		FLocalSnapshotStore::Get().Initialize();
+		FChurnStatistics::Get().Initialize();
+	}
 }
 
 void FAssetHistoryModule::ShutdownModule()
@@ -18,8 +81,22 @@ void FAssetHistoryModule::ShutdownModule()
 	FAssetToolsModule* AssetToolsModule = FModuleManager::GetModulePtr<FAssetToolsModule>("AssetTools");
 	IAssetTools& AssetTools = AssetToolsModule->Get();
 	AssetTools.UnregisterAssetTypeActions(DataAssetTypeActions.ToSharedRef());
+	AssetTools.UnregisterAssetTypeActions(DataTableTypeActions.ToSharedRef());
+
+	HistoryWarmUp.Reset();
+	GitBatchFetcher::Shutdown();
+	FLocalSnapshotStore::Get().Shutdown();
+	FChurnStatistics::Get().Shutdown();
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SPropertyHistorySearch::TabName);
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SChurnStatistics::TabName);
+
+	FDelegateHandle Handle = ToolbarExtenderHandle;
+	ForEachExtendedEditor(false, [Handle](FExtensibilityManager& ExtensibilityManager)
+		{
+			ExtensibilityManager.GetExtenderDelegates().RemoveAll([Handle](const FAssetEditorExtender& Delegate) { return Delegate.GetHandle() == Handle; });
+		});
 }
 
 #undef LOCTEXT_NAMESPACE
 	
-IMPLEMENT_MODULE(FAssetHistoryModule, AssetHistory)
\ No newline at end of file
+IMPLEMENT_MODULE(FAssetHistoryModule, AssetHistory)
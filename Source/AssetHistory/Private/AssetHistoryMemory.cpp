@@ -0,0 +1,100 @@
+
+#include "AssetHistoryMemory.h"
+#include "RevisionStore.h"
+#include "LocalSnapshotStore.h"
+#include "ChurnStatistics.h"
+#include "GitBatchFetcher.h"
+#include "SourceControlScheduler.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UObjectIterator.h"
+
+LLM_DEFINE_TAG(AssetHistory);
+LLM_DEFINE_TAG(AssetHistory_Caches, NAME_None, TEXT("AssetHistory"));
+LLM_DEFINE_TAG(AssetHistory_SourceControl, NAME_None, TEXT("AssetHistory"));
+LLM_DEFINE_TAG(AssetHistory_DiffPackages, NAME_None, TEXT("AssetHistory"));
+LLM_DEFINE_TAG(AssetHistory_DiffWindows, NAME_None, TEXT("AssetHistory"));
+LLM_DEFINE_TAG(AssetHistory_Menus, NAME_None, TEXT("AssetHistory"));
+
+static TAtomic<int32> LiveWidgets[(int32)AssetHistoryMemory::EWidget::Num];
+
+static FAutoConsoleCommandWithOutputDevice MemReportCommand(
+	TEXT("AssetHistory.MemReport"),
+	TEXT("Prints the memory held by the AssetHistory caches, loaded diff packages, open diff windows and pending source control jobs"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&AssetHistoryMemory::PrintReport));
+
+void AssetHistoryMemory::TrackWidget(EWidget Widget, int32 Delta)
+{
+	LiveWidgets[(int32)Widget] += Delta;
+}
+
+static double ToMiB(int64 Bytes)
+{
+	return Bytes / (1024.0 * 1024.0);
+}
+
+void AssetHistoryMemory::PrintReport(FOutputDevice& Ar)
+{
+	const int64 RevisionStoreBytes = FRevisionStore::Get().GetAllocatedSize();
+	const int64 LocalHistoryBytes = FLocalSnapshotStore::Get().GetAllocatedSize();
+	const int64 GitBytes = GitBatchFetcher::GetAllocatedSize();
+	const int64 ChurnBytes = FChurnStatistics::Get().GetAllocatedSize();
+	int64 StoredBytes = 0;
+	int64 RawBytes = 0;
+	FRevisionStore::Get().GetStats(StoredBytes, RawBytes);
+
+	Ar.Logf(TEXT("AssetHistory memory"));
+	Ar.Logf(TEXT("  Caches: %.2f MiB"), ToMiB(RevisionStoreBytes + LocalHistoryBytes + GitBytes + ChurnBytes));
+	Ar.Logf(TEXT("    Revision store indices and snapshots: %.2f MiB (%.2f MiB on disk for %.2f MiB of revisions)"), ToMiB(RevisionStoreBytes), ToMiB(StoredBytes), ToMiB(RawBytes));
+	Ar.Logf(TEXT("    Local history: %.2f MiB"), ToMiB(LocalHistoryBytes));
+	Ar.Logf(TEXT("    Churn statistics: %.2f MiB"), ToMiB(ChurnBytes));
+	Ar.Logf(TEXT("    Git batch buffers: %.2f MiB"), ToMiB(GitBytes));
+
+	// Everything the diffs loaded, by this plugin or not, is flagged the same way
+	int32 NumPackages = 0;
+	int64 PackageBytes = 0;
+	TArray<TPair<int64, FString>> Packages;
+	for (TObjectIterator<UPackage> It; It; ++It)
+	{
+		if (!It->HasAnyPackageFlags(PKG_ForDiffing))
+		{
+			continue;
+		}
+
+		TArray<UObject*> Objects;
+		GetObjectsWithPackage(*It, Objects, true);
+		int64 Bytes = 0;
+		for (UObject* Object : Objects)
+		{
+			FArchiveCountMem CountMem(Object);
+			Bytes += CountMem.GetMax();
+		}
+		++NumPackages;
+		PackageBytes += Bytes;
+		Packages.Emplace(Bytes, It->GetName());
+	}
+	Packages.Sort([](const TPair<int64, FString>& A, const TPair<int64, FString>& B) { return A.Key > B.Key; });
+
+	Ar.Logf(TEXT("  Loaded diff packages: %d, %.2f MiB"), NumPackages, ToMiB(PackageBytes));
+	for (int32 Index = 0; Index < FMath::Min(Packages.Num(), 10); ++Index)
+	{
+		Ar.Logf(TEXT("    %.2f MiB %s"), ToMiB(Packages[Index].Key), *Packages[Index].Value);
+	}
+
+	Ar.Logf(TEXT("  Open diff windows: %d data asset, %d data table, %d curve"),
+		LiveWidgets[(int32)EWidget::DataAssetDiff].Load(), LiveWidgets[(int32)EWidget::DataTableDiff].Load(), LiveWidgets[(int32)EWidget::CurveDiff].Load());
+	Ar.Logf(TEXT("  Open merge windows: %d"), LiveWidgets[(int32)EWidget::DataAssetMerge].Load());
+	Ar.Logf(TEXT("  Open revision menus: %d"), LiveWidgets[(int32)EWidget::RevisionMenu].Load());
+	Ar.Logf(TEXT("  Source control jobs: %d pending, %d running"), FSourceControlScheduler::Get().GetNumPendingJobs(), FSourceControlScheduler::Get().GetNumRunningJobs());
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		Ar.Logf(TEXT("  Tagged totals, widgets included: stat LLMFULL, under AssetHistory"));
+		return;
+	}
+#endif
+	Ar.Logf(TEXT("  Run with -LLM for tagged totals, widgets included"));
+}
@@ -0,0 +1,8 @@
+
+#include "AssetHistorySettings.h"
+
+UAssetHistorySettings::UAssetHistorySettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("AssetHistory");
+}
@@ -0,0 +1,46 @@
+
+#include "AssetHistoryTextConvCommandlet.h"
+#include "AssetHistoryMemory.h"
+#include "CanonicalText.h"
+#include "HAL/FileManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetHistoryTextConv, Log, All);
+
+UAssetHistoryTextConvCommandlet::UAssetHistoryTextConvCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = false;
+	ShowErrorCount = false;
+}
+
+int32 UAssetHistoryTextConvCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	ParseCommandLine(*Params, Tokens, Switches);
+
+	FString OutFilename;
+	FParse::Value(*Params, TEXT("Out="), OutFilename);
+	if (Tokens.Num() != 1 || OutFilename.IsEmpty())
+	{
+		UE_LOG(LogAssetHistoryTextConv, Error, TEXT("Usage: -run=AssetHistoryTextConv <Package.uasset> -Out=<File.txt>"));
+		return 1;
+	}
+
+	const FString& Filename = Tokens[0];
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutFilename));
+	if (!Writer)
+	{
+		UE_LOG(LogAssetHistoryTextConv, Error, TEXT("Can't write %s"), *OutFilename);
+		return 1;
+	}
+
+	if (!CanonicalText::WritePackageFile(Filename, *Writer))
+	{
+		UE_LOG(LogAssetHistoryTextConv, Error, TEXT("%s is not a readable package"), *Filename);
+		return 1;
+	}
+	return Writer->Close() ? 0 : 1;
+}
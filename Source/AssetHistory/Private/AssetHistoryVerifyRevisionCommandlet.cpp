@@ -0,0 +1,331 @@
+
+#include "AssetHistoryVerifyRevisionCommandlet.h"
+#include "AssetHistoryMemory.h"
+#include "AssetHistorySettings.h"
+#include "SourceControlScheduler.h"
+#include "RevisionStore.h"
+#include "PackageFileReader.h"
+#include "TaggedPropertyReader.h"
+#include "PropertyDiff.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/DataAsset.h"
+#include "Containers/Queue.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/FileHelper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetHistoryVerify, Log, All);
+
+/** Files per history query */
+static constexpr int32 HistoryBatchSize = 100;
+/** Diff packages loaded between two garbage collections */
+static constexpr int32 AssetsPerCollection = 32;
+
+namespace EVerifyResult
+{
+	enum Type
+	{
+		Ok,
+		Failed,
+		/** Not in source control, not added yet or deleted at that revision */
+		Skipped,
+	};
+}
+
+/** One asset, the worker fills the fetch part and the game thread the rest */
+struct FVerifyEntry
+{
+	FString PackageName;
+	FString AssetName;
+	FString PackageFilename;
+	TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision;
+
+	EVerifyResult::Type Result = EVerifyResult::Ok;
+	FString Error;
+	FString RevisionFilename;
+	/** INDEX_NONE when the tagged streams couldn't be read, the editor then loads both sides to find out */
+	int32 NumTaggedDifferences = INDEX_NONE;
+	int32 NumDifferences = 0;
+
+	double FetchSeconds = 0.0;
+	double TaggedSeconds = 0.0;
+	double LoadSeconds = 0.0;
+	double DiffSeconds = 0.0;
+
+	double GetTotalSeconds() const { return FetchSeconds + TaggedSeconds + LoadSeconds + DiffSeconds; }
+};
+
+/** Newest revision at or before the changelist or date, histories are newest first */
+static TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> FindRevisionAt(const FSourceControlStatePtr& State, int32 Changelist, const FDateTime& Date)
+{
+	for (int32 HistoryIndex = 0; HistoryIndex < State->GetHistorySize(); ++HistoryIndex)
+	{
+		TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = State->GetHistoryItem(HistoryIndex);
+		if (Revision.IsValid() && (Changelist > 0 ? Revision->GetCheckInIdentifier() <= Changelist : Revision->GetDate() <= Date))
+		{
+			return Revision;
+		}
+	}
+	return nullptr;
+}
+
+/** Game thread part of the pipeline: the same loads and comparison the History menu runs */
+static void LoadAndDiff(FVerifyEntry& Entry)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffPackages);
+
+	double StartTime = FPlatformTime::Seconds();
+	UObject* OldAsset = nullptr;
+	if (UPackage* OldPackage = LoadPackage(nullptr, *Entry.RevisionFilename, LOAD_ForDiff | LOAD_DisableCompileOnLoad))
+	{
+		OldAsset = FindObject<UObject>(OldPackage, *Entry.AssetName);
+	}
+	UObject* NewAsset = FSoftObjectPath(FString::Printf(TEXT("%s.%s"), *Entry.PackageName, *Entry.AssetName)).TryLoad();
+	Entry.LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+	if (!OldAsset || !NewAsset)
+	{
+		Entry.Result = EVerifyResult::Failed;
+		Entry.Error = !OldAsset ? TEXT("Unable to load the revision") : TEXT("Unable to load the current asset");
+		return;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	TArray<FSingleObjectDiffEntry> Differences;
+	PropertyDiff::CompareObjects(OldAsset, NewAsset, Differences);
+	Entry.NumDifferences = Differences.Num();
+	Entry.DiffSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+UAssetHistoryVerifyRevisionCommandlet::UAssetHistoryVerifyRevisionCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAssetHistoryVerifyRevisionCommandlet::Main(const FString& Params)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	int32 Changelist = 0;
+	FString DateText;
+	FDateTime Date;
+	FParse::Value(*Params, TEXT("Changelist="), Changelist);
+	FParse::Value(*Params, TEXT("Date="), DateText);
+	if (Changelist <= 0 && (DateText.IsEmpty() || !FDateTime::Parse(DateText, Date)))
+	{
+		UE_LOG(LogAssetHistoryVerify, Error, TEXT("Usage: -run=AssetHistoryVerifyRevision -Changelist=<N> | -Date=<yyyy.mm.dd-hh.mm.ss> [-Path=/Game] [-Report=<File.csv>]"));
+		return 1;
+	}
+
+	FString Path = TEXT("/Game");
+	FString ReportFilename;
+	FParse::Value(*Params, TEXT("Path="), Path);
+	FParse::Value(*Params, TEXT("Report="), ReportFilename);
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	SourceControlProvider.Init();
+	if (!ISourceControlModule::Get().IsEnabled() || !SourceControlProvider.IsAvailable())
+	{
+		UE_LOG(LogAssetHistoryVerify, Error, TEXT("Source control is not available, pass -SCCProvider= or set it up in the editor first"));
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter;
+	Filter.ClassNames.Add(UPrimaryDataAsset::StaticClass()->GetFName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(FName(*Path));
+	Filter.bRecursivePaths = true;
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	TArray<FVerifyEntry> Entries;
+	Entries.Reserve(Assets.Num());
+	TArray<FString> Files;
+	for (const FAssetData& Asset : Assets)
+	{
+		FVerifyEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.PackageName = Asset.PackageName.ToString();
+		Entry.AssetName = Asset.AssetName.ToString();
+		Entry.PackageFilename = SourceControlHelpers::PackageFilename(Entry.PackageName);
+		Files.Add(Entry.PackageFilename);
+	}
+	UE_LOG(LogAssetHistoryVerify, Display, TEXT("Fetching the histories of %d data assets under %s"), Files.Num(), *Path);
+
+	// Provider operations need the game thread, a commandlet has nothing else to do with it
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 FileIndex = 0; FileIndex < Files.Num(); FileIndex += HistoryBatchSize)
+	{
+		TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+		UpdateStatusOp->SetUpdateHistory(true);
+		const TArray<FString> Batch(Files.GetData() + FileIndex, FMath::Min(HistoryBatchSize, Files.Num() - FileIndex));
+		if (SourceControlProvider.Execute(UpdateStatusOp, Batch, EConcurrency::Synchronous) != ECommandResult::Succeeded)
+		{
+			UE_LOG(LogAssetHistoryVerify, Warning, TEXT("History query failed for %d files, they are reported as failed"), Batch.Num());
+		}
+	}
+
+	TArray<int32> ToFetch;
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		FVerifyEntry& Entry = Entries[EntryIndex];
+		FSourceControlStatePtr State = SourceControlProvider.GetState(Entry.PackageFilename, EStateCacheUsage::Use);
+		if (!State.IsValid() || State->GetHistorySize() == 0)
+		{
+			Entry.Result = State.IsValid() && !State->IsSourceControlled() ? EVerifyResult::Skipped : EVerifyResult::Failed;
+			Entry.Error = Entry.Result == EVerifyResult::Skipped ? TEXT("Not in source control") : TEXT("No history");
+			if (Entry.Result == EVerifyResult::Failed)
+			{
+				UE_LOG(LogAssetHistoryVerify, Warning, TEXT("%s: %s"), *Entry.PackageName, *Entry.Error);
+			}
+			continue;
+		}
+
+		Entry.Revision = FindRevisionAt(State, Changelist, Date);
+		if (!Entry.Revision.IsValid() || Entry.Revision->GetAction() == TEXT("delete"))
+		{
+			Entry.Result = EVerifyResult::Skipped;
+			Entry.Error = Entry.Revision.IsValid() ? TEXT("Deleted at that revision") : TEXT("Added after that revision");
+			continue;
+		}
+		ToFetch.Add(EntryIndex);
+	}
+
+	// Fetches are chained from the scheduler's callbacks, which run on its pool threads: a pool thread blocked waiting for a fetch
+	// could be the one that fetch needs. Each revision is handed over as soon as it is on disk, the loads don't wait for the slowest download
+	UE_LOG(LogAssetHistoryVerify, Display, TEXT("Verifying %d revisions"), ToFetch.Num());
+	TQueue<int32, EQueueMode::Mpsc> Fetched;
+	TAtomic<int32> NextToFetch { 0 };
+	TFunction<void()> FetchNext;
+	FetchNext = [&Entries, &ToFetch, &Fetched, &NextToFetch, &FetchNext]()
+	{
+		const int32 FetchIndex = NextToFetch++;
+		if (FetchIndex >= ToFetch.Num())
+		{
+			return;
+		}
+
+		const int32 EntryIndex = ToFetch[FetchIndex];
+		const double FetchStart = FPlatformTime::Seconds();
+		FSourceControlScheduler::Get().QueueRevisionData(Entries[EntryIndex].Revision, ESourceControlJobPriority::Normal,
+			FOnRevisionDataReady::CreateLambda([&Entries, &Fetched, &FetchNext, EntryIndex, FetchStart](bool bSuccess, const TArray64<uint8>& Data)
+				{
+					FVerifyEntry& Entry = Entries[EntryIndex];
+					if (!bSuccess || !FRevisionStore::WriteRevisionFile(Entry.Revision, Data, Entry.RevisionFilename))
+					{
+						Entry.Result = EVerifyResult::Failed;
+						Entry.Error = TEXT("Unable to fetch the revision");
+					}
+					Entry.FetchSeconds = FPlatformTime::Seconds() - FetchStart;
+
+					// The check the History menu runs before loading anything
+					if (Entry.Result == EVerifyResult::Ok)
+					{
+						const double StepStart = FPlatformTime::Seconds();
+						FPackageFileReader OldPackage;
+						FTaggedPropertyTree OldTree;
+						FTaggedPropertyTree NewTree;
+						if (OldPackage.OpenData(Entry.Revision->GetFilename(), TArray64<uint8>(Data)) && OldTree.Read(OldPackage) && NewTree.ReadFile(Entry.PackageFilename))
+						{
+							TArray<FTaggedPropertyDifference> Differences;
+							TaggedPropertyDiff::Diff(OldTree, NewTree, Differences);
+							Entry.NumTaggedDifferences = Differences.Num();
+						}
+						Entry.TaggedSeconds = FPlatformTime::Seconds() - StepStart;
+					}
+
+					// Queued before this one is handed over, the game thread returns as soon as it has the last one
+					FetchNext();
+					Fetched.Enqueue(EntryIndex);
+				}));
+	};
+
+	const int32 NumConcurrentFetches = FMath::Clamp(GetDefault<UAssetHistorySettings>()->MaxConcurrentJobs, 1, FMath::Max(ToFetch.Num(), 1));
+	for (int32 FetchIndex = 0; FetchIndex < NumConcurrentFetches; ++FetchIndex)
+	{
+		FetchNext();
+	}
+
+	int32 NumDone = 0;
+	while (NumDone < ToFetch.Num())
+	{
+		int32 EntryIndex = INDEX_NONE;
+		if (!Fetched.Dequeue(EntryIndex))
+		{
+			// Provider downloads are marshalled to the game thread
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.005f);
+			continue;
+		}
+
+		FVerifyEntry& Entry = Entries[EntryIndex];
+		if (Entry.Result == EVerifyResult::Ok)
+		{
+			LoadAndDiff(Entry);
+		}
+		if (Entry.Result == EVerifyResult::Failed)
+		{
+			UE_LOG(LogAssetHistoryVerify, Warning, TEXT("%s at %s: %s"), *Entry.PackageName, *Entry.Revision->GetRevision(), *Entry.Error);
+		}
+
+		if (++NumDone % AssetsPerCollection == 0)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			UE_LOG(LogAssetHistoryVerify, Display, TEXT("%d / %d verified"), NumDone, ToFetch.Num());
+		}
+	}
+	const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumFailed = 0;
+	int32 NumSkipped = 0;
+	for (const FVerifyEntry& Entry : Entries)
+	{
+		NumFailed += Entry.Result == EVerifyResult::Failed ? 1 : 0;
+		NumSkipped += Entry.Result == EVerifyResult::Skipped ? 1 : 0;
+	}
+
+	TArray<const FVerifyEntry*> Slowest;
+	for (const FVerifyEntry& Entry : Entries)
+	{
+		Slowest.Add(&Entry);
+	}
+	Slowest.Sort([](const FVerifyEntry& A, const FVerifyEntry& B) { return A.GetTotalSeconds() > B.GetTotalSeconds(); });
+	for (int32 Index = 0; Index < FMath::Min(Slowest.Num(), 10); ++Index)
+	{
+		const FVerifyEntry& Entry = *Slowest[Index];
+		UE_LOG(LogAssetHistoryVerify, Display, TEXT("  %.0f ms %s (fetch %.0f, tagged %.0f, load %.0f, diff %.0f)"), Entry.GetTotalSeconds() * 1000.0, *Entry.PackageName,
+			Entry.FetchSeconds * 1000.0, Entry.TaggedSeconds * 1000.0, Entry.LoadSeconds * 1000.0, Entry.DiffSeconds * 1000.0);
+	}
+
+	if (!ReportFilename.IsEmpty())
+	{
+		auto EscapeCsv = [](const FString& Value)
+		{
+			return Value.Contains(TEXT(",")) || Value.Contains(TEXT("\"")) ? TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"") : Value;
+		};
+
+		static const TCHAR* ResultNames[] = { TEXT("Ok"), TEXT("Failed"), TEXT("Skipped") };
+		FString Csv = TEXT("Asset,Revision,Result,FetchMs,TaggedMs,LoadMs,DiffMs,TaggedDifferences,Differences,Error\n");
+		for (const FVerifyEntry& Entry : Entries)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%s,%.1f,%.1f,%.1f,%.1f,%s,%d,%s\n"), *EscapeCsv(Entry.PackageName), Entry.Revision.IsValid() ? *EscapeCsv(Entry.Revision->GetRevision()) : TEXT(""),
+				ResultNames[Entry.Result], Entry.FetchSeconds * 1000.0, Entry.TaggedSeconds * 1000.0, Entry.LoadSeconds * 1000.0, Entry.DiffSeconds * 1000.0,
+				Entry.NumTaggedDifferences == INDEX_NONE ? TEXT("unreadable") : *FString::FromInt(Entry.NumTaggedDifferences), Entry.NumDifferences, *EscapeCsv(Entry.Error));
+		}
+		if (!FFileHelper::SaveStringToFile(Csv, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogAssetHistoryVerify, Error, TEXT("Failed to write %s"), *ReportFilename);
+		}
+	}
+
+	UE_LOG(LogAssetHistoryVerify, Display, TEXT("%d assets, %d verified, %d failed, %d skipped in %.1f s"),
+		Entries.Num(), Entries.Num() - NumFailed - NumSkipped, NumFailed, NumSkipped, TotalSeconds);
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+
+#include "CanonicalText.h"
+#include "AssetHistoryMemory.h"
+#include "PackageFileReader.h"
+#include "TaggedPropertyReader.h"
+
+static const TCHAR* CanonicalTextHeader = TEXT("# AssetHistory canonical text 4\n");
+
+static void AppendEscaped(FString& Out, const FString& Text, bool bIsPath)
+{
+	for (TCHAR Char : Text)
+	{
+		if (Char == TEXT('\\'))
+		{
+			Out += TEXT("\\\\");
+		}
+		else if (Char == TEXT('\n'))
+		{
+			Out += TEXT("\\n");
+		}
+		else if (Char == TEXT('\r'))
+		{
+			Out += TEXT("\\r");
+		}
+		else if (Char == TEXT('=') && bIsPath)
+		{
+			Out += TEXT("\\=");
+		}
+		else
+		{
+			Out.AppendChar(Char);
+		}
+	}
+}
+
+static void WriteUtf8(FArchive& Ar, const FString& Text)
+{
+	FTCHARToUTF8 Utf8(*Text);
+	Ar.Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+}
+
+/** Splits "Path = Value" back, the first '=' not escaped is the separator */
+static void DecodeLine(TArrayView64<const uint8> Line, FString& OutPath, FString& OutValue)
+{
+	const FString Text(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Line.GetData()), (int32)Line.Num()));
+	OutPath.Reset();
+	OutValue.Reset();
+
+	FString* Out = &OutPath;
+	for (int32 Index = 0; Index < Text.Len(); ++Index)
+	{
+		const TCHAR Char = Text[Index];
+		if (Char == TEXT('\\') && Index + 1 < Text.Len())
+		{
+			const TCHAR Next = Text[++Index];
+			Out->AppendChar(Next == TEXT('n') ? TEXT('\n') : Next == TEXT('r') ? TEXT('\r') : Next);
+		}
+		else if (Char == TEXT('=') && Out == &OutPath)
+		{
+			OutPath.RemoveFromEnd(TEXT(" "));
+			Out = &OutValue;
+			if (Index + 1 < Text.Len() && Text[Index + 1] == TEXT(' '))
+			{
+				++Index;
+			}
+		}
+		else
+		{
+			Out->AppendChar(Char);
+		}
+	}
+}
+
+/** Walks the lines of a text, header and comments skipped */
+struct FCanonicalLineCursor
+{
+	TArrayView64<const uint8> Text;
+	int64 Pos = 0;
+	TArrayView64<const uint8> Line;
+	bool bValid = false;
+
+	explicit FCanonicalLineCursor(TArrayView64<const uint8> InText)
+		: Text(InText)
+	{
+		Next();
+	}
+
+	void Next()
+	{
+		bValid = false;
+		while (Pos < Text.Num())
+		{
+			int64 End = Pos;
+			while (End < Text.Num() && Text[End] != '\n')
+			{
+				++End;
+			}
+			Line = Text.Slice(Pos, End - Pos);
+			Pos = End + 1;
+			if (Line.Num() > 0 && Line[0] != '#')
+			{
+				bValid = true;
+				return;
+			}
+		}
+	}
+};
+
+bool CanonicalText::HasCurrentHeader(TArrayView64<const uint8> Text)
+{
+	// The header is plain ASCII, its UTF-8 bytes are its characters
+	const int64 HeaderLen = FCString::Strlen(CanonicalTextHeader);
+	if (Text.Num() < HeaderLen)
+	{
+		return false;
+	}
+	for (int64 Index = 0; Index < HeaderLen; ++Index)
+	{
+		if (Text[Index] != (uint8)CanonicalTextHeader[Index])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void CanonicalText::Write(const FTaggedPropertyTree& Tree, FArchive& Ar)
+{
+	WriteUtf8(Ar, CanonicalTextHeader);
+
+	FString Line;
+	for (const FTaggedPropertyValue& Value : Tree.GetValues())
+	{
+		Line.Reset();
+		AppendEscaped(Line, Value.Path, true);
+		Line += TEXT(" = ");
+		AppendEscaped(Line, Value.Value, false);
+		Line.AppendChar(TEXT('\n'));
+		WriteUtf8(Ar, Line);
+	}
+}
+
+bool CanonicalText::WritePackageData(const FString& Filename, TArray64<uint8>&& Data, FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	FPackageFileReader Package;
+	FTaggedPropertyTree Tree;
+	if (!Package.OpenData(Filename, MoveTemp(Data)) || !Tree.Read(Package))
+	{
+		return false;
+	}
+	Write(Tree, Ar);
+	return true;
+}
+
+bool CanonicalText::WritePackageFile(const FString& Filename, FArchive& Ar)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	FTaggedPropertyTree Tree;
+	if (!Tree.ReadFile(Filename))
+	{
+		return false;
+	}
+	Write(Tree, Ar);
+	return true;
+}
+
+void CanonicalText::Diff(TArrayView64<const uint8> OldText, TArrayView64<const uint8> NewText, TArray<FTaggedPropertyDifference>& OutDifferences)
+{
+	FCanonicalLineCursor Old(OldText);
+	FCanonicalLineCursor New(NewText);
+	FString OldPath, OldValue, NewPath, NewValue;
+	while (Old.bValid || New.bValid)
+	{
+		if (Old.bValid && New.bValid && Old.Line.Num() == New.Line.Num() && FMemory::Memcmp(Old.Line.GetData(), New.Line.GetData(), Old.Line.Num()) == 0)
+		{
+			Old.Next();
+			New.Next();
+			continue;
+		}
+
+		// Same order as FTaggedPropertyTree sorted them in
+		if (Old.bValid)
+		{
+			DecodeLine(Old.Line, OldPath, OldValue);
+		}
+		if (New.bValid)
+		{
+			DecodeLine(New.Line, NewPath, NewValue);
+		}
+
+		if (Old.bValid && New.bValid && OldPath == NewPath)
+		{
+			if (OldValue != NewValue)
+			{
+				OutDifferences.Add({ NewPath, EPropertyDiffType::PropertyValueChanged, OldValue, NewValue });
+			}
+			Old.Next();
+			New.Next();
+		}
+		else if (Old.bValid && (!New.bValid || OldPath < NewPath))
+		{
+			// Missing on the new side means it went back to the class default
+			OutDifferences.Add({ OldPath, EPropertyDiffType::PropertyAddedToA, OldValue, FString() });
+			Old.Next();
+		}
+		else
+		{
+			OutDifferences.Add({ NewPath, EPropertyDiffType::PropertyAddedToB, FString(), NewValue });
+			New.Next();
+		}
+	}
+}
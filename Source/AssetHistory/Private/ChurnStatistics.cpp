@@ -0,0 +1,729 @@
+
+#include "ChurnStatistics.h"
+#include "AssetHistoryMemory.h"
+#include "RevisionStore.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "DesktopPlatformModule.h"
+#include "IDesktopPlatform.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Views/STableRow.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Editor.h"
+#include "EditorStyleSet.h"
+
+#define LOCTEXT_NAMESPACE "SChurnStatistics"
+
+DEFINE_LOG_CATEGORY_STATIC(LogChurnStatistics, Log, All);
+
+static const uint32 ChurnStatisticsMagic = 0x43485341;
+static const int32 ChurnStatisticsVersion = 1;
+/** Authors and properties listed in a summary */
+static constexpr int32 MaxTopEntries = 5;
+/** How often changes are saved, so a crash only loses the last few minutes */
+static constexpr float SaveIntervalSeconds = 300.0f;
+
+const FName SChurnStatistics::TabName(TEXT("AssetHistoryChurnStatistics"));
+
+namespace ChurnStatisticsColumns
+{
+	static const FName Name(TEXT("Name"));
+	static const FName Revisions(TEXT("Revisions"));
+	static const FName RevisionsPerWeek(TEXT("RevisionsPerWeek"));
+	static const FName LastChange(TEXT("LastChange"));
+	static const FName Authors(TEXT("Authors"));
+	static const FName Properties(TEXT("Properties"));
+	static const FName DiffSize(TEXT("DiffSize"));
+}
+
+static FString GetChurnFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AssetHistory") / TEXT("Churn.bin");
+}
+
+static int32 GetWeek(const FDateTime& Date)
+{
+	return int32(Date.GetTicks() / ETimespan::TicksPerWeek);
+}
+
+/** "Name (3), Other (2)", highest counts first */
+static FString FormatTopEntries(const TMap<FString, int32>& Counts)
+{
+	TArray<TPair<FString, int32>> Sorted = Counts.Array();
+	Sorted.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B) { return A.Value != B.Value ? A.Value > B.Value : A.Key < B.Key; });
+
+	FString Result;
+	for (int32 Index = 0; Index < FMath::Min(Sorted.Num(), MaxTopEntries); ++Index)
+	{
+		Result += FString::Printf(TEXT("%s%s (%d)"), Index > 0 ? TEXT(", ") : TEXT(""), *Sorted[Index].Key, Sorted[Index].Value);
+	}
+	return Result;
+}
+
+FChurnStatistics& FChurnStatistics::Get()
+{
+	static FChurnStatistics Statistics;
+	return Statistics;
+}
+
+void FChurnStatistics::Initialize()
+{
+	Load();
+	SaveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float DeltaTime)
+		{
+			SaveIfChanged();
+			return true;
+		}), SaveIntervalSeconds);
+}
+
+void FChurnStatistics::Shutdown()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(SaveTickerHandle);
+	SaveTickerHandle.Reset();
+	SaveIfChanged();
+}
+
+void FChurnStatistics::SaveIfChanged()
+{
+	if (Version != SavedVersion)
+	{
+		Save();
+	}
+}
+
+void FChurnStatistics::AddHistories(const TArray<FString>& InFiles)
+{
+	check(IsInGameThread());
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	bool bChanged = false;
+	for (const FString& File : InFiles)
+	{
+		FSourceControlStatePtr State = SourceControlProvider.GetState(File, EStateCacheUsage::Use);
+		if (!State.IsValid() || State->GetHistorySize() == 0)
+		{
+			continue;
+		}
+
+		FScopeLock ScopeLock(&Lock);
+		FFileChurn& Churn = Files.FindOrAdd(FPaths::ConvertRelativePathToFull(File));
+		for (int32 HistoryIndex = 0; HistoryIndex < State->GetHistorySize(); ++HistoryIndex)
+		{
+			TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = State->GetHistoryItem(HistoryIndex);
+			if (!Revision.IsValid())
+			{
+				break;
+			}
+
+			bool bAlreadyCounted = false;
+			Churn.Revisions.Add(Revision->GetRevision(), &bAlreadyCounted);
+			if (bAlreadyCounted)
+			{
+				continue;
+			}
+
+			const FDateTime Date = Revision->GetDate();
+			++Churn.Weeks.FindOrAdd(GetWeek(Date));
+			++Churn.Authors.FindOrAdd(Revision->GetUserName());
+			Churn.LastChange = FMath::Max(Churn.LastChange, Date);
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		++Version;
+	}
+}
+
+void FChurnStatistics::AddCachedHistories()
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	if (!ISourceControlModule::Get().IsEnabled() || !SourceControlProvider.IsAvailable())
+	{
+		return;
+	}
+
+	const TArray<FSourceControlStateRef> States = SourceControlProvider.GetCachedStateByPredicate([](const FSourceControlStateRef& State)
+		{
+			return State->GetHistorySize() > 0;
+		});
+
+	TArray<FString> HistoryFiles;
+	HistoryFiles.Reserve(States.Num());
+	for (const FSourceControlStateRef& State : States)
+	{
+		HistoryFiles.Add(State->GetFilename());
+	}
+	AddHistories(HistoryFiles);
+}
+
+void FChurnStatistics::AddDifferences(const FString& PackageFilename, const FString& Revision, const TArray<FString>& PropertyPaths)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	// A property changed at several indices still counts once for the revision
+	TSet<FString> Properties;
+	for (const FString& PropertyPath : PropertyPaths)
+	{
+		Properties.Add(StripArrayIndices(PropertyPath));
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	FFileChurn& Churn = Files.FindOrAdd(FPaths::ConvertRelativePathToFull(PackageFilename));
+	bool bAlreadyCounted = false;
+	Churn.DiffedRevisions.Add(Revision, &bAlreadyCounted);
+	if (bAlreadyCounted)
+	{
+		return;
+	}
+
+	Churn.NumDifferences += PropertyPaths.Num();
+	for (const FString& Property : Properties)
+	{
+		++Churn.Properties.FindOrAdd(Property);
+	}
+	++Version;
+}
+
+void FChurnStatistics::GetSummaries(int32 NumWeeks, TArray<TSharedPtr<FChurnSummary>>& OutAssets, TArray<TSharedPtr<FChurnSummary>>& OutFolders)
+{
+	struct FAccumulator
+	{
+		int32 NumAssets = 0;
+		int32 NumRevisions = 0;
+		int32 NumRecentRevisions = 0;
+		FDateTime LastChange;
+		TMap<FString, int32> Authors;
+		TMap<FString, int32> Properties;
+		int32 NumDiffs = 0;
+		int64 NumDifferences = 0;
+
+		void Add(const FFileChurn& Churn, int32 FirstWeek)
+		{
+			++NumAssets;
+			NumRevisions += Churn.Revisions.Num();
+			for (const TPair<int32, int32>& Week : Churn.Weeks)
+			{
+				NumRecentRevisions += Week.Key >= FirstWeek ? Week.Value : 0;
+			}
+			LastChange = FMath::Max(LastChange, Churn.LastChange);
+			for (const TPair<FString, int32>& Author : Churn.Authors)
+			{
+				Authors.FindOrAdd(Author.Key) += Author.Value;
+			}
+			for (const TPair<FString, int32>& Property : Churn.Properties)
+			{
+				Properties.FindOrAdd(Property.Key) += Property.Value;
+			}
+			NumDiffs += Churn.DiffedRevisions.Num();
+			NumDifferences += Churn.NumDifferences;
+		}
+
+		TSharedPtr<FChurnSummary> MakeSummary(const FString& Name, int32 NumWeeks) const
+		{
+			TSharedPtr<FChurnSummary> Summary = MakeShared<FChurnSummary>();
+			Summary->Name = Name;
+			Summary->NumAssets = NumAssets;
+			Summary->NumRevisions = NumRevisions;
+			Summary->RevisionsPerWeek = float(NumRecentRevisions) / NumWeeks;
+			Summary->LastChange = LastChange;
+			Summary->NumAuthors = Authors.Num();
+			Summary->TopAuthors = FormatTopEntries(Authors);
+			Summary->TopProperties = FormatTopEntries(Properties);
+			Summary->NumDiffs = NumDiffs;
+			Summary->AverageDiffSize = NumDiffs > 0 ? float(double(NumDifferences) / NumDiffs) : 0.0f;
+			return Summary;
+		}
+	};
+
+	NumWeeks = FMath::Max(NumWeeks, 1);
+	const int32 FirstWeek = GetWeek(FDateTime::Now()) - NumWeeks + 1;
+
+	TMap<FString, FAccumulator> Folders;
+	FScopeLock ScopeLock(&Lock);
+	for (const TPair<FString, FFileChurn>& File : Files)
+	{
+		// Files outside the mounted content (deleted, renamed, another project's) have nothing to open
+		FString PackageName;
+		if (!FPackageName::TryConvertFilenameToLongPackageName(File.Key, PackageName))
+		{
+			continue;
+		}
+
+		FAccumulator Asset;
+		Asset.Add(File.Value, FirstWeek);
+		OutAssets.Add(Asset.MakeSummary(PackageName, NumWeeks));
+		Folders.FindOrAdd(FPackageName::GetLongPackagePath(PackageName)).Add(File.Value, FirstWeek);
+	}
+
+	for (const TPair<FString, FAccumulator>& Folder : Folders)
+	{
+		OutFolders.Add(Folder.Value.MakeSummary(Folder.Key, NumWeeks));
+	}
+}
+
+SIZE_T FChurnStatistics::GetAllocatedSize()
+{
+	FScopeLock ScopeLock(&Lock);
+	SIZE_T Size = Files.GetAllocatedSize();
+	for (const TPair<FString, FFileChurn>& File : Files)
+	{
+		Size += File.Key.GetAllocatedSize() + File.Value.Revisions.GetAllocatedSize() + File.Value.DiffedRevisions.GetAllocatedSize()
+			+ File.Value.Weeks.GetAllocatedSize() + File.Value.Authors.GetAllocatedSize() + File.Value.Properties.GetAllocatedSize();
+	}
+	return Size;
+}
+
+FString FChurnStatistics::StripArrayIndices(const FString& PropertyPath)
+{
+	FString Result;
+	Result.Reserve(PropertyPath.Len());
+	int32 BracketDepth = 0;
+	for (TCHAR Char : PropertyPath)
+	{
+		if (Char == TEXT('['))
+		{
+			if (BracketDepth++ == 0)
+			{
+				Result.AppendChar(Char);
+			}
+		}
+		else if (Char == TEXT(']'))
+		{
+			BracketDepth = FMath::Max(BracketDepth - 1, 0);
+			if (BracketDepth == 0)
+			{
+				Result.AppendChar(Char);
+			}
+		}
+		else if (BracketDepth == 0)
+		{
+			Result.AppendChar(Char);
+		}
+	}
+	return Result;
+}
+
+void FChurnStatistics::Load()
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetChurnFilename(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(FileData);
+	uint32 Magic = 0;
+	int32 FileVersion = 0;
+	Reader << Magic << FileVersion;
+	if (Magic != ChurnStatisticsMagic || FileVersion != ChurnStatisticsVersion)
+	{
+		return;
+	}
+
+	TMap<FString, FFileChurn> LoadedFiles;
+	Reader << LoadedFiles;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogChurnStatistics, Warning, TEXT("Ignored the churn statistics in %s, the file is damaged"), *GetChurnFilename());
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	Files = MoveTemp(LoadedFiles);
+	++Version;
+	SavedVersion = Version;
+}
+
+void FChurnStatistics::Save()
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	uint32 Magic = ChurnStatisticsMagic;
+	int32 FileVersion = ChurnStatisticsVersion;
+	Writer << Magic << FileVersion;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Writer << Files;
+		SavedVersion = Version;
+	}
+
+	// Saved while the editor runs, a crash mid-write mustn't leave a damaged file that drops everything
+	if (!RevisionStoreFile::SaveAtomically(FileData, GetChurnFilename()))
+	{
+		UE_LOG(LogChurnStatistics, Warning, TEXT("Failed to save the churn statistics to %s"), *GetChurnFilename());
+	}
+}
+
+class SChurnRow : public SMultiColumnTableRow<TSharedPtr<FChurnSummary>>
+{
+public:
+	SLATE_BEGIN_ARGS(SChurnRow){}
+		SLATE_ARGUMENT(TSharedPtr<FChurnSummary>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FChurnSummary>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		FNumberFormattingOptions OneDecimal;
+		OneDecimal.SetMaximumFractionalDigits(1);
+
+		FText Text;
+		if (ColumnName == ChurnStatisticsColumns::Name)
+		{
+			Text = Item->NumAssets > 1 ? FText::Format(LOCTEXT("FolderName", "{0} ({1} assets)"), FText::FromString(Item->Name), FText::AsNumber(Item->NumAssets)) : FText::FromString(Item->Name);
+		}
+		else if (ColumnName == ChurnStatisticsColumns::Revisions)
+		{
+			Text = FText::AsNumber(Item->NumRevisions);
+		}
+		else if (ColumnName == ChurnStatisticsColumns::RevisionsPerWeek)
+		{
+			Text = FText::AsNumber(Item->RevisionsPerWeek, &OneDecimal);
+		}
+		else if (ColumnName == ChurnStatisticsColumns::LastChange)
+		{
+			Text = Item->LastChange.GetTicks() > 0 ? FText::AsDateTime(Item->LastChange) : FText::GetEmpty();
+		}
+		else if (ColumnName == ChurnStatisticsColumns::Authors)
+		{
+			Text = FText::Format(LOCTEXT("Authors", "{0}: {1}"), FText::AsNumber(Item->NumAuthors), FText::FromString(Item->TopAuthors));
+		}
+		else if (ColumnName == ChurnStatisticsColumns::Properties)
+		{
+			Text = FText::FromString(Item->TopProperties);
+		}
+		else
+		{
+			Text = Item->NumDiffs > 0
+				? FText::Format(LOCTEXT("DiffSize", "{0} ({1} diffs)"), FText::AsNumber(Item->AverageDiffSize, &OneDecimal), FText::AsNumber(Item->NumDiffs))
+				: FText::GetEmpty();
+		}
+
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+			];
+	}
+
+private:
+	TSharedPtr<FChurnSummary> Item;
+};
+
+void SChurnStatistics::Construct(const FArguments& InArgs)
+{
+	SortColumn = ChurnStatisticsColumns::RevisionsPerWeek;
+	SortMode = EColumnSortMode::Descending;
+
+	this->ChildSlot
+		[
+			SNew(SBorder)
+			.BorderImage(FEditorStyle::GetBrush("Docking.Tab", ".ContentAreaBrush"))
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					[
+						SNew(SCheckBox)
+						.IsChecked_Lambda([this]() { return bShowFolders ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+						.OnCheckStateChanged_Lambda([this](ECheckBoxState InState)
+							{
+								bShowFolders = InState == ECheckBoxState::Checked;
+								Items = bShowFolders ? FolderItems : AssetItems;
+								SortItems();
+							})
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("ShowFolders", "By folder"))
+						]
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					.Padding(12.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SNew(STextBlock)
+						.Text(LOCTEXT("WeeksLabel", "Rate over the last weeks"))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SBox)
+						.WidthOverride(60.0f)
+						[
+							SNew(SSpinBox<int32>)
+							.MinValue(1)
+							.MaxValue(520)
+							.Value_Lambda([this]() { return NumWeeks; })
+							.OnValueCommitted_Lambda([this](int32 InValue, ETextCommit::Type)
+								{
+									NumWeeks = InValue;
+									Refresh();
+								})
+						]
+					]
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					[
+						SNew(SSpacer)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("ExportChurn", "Export"))
+						.ToolTipText(LOCTEXT("ExportChurnTooltip", "Save the assets and folders shown as CSV"))
+						.IsEnabled_Lambda([this]() { return AssetItems.Num() > 0; })
+						.OnClicked(this, &SChurnStatistics::OnExportClicked)
+					]
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f, 0.0f, 4.0f, 4.0f)
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]()
+						{
+							return FText::Format(LOCTEXT("ChurnStatus", "{0} assets in {1} folders. Updated as histories are fetched and revisions diffed"),
+								FText::AsNumber(AssetItems.Num()), FText::AsNumber(FolderItems.Num()));
+						})
+				]
+				+ SVerticalBox::Slot()
+				[
+					SNew(SBorder)
+					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+					[
+						SAssignNew(ListView, SListView<TSharedPtr<FChurnSummary>>)
+						.ListItemsSource(&Items)
+						.OnGenerateRow(this, &SChurnStatistics::OnGenerateRow)
+						.OnMouseButtonDoubleClick(this, &SChurnStatistics::OnItemDoubleClicked)
+						.SelectionMode(ESelectionMode::Single)
+						.HeaderRow
+						(
+							SNew(SHeaderRow)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::Name)
+							.DefaultLabel(LOCTEXT("NameColumn", "Asset or Folder"))
+							.ManualWidth(260.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::Name)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::Revisions)
+							.DefaultLabel(LOCTEXT("RevisionsColumn", "Revisions"))
+							.ManualWidth(70.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::Revisions)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::RevisionsPerWeek)
+							.DefaultLabel(LOCTEXT("RevisionsPerWeekColumn", "Per Week"))
+							.ManualWidth(70.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::RevisionsPerWeek)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::LastChange)
+							.DefaultLabel(LOCTEXT("LastChangeColumn", "Last Change"))
+							.ManualWidth(140.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::LastChange)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::Authors)
+							.DefaultLabel(LOCTEXT("AuthorsColumn", "Authors"))
+							.ManualWidth(200.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::Authors)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+							+ SHeaderRow::Column(ChurnStatisticsColumns::Properties)
+							.DefaultLabel(LOCTEXT("PropertiesColumn", "Most Changed Properties"))
+							+ SHeaderRow::Column(ChurnStatisticsColumns::DiffSize)
+							.DefaultLabel(LOCTEXT("DiffSizeColumn", "Avg Diff Size"))
+							.ManualWidth(110.0f)
+							.SortMode(this, &SChurnStatistics::GetSortMode, ChurnStatisticsColumns::DiffSize)
+							.OnSort(this, &SChurnStatistics::OnSortModeChanged)
+						)
+					]
+				]
+			]
+		];
+
+	// What the provider cached before the tab opened, only revisions not counted yet are added
+	FChurnStatistics::Get().AddCachedHistories();
+	Refresh();
+	RegisterActiveTimer(1.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SChurnStatistics::PollChanges));
+}
+
+TSharedRef<SDockTab> SChurnStatistics::SpawnTab(const FSpawnTabArgs& Args)
+{
+	return SNew(SDockTab)
+		.TabRole(ETabRole::NomadTab)
+		.OnTabClosed_Lambda([](TSharedRef<SDockTab>) { FChurnStatistics::Get().SaveIfChanged(); })
+		[
+			SNew(SChurnStatistics)
+		];
+}
+
+void SChurnStatistics::Refresh()
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	ShownVersion = FChurnStatistics::Get().GetVersion();
+	AssetItems.Reset();
+	FolderItems.Reset();
+	FChurnStatistics::Get().GetSummaries(NumWeeks, AssetItems, FolderItems);
+	Items = bShowFolders ? FolderItems : AssetItems;
+	SortItems();
+}
+
+void SChurnStatistics::SortItems()
+{
+	const FName Column = SortColumn;
+	const bool bAscending = SortMode == EColumnSortMode::Ascending;
+	auto Compare = [Column](const FChurnSummary& A, const FChurnSummary& B) -> int32
+	{
+		if (Column == ChurnStatisticsColumns::Revisions)
+		{
+			return A.NumRevisions - B.NumRevisions;
+		}
+		if (Column == ChurnStatisticsColumns::RevisionsPerWeek)
+		{
+			return A.RevisionsPerWeek < B.RevisionsPerWeek ? -1 : A.RevisionsPerWeek > B.RevisionsPerWeek ? 1 : 0;
+		}
+		if (Column == ChurnStatisticsColumns::LastChange)
+		{
+			return A.LastChange < B.LastChange ? -1 : A.LastChange > B.LastChange ? 1 : 0;
+		}
+		if (Column == ChurnStatisticsColumns::Authors)
+		{
+			return A.NumAuthors - B.NumAuthors;
+		}
+		if (Column == ChurnStatisticsColumns::DiffSize)
+		{
+			return A.AverageDiffSize < B.AverageDiffSize ? -1 : A.AverageDiffSize > B.AverageDiffSize ? 1 : 0;
+		}
+		return A.Name.Compare(B.Name);
+	};
+
+	Items.Sort([&Compare, bAscending](const TSharedPtr<FChurnSummary>& A, const TSharedPtr<FChurnSummary>& B)
+		{
+			const int32 Result = Compare(*A, *B);
+			if (Result != 0)
+			{
+				return bAscending ? Result < 0 : Result > 0;
+			}
+			return A->Name < B->Name;
+		});
+	ListView->RequestListRefresh();
+}
+
+EActiveTimerReturnType SChurnStatistics::PollChanges(double InCurrentTime, float InDeltaTime)
+{
+	if (FChurnStatistics::Get().GetVersion() != ShownVersion)
+	{
+		Refresh();
+	}
+	return EActiveTimerReturnType::Continue;
+}
+
+FReply SChurnStatistics::OnExportClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	TArray<FString> Filenames;
+	if (!DesktopPlatform || !DesktopPlatform->SaveFileDialog(FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+		LOCTEXT("ExportChurnTitle", "Export Churn Statistics").ToString(), FPaths::ProjectSavedDir(), TEXT("AssetChurn.csv"),
+		TEXT("CSV (*.csv)|*.csv"), EFileDialogFlags::None, Filenames) || Filenames.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	auto EscapeCsv = [](const FString& Value)
+	{
+		return Value.Contains(TEXT(",")) || Value.Contains(TEXT("\"")) ? TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"") : Value;
+	};
+
+	// Assets then folders, so one file answers both questions
+	FString Csv = FString::Printf(TEXT("Kind,Name,Assets,Revisions,RevisionsPerWeek(last %d),LastChange,Authors,TopAuthors,TopProperties,Diffs,AverageDiffSize\n"), NumWeeks);
+	for (const TArray<TSharedPtr<FChurnSummary>>* List : { &AssetItems, &FolderItems })
+	{
+		const TCHAR* Kind = List == &AssetItems ? TEXT("Asset") : TEXT("Folder");
+		for (const TSharedPtr<FChurnSummary>& Item : *List)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%d,%d,%.2f,%s,%d,%s,%s,%d,%.2f\n"), Kind, *EscapeCsv(Item->Name), Item->NumAssets, Item->NumRevisions, Item->RevisionsPerWeek,
+				Item->LastChange.GetTicks() > 0 ? *Item->LastChange.ToIso8601() : TEXT(""), Item->NumAuthors, *EscapeCsv(Item->TopAuthors), *EscapeCsv(Item->TopProperties),
+				Item->NumDiffs, Item->AverageDiffSize);
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Filenames[0], FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogChurnStatistics, Warning, TEXT("Failed to export the churn statistics to %s"), *Filenames[0]);
+	}
+	return FReply::Handled();
+}
+
+void SChurnStatistics::OnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type InSortMode)
+{
+	SortColumn = ColumnId;
+	SortMode = InSortMode;
+	SortItems();
+}
+
+EColumnSortMode::Type SChurnStatistics::GetSortMode(FName ColumnId) const
+{
+	return ColumnId == SortColumn ? SortMode : EColumnSortMode::None;
+}
+
+TSharedRef<ITableRow> SChurnStatistics::OnGenerateRow(TSharedPtr<FChurnSummary> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SChurnRow, OwnerTable)
+		.Item(Item);
+}
+
+void SChurnStatistics::OnItemDoubleClicked(TSharedPtr<FChurnSummary> Item)
+{
+	if (!Item.IsValid())
+	{
+		return;
+	}
+
+	if (bShowFolders)
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().SyncBrowserToFolders({ Item->Name });
+		return;
+	}
+
+	const FSoftObjectPath AssetPath(FString::Printf(TEXT("%s.%s"), *Item->Name, *FPackageName::GetShortName(Item->Name)));
+	if (UObject* Asset = AssetPath.TryLoad())
+	{
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Asset);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
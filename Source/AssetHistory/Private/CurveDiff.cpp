@@ -0,0 +1,843 @@
+
+#include "CurveDiff.h"
+#include "AssetHistoryMemory.h"
+#include "DiffUtils.h"
+#include "Curves/RichCurve.h"
+#include "Curves/SimpleCurve.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/CurveTable.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+#include "Widgets/SLeafWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Layout/SSplitter.h"
+
+#define LOCTEXT_NAMESPACE "SCurveDiff"
+
+static const FName CurveColumnId(TEXT("Curve"));
+static const FName KeysColumnId(TEXT("Keys"));
+static const FName MaxDeviationColumnId(TEXT("MaxDeviation"));
+static const FName MeanDeviationColumnId(TEXT("MeanDeviation"));
+
+static const FLinearColor OldCurveColor(1.0f, 0.35f, 0.35f);
+static const FLinearColor NewCurveColor(0.35f, 1.0f, 0.35f);
+
+/** Keys closer than this in time are considered the same key */
+static constexpr float KeyTimeTolerance = KINDA_SMALL_NUMBER;
+
+bool CurveDiff::IsCurveAsset(const UObject* Object)
+{
+	return Object && (Object->IsA<UCurveFloat>() || Object->IsA<UCurveTable>());
+}
+
+static bool StructContainsCurve(const UStruct* Struct, TMap<const UStruct*, bool>& Cache);
+
+static bool PropertyContainsCurve(const FProperty* Property, TMap<const UStruct*, bool>& Cache)
+{
+	if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		Property = ArrayProperty->Inner;
+	}
+
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		return StructProperty->Struct == FRichCurve::StaticStruct()
+			|| StructProperty->Struct == FSimpleCurve::StaticStruct()
+			|| StructContainsCurve(StructProperty->Struct, Cache);
+	}
+	return false;
+}
+
+static bool StructContainsCurve(const UStruct* Struct, TMap<const UStruct*, bool>& Cache)
+{
+	if (const bool* Found = Cache.Find(Struct))
+	{
+		return *Found;
+	}
+
+	// Seed the cache first so recursive struct layouts terminate
+	Cache.Add(Struct, false);
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		if (PropertyContainsCurve(*It, Cache))
+		{
+			Cache.Add(Struct, true);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void CollectStructCurves(const UStruct* Struct, const void* Data, const FString& Prefix, TArray<TPair<FString, FCurveRef>>& OutCurves, TMap<const UStruct*, bool>& Cache);
+
+static void CollectValueCurves(const FProperty* Property, const void* Value, const FString& Path, TArray<TPair<FString, FCurveRef>>& OutCurves, TMap<const UStruct*, bool>& Cache)
+{
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		if (StructProperty->Struct == FRichCurve::StaticStruct())
+		{
+			const FRichCurve* Curve = static_cast<const FRichCurve*>(Value);
+			OutCurves.Add({ Path, FCurveRef{ Curve, Curve } });
+		}
+		else if (StructProperty->Struct == FSimpleCurve::StaticStruct())
+		{
+			OutCurves.Add({ Path, FCurveRef{ static_cast<const FSimpleCurve*>(Value), nullptr } });
+		}
+		else if (StructContainsCurve(StructProperty->Struct, Cache))
+		{
+			CollectStructCurves(StructProperty->Struct, Value, Path + TEXT("."), OutCurves, Cache);
+		}
+	}
+	else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		if (PropertyContainsCurve(ArrayProperty->Inner, Cache))
+		{
+			FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
+			for (int32 Index = 0; Index < ArrayHelper.Num(); ++Index)
+			{
+				CollectValueCurves(ArrayProperty->Inner, ArrayHelper.GetRawPtr(Index), FString::Printf(TEXT("%s[%d]"), *Path, Index), OutCurves, Cache);
+			}
+		}
+	}
+}
+
+static void CollectStructCurves(const UStruct* Struct, const void* Data, const FString& Prefix, TArray<TPair<FString, FCurveRef>>& OutCurves, TMap<const UStruct*, bool>& Cache)
+{
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		const FProperty* Property = *It;
+		if (!PropertyContainsCurve(Property, Cache))
+		{
+			continue;
+		}
+
+		for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex)
+		{
+			FString Path = Prefix + Property->GetName();
+			if (Property->ArrayDim > 1)
+			{
+				Path += FString::Printf(TEXT("[%d]"), ArrayIndex);
+			}
+			CollectValueCurves(Property, Property->ContainerPtrToValuePtr<void>(Data, ArrayIndex), Path, OutCurves, Cache);
+		}
+	}
+}
+
+void CurveDiff::CollectCurves(const UObject* Object, TArray<TPair<FString, FCurveRef>>& OutCurves)
+{
+	if (!Object)
+	{
+		return;
+	}
+
+	// Curve table rows are not reflected properties
+	if (const UCurveTable* CurveTable = Cast<UCurveTable>(Object))
+	{
+		if (CurveTable->GetCurveTableMode() == ECurveTableMode::SimpleCurves)
+		{
+			for (const TPair<FName, FSimpleCurve*>& Row : CurveTable->GetSimpleCurveRowMap())
+			{
+				OutCurves.Add({ Row.Key.ToString(), FCurveRef{ Row.Value, nullptr } });
+			}
+		}
+		else
+		{
+			for (const TPair<FName, FRichCurve*>& Row : CurveTable->GetRichCurveRowMap())
+			{
+				OutCurves.Add({ Row.Key.ToString(), FCurveRef{ Row.Value, Row.Value } });
+			}
+		}
+		return;
+	}
+
+	TMap<const UStruct*, bool> Cache;
+	CollectStructCurves(Object->GetClass(), Object, FString(), OutCurves, Cache);
+}
+
+static bool KeysMatch(const FRichCurveKey& A, const FRichCurveKey& B)
+{
+	return A.InterpMode == B.InterpMode
+		&& A.TangentMode == B.TangentMode
+		&& A.TangentWeightMode == B.TangentWeightMode
+		&& FMath::IsNearlyEqual(A.Value, B.Value)
+		&& FMath::IsNearlyEqual(A.ArriveTangent, B.ArriveTangent)
+		&& FMath::IsNearlyEqual(A.LeaveTangent, B.LeaveTangent)
+		&& FMath::IsNearlyEqual(A.ArriveTangentWeight, B.ArriveTangentWeight)
+		&& FMath::IsNearlyEqual(A.LeaveTangentWeight, B.LeaveTangentWeight);
+}
+
+/** Mixed or simple key types only share time and value */
+template<typename KeyTypeA, typename KeyTypeB>
+static bool KeysMatch(const KeyTypeA& A, const KeyTypeB& B)
+{
+	return FMath::IsNearlyEqual(A.Value, B.Value);
+}
+
+template<typename KeyTypeA, typename KeyTypeB>
+static void CompareKeyArrays(const TArray<KeyTypeA>& OldKeys, const TArray<KeyTypeB>& NewKeys, FCurveDiffStats& OutStats)
+{
+	OutStats.NumKeysOld = OldKeys.Num();
+	OutStats.NumKeysNew = NewKeys.Num();
+
+	// Both arrays are sorted by time, so a single merge pass joins them
+	int32 OldIndex = 0;
+	int32 NewIndex = 0;
+	while (OldIndex < OldKeys.Num() && NewIndex < NewKeys.Num())
+	{
+		const float OldTime = OldKeys[OldIndex].Time;
+		const float NewTime = NewKeys[NewIndex].Time;
+		if (FMath::IsNearlyEqual(OldTime, NewTime, KeyTimeTolerance))
+		{
+			OutStats.NumKeysChanged += KeysMatch(OldKeys[OldIndex], NewKeys[NewIndex]) ? 0 : 1;
+			++OldIndex;
+			++NewIndex;
+		}
+		else if (OldTime < NewTime)
+		{
+			++OutStats.NumKeysRemoved;
+			++OldIndex;
+		}
+		else
+		{
+			++OutStats.NumKeysAdded;
+			++NewIndex;
+		}
+	}
+	OutStats.NumKeysRemoved += OldKeys.Num() - OldIndex;
+	OutStats.NumKeysAdded += NewKeys.Num() - NewIndex;
+}
+
+template<typename KeyTypeA>
+static void CompareKeysAgainst(const TArray<KeyTypeA>& OldKeys, const FCurveRef& New, FCurveDiffStats& OutStats)
+{
+	if (New.RichCurve)
+	{
+		CompareKeyArrays(OldKeys, New.RichCurve->GetConstRefOfKeys(), OutStats);
+	}
+	else
+	{
+		CompareKeyArrays(OldKeys, static_cast<const FSimpleCurve*>(New.Curve)->GetConstRefOfKeys(), OutStats);
+	}
+}
+
+void CurveDiff::CompareKeys(const FCurveRef& Old, const FCurveRef& New, FCurveDiffStats& OutStats)
+{
+	if (!Old.IsValid() || !New.IsValid())
+	{
+		OutStats.NumKeysOld = Old.IsValid() ? Old.Curve->GetNumKeys() : 0;
+		OutStats.NumKeysNew = New.IsValid() ? New.Curve->GetNumKeys() : 0;
+		OutStats.NumKeysRemoved = OutStats.NumKeysOld;
+		OutStats.NumKeysAdded = OutStats.NumKeysNew;
+		return;
+	}
+
+	if (Old.RichCurve)
+	{
+		CompareKeysAgainst(Old.RichCurve->GetConstRefOfKeys(), New, OutStats);
+	}
+	else
+	{
+		CompareKeysAgainst(static_cast<const FSimpleCurve*>(Old.Curve)->GetConstRefOfKeys(), New, OutStats);
+	}
+}
+
+/** Evaluates the samples [First, Last) that all fall between Key1 and Key2, mirroring FRichCurve::Eval */
+static void EvalRichSegment(const FRichCurve& Curve, const FRichCurveKey& Key1, const FRichCurveKey& Key2, float StartTime, float Step, int32 First, int32 Last, TArrayView<float> OutValues)
+{
+	const float Diff = Key2.Time - Key1.Time;
+	if (Diff <= 0.0f || Key1.InterpMode == RCIM_Constant)
+	{
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			OutValues[Index] = Key1.Value;
+		}
+		return;
+	}
+
+	// Weighted tangents need an iterative solve, leave those to the curve itself
+	const bool bWeighted = Key1.InterpMode != RCIM_Linear
+		&& ((Key1.TangentWeightMode == RCTWM_WeightedLeave || Key1.TangentWeightMode == RCTWM_WeightedBoth)
+			|| (Key2.TangentWeightMode == RCTWM_WeightedArrive || Key2.TangentWeightMode == RCTWM_WeightedBoth));
+	if (bWeighted)
+	{
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			OutValues[Index] = Curve.Eval(StartTime + Step * Index);
+		}
+		return;
+	}
+
+	const float OneThird = 1.0f / 3.0f;
+	const float P0 = Key1.Value;
+	const float P3 = Key2.Value;
+	const float P1 = P0 + Key1.LeaveTangent * Diff * OneThird;
+	const float P2 = P3 - Key2.ArriveTangent * Diff * OneThird;
+	const bool bLinear = Key1.InterpMode == RCIM_Linear;
+
+	const VectorRegister4Float VecKeyTime = VectorSetFloat1(Key1.Time);
+	const VectorRegister4Float VecInvDiff = VectorSetFloat1(1.0f / Diff);
+	const VectorRegister4Float VecStep4 = VectorSetFloat1(Step * 4.0f);
+	const VectorRegister4Float VecP0 = VectorSetFloat1(P0);
+	const VectorRegister4Float VecP1 = VectorSetFloat1(P1);
+	const VectorRegister4Float VecP2 = VectorSetFloat1(P2);
+	const VectorRegister4Float VecP3 = VectorSetFloat1(P3);
+	const VectorRegister4Float VecThree = VectorSetFloat1(3.0f);
+	const VectorRegister4Float VecOne = GlobalVectorConstants::FloatOne;
+
+	VectorRegister4Float VecTime = MakeVectorRegisterFloat(
+		StartTime + Step * First,
+		StartTime + Step * (First + 1),
+		StartTime + Step * (First + 2),
+		StartTime + Step * (First + 3));
+
+	int32 Index = First;
+	for (; Index + 4 <= Last; Index += 4)
+	{
+		const VectorRegister4Float Alpha = VectorMultiply(VectorSubtract(VecTime, VecKeyTime), VecInvDiff);
+		VectorRegister4Float Result;
+		if (bLinear)
+		{
+			Result = VectorMultiplyAdd(Alpha, VectorSubtract(VecP3, VecP0), VecP0);
+		}
+		else
+		{
+			// Bernstein form of the cubic bezier
+			const VectorRegister4Float OneMinusAlpha = VectorSubtract(VecOne, Alpha);
+			const VectorRegister4Float OneMinusAlphaSq = VectorMultiply(OneMinusAlpha, OneMinusAlpha);
+			const VectorRegister4Float AlphaSq = VectorMultiply(Alpha, Alpha);
+			const VectorRegister4Float B0 = VectorMultiply(OneMinusAlphaSq, OneMinusAlpha);
+			const VectorRegister4Float B1 = VectorMultiply(VecThree, VectorMultiply(OneMinusAlphaSq, Alpha));
+			const VectorRegister4Float B2 = VectorMultiply(VecThree, VectorMultiply(OneMinusAlpha, AlphaSq));
+			const VectorRegister4Float B3 = VectorMultiply(AlphaSq, Alpha);
+			Result = VectorMultiply(B0, VecP0);
+			Result = VectorMultiplyAdd(B1, VecP1, Result);
+			Result = VectorMultiplyAdd(B2, VecP2, Result);
+			Result = VectorMultiplyAdd(B3, VecP3, Result);
+		}
+		VectorStore(Result, &OutValues[Index]);
+		VecTime = VectorAdd(VecTime, VecStep4);
+	}
+
+	for (; Index < Last; ++Index)
+	{
+		const float Alpha = (StartTime + Step * Index - Key1.Time) / Diff;
+		OutValues[Index] = bLinear ? FMath::Lerp(P0, P3, Alpha) : FMath::CubicInterp(P0, (P1 - P0) * 3.0f, P3, (P3 - P2) * 3.0f, Alpha);
+	}
+}
+
+void CurveDiff::SampleCurve(const FCurveRef& Curve, float StartTime, float EndTime, TArrayView<float> OutValues)
+{
+	const int32 NumSamples = OutValues.Num();
+	if (NumSamples == 0)
+	{
+		return;
+	}
+
+	const float Step = NumSamples > 1 ? (EndTime - StartTime) / (NumSamples - 1) : 0.0f;
+	if (!Curve.RichCurve || Curve.RichCurve->GetNumKeys() < 2)
+	{
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			OutValues[Index] = Curve.IsValid() ? Curve.Curve->Eval(StartTime + Step * Index) : 0.0f;
+		}
+		return;
+	}
+
+	const FRichCurve& RichCurve = *Curve.RichCurve;
+	const TArray<FRichCurveKey>& Keys = RichCurve.GetConstRefOfKeys();
+	const float FirstKeyTime = Keys[0].Time;
+	const float LastKeyTime = Keys.Last().Time;
+
+	// Samples are sorted, so the segment only ever moves forward instead of a binary search per sample
+	int32 Segment = 0;
+	int32 Sample = 0;
+	while (Sample < NumSamples)
+	{
+		const float Time = StartTime + Step * Sample;
+		if (Time < FirstKeyTime || Time >= LastKeyTime)
+		{
+			// Extrapolation is rare and depends on the infinity settings
+			OutValues[Sample] = RichCurve.Eval(Time);
+			++Sample;
+			continue;
+		}
+
+		while (Keys[Segment + 1].Time <= Time)
+		{
+			++Segment;
+		}
+
+		const FRichCurveKey& Key1 = Keys[Segment];
+		const FRichCurveKey& Key2 = Keys[Segment + 1];
+		int32 SegmentEnd = Sample + 1;
+		while (SegmentEnd < NumSamples && StartTime + Step * SegmentEnd < Key2.Time)
+		{
+			++SegmentEnd;
+		}
+
+		EvalRichSegment(RichCurve, Key1, Key2, StartTime, Step, Sample, SegmentEnd, OutValues);
+		Sample = SegmentEnd;
+	}
+}
+
+void CurveDiff::ComputeDeviation(const FCurveRef& Old, const FCurveRef& New, int32 NumSamples, FCurveDiffStats& OutStats)
+{
+	float StartTime = TNumericLimits<float>::Max();
+	float EndTime = TNumericLimits<float>::Lowest();
+	for (const FCurveRef* Curve : { &Old, &New })
+	{
+		if (Curve->IsValid() && Curve->Curve->GetNumKeys() > 0)
+		{
+			float MinTime, MaxTime;
+			Curve->Curve->GetTimeRange(MinTime, MaxTime);
+			StartTime = FMath::Min(StartTime, MinTime);
+			EndTime = FMath::Max(EndTime, MaxTime);
+		}
+	}
+
+	if (StartTime > EndTime || NumSamples <= 0)
+	{
+		return;
+	}
+
+	OutStats.SampleStart = StartTime;
+	OutStats.SampleEnd = EndTime;
+
+	TArray<float> OldValues;
+	TArray<float> NewValues;
+	OldValues.SetNumUninitialized(NumSamples);
+	NewValues.SetNumUninitialized(NumSamples);
+	SampleCurve(Old, StartTime, EndTime, OldValues);
+	SampleCurve(New, StartTime, EndTime, NewValues);
+
+	VectorRegister4Float VecMax = GlobalVectorConstants::FloatZero;
+	VectorRegister4Float VecSum = GlobalVectorConstants::FloatZero;
+	int32 Index = 0;
+	for (; Index + 4 <= NumSamples; Index += 4)
+	{
+		const VectorRegister4Float Deviation = VectorAbs(VectorSubtract(VectorLoad(&NewValues[Index]), VectorLoad(&OldValues[Index])));
+		VecMax = VectorMax(VecMax, Deviation);
+		VecSum = VectorAdd(VecSum, Deviation);
+	}
+
+	alignas(16) float Lanes[4];
+	VectorStoreAligned(VecMax, Lanes);
+	float MaxDeviation = FMath::Max(FMath::Max(Lanes[0], Lanes[1]), FMath::Max(Lanes[2], Lanes[3]));
+	VectorStoreAligned(VecSum, Lanes);
+	double SumDeviation = (double)Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+	for (; Index < NumSamples; ++Index)
+	{
+		const float Deviation = FMath::Abs(NewValues[Index] - OldValues[Index]);
+		MaxDeviation = FMath::Max(MaxDeviation, Deviation);
+		SumDeviation += Deviation;
+	}
+
+	OutStats.MaxDeviation = MaxDeviation;
+	OutStats.MeanDeviation = (float)(SumDeviation / NumSamples);
+
+	const float Step = NumSamples > 1 ? (EndTime - StartTime) / (NumSamples - 1) : 0.0f;
+	for (Index = 0; Index < NumSamples; ++Index)
+	{
+		if (FMath::Abs(NewValues[Index] - OldValues[Index]) == MaxDeviation)
+		{
+			OutStats.MaxDeviationTime = StartTime + Step * Index;
+			break;
+		}
+	}
+}
+
+void CurveDiff::DiffObjects(const UObject* OldObject, const UObject* NewObject, TArray<TSharedPtr<FCurveDiffEntry>>& OutEntries)
+{
+	TArray<TPair<FString, FCurveRef>> OldCurves;
+	TArray<TPair<FString, FCurveRef>> NewCurves;
+	CollectCurves(OldObject, OldCurves);
+	CollectCurves(NewObject, NewCurves);
+
+	TMap<FString, FCurveRef> OldByPath;
+	OldByPath.Reserve(OldCurves.Num());
+	for (const TPair<FString, FCurveRef>& Curve : OldCurves)
+	{
+		OldByPath.Add(Curve.Key, Curve.Value);
+	}
+
+	const int32 FirstEntry = OutEntries.Num();
+	for (const TPair<FString, FCurveRef>& Curve : NewCurves)
+	{
+		TSharedPtr<FCurveDiffEntry> Entry = MakeShared<FCurveDiffEntry>();
+		Entry->Path = Curve.Key;
+		Entry->NewCurve = Curve.Value;
+		if (FCurveRef* OldCurve = OldByPath.Find(Curve.Key))
+		{
+			Entry->OldCurve = *OldCurve;
+			OldByPath.Remove(Curve.Key);
+		}
+
+		CompareKeys(Entry->OldCurve, Entry->NewCurve, Entry->Stats);
+		if (Entry->Stats.HasKeyChanges())
+		{
+			OutEntries.Add(Entry);
+		}
+	}
+
+	for (const TPair<FString, FCurveRef>& Curve : OldCurves)
+	{
+		if (OldByPath.Contains(Curve.Key))
+		{
+			TSharedPtr<FCurveDiffEntry> Entry = MakeShared<FCurveDiffEntry>();
+			Entry->Path = Curve.Key;
+			Entry->OldCurve = Curve.Value;
+			CompareKeys(Entry->OldCurve, Entry->NewCurve, Entry->Stats);
+			OutEntries.Add(Entry);
+		}
+	}
+
+	// Sampling only runs for curves whose keys changed, and each curve is independent
+	ParallelFor(OutEntries.Num() - FirstEntry, [&OutEntries, FirstEntry](int32 Index)
+		{
+			FCurveDiffEntry& Entry = *OutEntries[FirstEntry + Index];
+			ComputeDeviation(Entry.OldCurve, Entry.NewCurve, DefaultNumSamples, Entry.Stats);
+		});
+}
+
+/** Overlaid plot of the old and new revision of a curve */
+class SCurveDiffPlot : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SCurveDiffPlot){}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs)
+	{
+	}
+
+	void SetEntry(TSharedPtr<FCurveDiffEntry> InEntry)
+	{
+		Entry = InEntry;
+		OldValues.Reset();
+		NewValues.Reset();
+		if (Entry.IsValid())
+		{
+			OldValues.SetNumUninitialized(CurveDiff::DefaultNumSamples);
+			NewValues.SetNumUninitialized(CurveDiff::DefaultNumSamples);
+			CurveDiff::SampleCurve(Entry->OldCurve, Entry->Stats.SampleStart, Entry->Stats.SampleEnd, OldValues);
+			CurveDiff::SampleCurve(Entry->NewCurve, Entry->Stats.SampleStart, Entry->Stats.SampleEnd, NewValues);
+		}
+	}
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override
+	{
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(), FEditorStyle::GetBrush("ToolPanel.DarkGroupBorder"));
+		if (!Entry.IsValid() || OldValues.Num() == 0)
+		{
+			return LayerId;
+		}
+
+		float MinValue = TNumericLimits<float>::Max();
+		float MaxValue = TNumericLimits<float>::Lowest();
+		for (const TArray<float>* Values : { &OldValues, &NewValues })
+		{
+			for (float Value : *Values)
+			{
+				MinValue = FMath::Min(MinValue, Value);
+				MaxValue = FMath::Max(MaxValue, Value);
+			}
+		}
+		if (FMath::IsNearlyEqual(MinValue, MaxValue))
+		{
+			MinValue -= 1.0f;
+			MaxValue += 1.0f;
+		}
+
+		const FVector2D Size = AllottedGeometry.GetLocalSize();
+		const float Margin = 8.0f;
+		const float Width = FMath::Max(Size.X - 2.0f * Margin, 1.0f);
+		const float Height = FMath::Max(Size.Y - 2.0f * Margin, 1.0f);
+		auto ToLocal = [&](int32 Index, float Value)
+		{
+			const float X = Margin + Width * Index / FMath::Max(OldValues.Num() - 1, 1);
+			const float Y = Margin + Height * (1.0f - (Value - MinValue) / (MaxValue - MinValue));
+			return FVector2D(X, Y);
+		};
+
+		TArray<FVector2D> Points;
+		Points.SetNumUninitialized(OldValues.Num());
+		if (Entry->OldCurve.IsValid())
+		{
+			for (int32 Index = 0; Index < OldValues.Num(); ++Index)
+			{
+				Points[Index] = ToLocal(Index, OldValues[Index]);
+			}
+			FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(), Points, ESlateDrawEffect::None, OldCurveColor, true, 1.5f);
+		}
+		if (Entry->NewCurve.IsValid())
+		{
+			for (int32 Index = 0; Index < NewValues.Num(); ++Index)
+			{
+				Points[Index] = ToLocal(Index, NewValues[Index]);
+			}
+			FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 2, AllottedGeometry.ToPaintGeometry(), Points, ESlateDrawEffect::None, NewCurveColor, true, 1.5f);
+		}
+
+		// Mark where the two revisions are furthest apart
+		const FCurveDiffStats& Stats = Entry->Stats;
+		if (Stats.SampleEnd > Stats.SampleStart)
+		{
+			const float X = Margin + Width * (Stats.MaxDeviationTime - Stats.SampleStart) / (Stats.SampleEnd - Stats.SampleStart);
+			TArray<FVector2D> Marker = { FVector2D(X, Margin), FVector2D(X, Margin + Height) };
+			FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 3, AllottedGeometry.ToPaintGeometry(), Marker, ESlateDrawEffect::None, DiffViewUtils::Differs().CopyWithNewOpacity(0.5f), true, 1.0f);
+		}
+
+		return LayerId + 3;
+	}
+
+	virtual FVector2D ComputeDesiredSize(float) const override
+	{
+		return FVector2D(400.0f, 300.0f);
+	}
+
+private:
+	TSharedPtr<FCurveDiffEntry> Entry;
+	TArray<float> OldValues;
+	TArray<float> NewValues;
+};
+
+class SCurveDiffRow : public SMultiColumnTableRow<TSharedPtr<FCurveDiffEntry>>
+{
+public:
+	SLATE_BEGIN_ARGS(SCurveDiffRow){}
+		SLATE_ARGUMENT(TSharedPtr<FCurveDiffEntry>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FCurveDiffEntry>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		const FCurveDiffStats& Stats = Item->Stats;
+		FText Text;
+		if (ColumnName == CurveColumnId)
+		{
+			Text = FText::FromString(Item->Path);
+		}
+		else if (ColumnName == KeysColumnId)
+		{
+			if (!Item->OldCurve.IsValid())
+			{
+				Text = LOCTEXT("CurveAdded", "Added");
+			}
+			else if (!Item->NewCurve.IsValid())
+			{
+				Text = LOCTEXT("CurveRemoved", "Removed");
+			}
+			else
+			{
+				Text = FText::Format(LOCTEXT("KeyChanges", "{0} changed, +{1} -{2}"),
+					FText::AsNumber(Stats.NumKeysChanged), FText::AsNumber(Stats.NumKeysAdded), FText::AsNumber(Stats.NumKeysRemoved));
+			}
+		}
+		else if (ColumnName == MaxDeviationColumnId)
+		{
+			Text = FText::AsNumber(Stats.MaxDeviation);
+		}
+		else if (ColumnName == MeanDeviationColumnId)
+		{
+			Text = FText::AsNumber(Stats.MeanDeviation);
+		}
+
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+				.ColorAndOpacity(DiffViewUtils::Differs())
+			];
+	}
+
+private:
+	TSharedPtr<FCurveDiffEntry> Item;
+};
+
+void SCurveDiff::Construct(const FArguments& InArgs)
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::CurveDiff, 1);
+
+	check(InArgs._AssetOld && InArgs._AssetNew);
+	AssetOld = InArgs._AssetOld;
+	AssetNew = InArgs._AssetNew;
+
+	if (InArgs._ParentWindow.IsValid())
+	{
+		WeakParentWindow = InArgs._ParentWindow;
+
+		AssetEditorCloseDelegate = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().AddSP(this, &SCurveDiff::OnCloseAssetEditor);
+	}
+
+	CurveDiff::DiffObjects(AssetOld, AssetNew, Entries);
+
+	const FText LegendText = FText::Format(LOCTEXT("CurveLegend", "Old: {0}    New: {1}"),
+		FText::FromString(InArgs._OldRevision.Revision), FText::FromString(InArgs._NewRevision.Revision));
+
+	this->ChildSlot
+		[
+			SNew(SSplitter)
+			+ SSplitter::Slot()
+			.Value(0.4f)
+			[
+				SNew(SBorder)
+				.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+				[
+					SAssignNew(CurveListView, SListView<TSharedPtr<FCurveDiffEntry>>)
+					.ListItemsSource(&Entries)
+					.OnGenerateRow(this, &SCurveDiff::OnGenerateRow)
+					.OnSelectionChanged(this, &SCurveDiff::OnSelectionChanged)
+					.SelectionMode(ESelectionMode::Single)
+					.HeaderRow
+					(
+						SNew(SHeaderRow)
+						+ SHeaderRow::Column(CurveColumnId)
+						.DefaultLabel(LOCTEXT("CurveColumn", "Curve"))
+						.FillWidth(0.4f)
+						+ SHeaderRow::Column(KeysColumnId)
+						.DefaultLabel(LOCTEXT("KeysColumn", "Keys"))
+						.FillWidth(0.3f)
+						+ SHeaderRow::Column(MaxDeviationColumnId)
+						.DefaultLabel(LOCTEXT("MaxDeviationColumn", "Max deviation"))
+						.FillWidth(0.15f)
+						+ SHeaderRow::Column(MeanDeviationColumnId)
+						.DefaultLabel(LOCTEXT("MeanDeviationColumn", "Mean deviation"))
+						.FillWidth(0.15f)
+					)
+				]
+			]
+			+ SSplitter::Slot()
+			.Value(0.6f)
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(STextBlock)
+						.Text(LOCTEXT("OldCurveLegend", "Old"))
+						.ColorAndOpacity(OldCurveColor)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(8.0f, 0.0f)
+					[
+						SNew(STextBlock)
+						.Text(LOCTEXT("NewCurveLegend", "New"))
+						.ColorAndOpacity(NewCurveColor)
+					]
+					+ SHorizontalBox::Slot()
+					[
+						SNew(SSpacer)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(STextBlock)
+						.Text(LegendText)
+					]
+				]
+				+ SVerticalBox::Slot()
+				[
+					SAssignNew(Plot, SCurveDiffPlot)
+				]
+			]
+		];
+
+	if (Entries.Num() > 0)
+	{
+		CurveListView->SetSelection(Entries[0]);
+	}
+}
+
+SCurveDiff::~SCurveDiff()
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::CurveDiff, -1);
+
+	if (AssetEditorCloseDelegate.IsValid())
+	{
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().Remove(AssetEditorCloseDelegate);
+	}
+}
+
+TSharedPtr<SWindow> SCurveDiff::CreateDiffWindow(FText WindowTitle, const UObject* OldAsset, const UObject* NewAsset, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	TSharedPtr<SWindow> Window = SNew(SWindow)
+		.Title(WindowTitle)
+		.ClientSize(FVector2D(1000, 600));
+
+	Window->SetContent(SNew(SCurveDiff)
+		.AssetOld(OldAsset)
+		.AssetNew(NewAsset)
+		.OldRevision(OldRevision)
+		.NewRevision(NewRevision)
+		.ParentWindow(Window));
+
+	// Make this window a child of the modal window if we've been spawned while one is active.
+	TSharedPtr<SWindow> ActiveModal = FSlateApplication::Get().GetActiveModalWindow();
+	if (ActiveModal.IsValid())
+	{
+		FSlateApplication::Get().AddWindowAsNativeChild(Window.ToSharedRef(), ActiveModal.ToSharedRef());
+	}
+	else
+	{
+		FSlateApplication::Get().AddWindow(Window.ToSharedRef());
+	}
+
+	return Window;
+}
+
+void SCurveDiff::SelectCurve(const FString& Path)
+{
+	if (const TSharedPtr<FCurveDiffEntry>* Found = Entries.FindByPredicate([&Path](const TSharedPtr<FCurveDiffEntry>& Entry) { return Entry->Path == Path; }))
+	{
+		CurveListView->SetSelection(*Found);
+		CurveListView->RequestScrollIntoView(*Found);
+	}
+}
+
+TSharedRef<ITableRow> SCurveDiff::OnGenerateRow(TSharedPtr<FCurveDiffEntry> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SCurveDiffRow, OwnerTable)
+		.Item(Item);
+}
+
+void SCurveDiff::OnSelectionChanged(TSharedPtr<FCurveDiffEntry> Item, ESelectInfo::Type SelectInfo)
+{
+	Plot->SetEntry(Item);
+}
+
+void SCurveDiff::OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason CloseReason)
+{
+	if (AssetOld == Asset || AssetNew == Asset || CloseReason == EAssetEditorCloseReason::CloseAllAssetEditors)
+	{
+		// Tell our window to close and set our selves to collapsed to try and stop it from ticking
+		SetVisibility(EVisibility::Collapsed);
+
+		if (AssetEditorCloseDelegate.IsValid())
+		{
+			GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().Remove(AssetEditorCloseDelegate);
+		}
+
+		if (WeakParentWindow.IsValid())
+		{
+			WeakParentWindow.Pin()->RequestDestroyWindow();
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -1,10 +1,29 @@
 
 #include "DataAssetDiff.h"
+#include "AssetHistoryMemory.h"
 #include "DetailsDiff.h"
+#include "CurveDiff.h"
+#include "StructArrayDiff.h"
+#include "DiffExport.h"
+#include "DeepDiff.h"
+#include "PropertyDiff.h"
+#include "AssetHistorySettings.h"
+#include "RevisionBisect.h"
+#include "Async/Async.h"
+#include "UObject/GCObject.h"
+#include "DesktopPlatformModule.h"
+#include "IDesktopPlatform.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
 #include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Notifications/SProgressBar.h"
+#include "Widgets/Input/SButton.h"
 
 #define LOCTEXT_NAMESPACE "SBlueprintDif"
 const FName DefaultsMode = FName(TEXT("DefaultsMode"));
+const FName CurvesMode = FName(TEXT("CurvesMode"));
+const FName SubObjectsMode = FName(TEXT("SubObjectsMode"));
+const FName StructArraysMode = FName(TEXT("StructArraysMode"));
 FText RightRevision = LOCTEXT("OlderRevisionIdentifier", "Right Revision");
 
 class IDiffControl
@@ -12,29 +31,109 @@ class IDiffControl
 public:
 	virtual ~IDiffControl() {}
 
-	/** Adds widgets to the tree of differences to show */
-	virtual void GenerateTreeEntries(TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutTreeEntries, TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutRealDifferences) = 0;
+	/** Adds the differences to show in the tree */
+	virtual void GenerateTreeItems(TArray<FDifferenceTreeItem>& OutItems) = 0;
 };
 
-static TSharedRef<SWidget> GenerateObjectDiffWidget(FSingleObjectDiffEntry DiffEntry, FText ObjectName)
+/** Tree item of a property difference, grouped under Prefix then the property path */
+static FDifferenceTreeItem MakePropertyTreeItem(TArray<FString> Prefix, const FSingleObjectDiffEntry& DiffEntry, FOnDiffEntryFocused OnFocused)
 {
-	return SNew(STextBlock)
-		.Text(DiffViewUtils::PropertyDiffMessage(DiffEntry, ObjectName))
-		.ToolTipText(DiffViewUtils::PropertyDiffMessage(DiffEntry, ObjectName))
-		.ColorAndOpacity(DiffViewUtils::Differs());
+	TArray<FString> PathSegments;
+	DiffEntry.Identifier.ToDisplayName().ParseIntoArray(PathSegments, TEXT(" "));
+
+	FDifferenceTreeItem Item;
+	Item.Segments = MoveTemp(Prefix);
+	Item.Segments.Append(MoveTemp(PathSegments));
+	Item.Label = DiffViewUtils::PropertyDiffMessage(DiffEntry, RightRevision);
+	Item.OnFocused = MoveTemp(OnFocused);
+	// "Items[2] Name" is Items[2].Name in the tagged trees
+	Item.PropertyPath = DiffEntry.Identifier.ToDisplayName().Replace(TEXT(" "), TEXT("."));
+	return Item;
 }
 
-/** Generic wrapper around a details view, this does not actually fill out OutTreeEntries */
+/**
+ * Compares the assets and what's below them on a worker, the panels are built from its results on the game thread.
+ * A live asset is compared through a copy, see PropertyDiff::MakeWorkerCopy. Keeps both objects referenced instead of
+ * blocking garbage collection for as long as the diff runs. Created and released on the game thread.
+ */
+class FDataAssetDiffTask : public TSharedFromThis<FDataAssetDiffTask, ESPMode::ThreadSafe>, public FGCObject
+{
+public:
+	FDataAssetDiffTask(const UObject* InOldObject, const UObject* InNewObject, TSharedPtr<FDeepObjectDiff> InDeepDiff)
+		: OldObject(PropertyDiff::MakeWorkerCopy(InOldObject))
+		, NewObject(PropertyDiff::MakeWorkerCopy(InNewObject))
+		, DeepDiff(InDeepDiff)
+		, ReferencedOldObject(const_cast<UObject*>(OldObject))
+		, ReferencedNewObject(const_cast<UObject*>(NewObject))
+	{
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		Collector.AddReferencedObject(ReferencedOldObject);
+		Collector.AddReferencedObject(ReferencedNewObject);
+		// Only cleared for an object destroyed anyway, a forced delete: the worker stops at its next check
+		if (!ReferencedOldObject || !ReferencedNewObject)
+		{
+			Progress.bCancelled = true;
+		}
+	}
+
+	virtual FString GetReferencerName() const override { return TEXT("FDataAssetDiffTask"); }
+
+	void Start()
+	{
+		TSharedRef<FDataAssetDiffTask, ESPMode::ThreadSafe> This = AsShared();
+		Async(EAsyncExecution::ThreadPool, [This]() mutable
+			{
+				LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+				if (!This->Progress.bCancelled)
+				{
+					PropertyDiff::CompareObjects(This->OldObject, This->NewObject, This->Differences, &This->Progress);
+				}
+				const int32 MinElements = GetDefault<UAssetHistorySettings>()->StructArrayTableMinElements;
+				if (MinElements > 0 && !This->Progress.bCancelled)
+				{
+					StructArrayDiff::DiffArrays(This->OldObject, This->NewObject, MinElements, This->StructArrays, &This->Progress);
+				}
+				if (This->DeepDiff.IsValid() && !This->Progress.bCancelled)
+				{
+					This->DeepDiff->Diff(This->OldObject, This->NewObject);
+				}
+				This->bDone = true;
+
+				// The window may be gone already, the task and the deep diff are GC objects and are released on the game thread
+				AsyncTask(ENamedThreads::GameThread, [This = MoveTemp(This)]() {});
+			});
+	}
+
+	const UObject* OldObject;
+	const UObject* NewObject;
+
+	/** Only read once done */
+	TArray<FSingleObjectDiffEntry> Differences;
+	/** Large struct arrays shown as tables, their differences stay out of the details panels */
+	TArray<TSharedPtr<FStructArrayDiff>> StructArrays;
+	TSharedPtr<FDeepObjectDiff> DeepDiff;
+
+	FDiffProgress Progress;
+	TAtomic<bool> bDone { false };
+
+private:
+	TObjectPtr<UObject> ReferencedOldObject;
+	TObjectPtr<UObject> ReferencedNewObject;
+};
+
+/** Generic wrapper around a details view, only the panels with a Category add tree items */
 class FDetailsDiffControl : public TSharedFromThis<FDetailsDiffControl>, public IDiffControl
 {
 public:
-	FDetailsDiffControl(const UObject* InOldObject, const UObject* InNewObject, FOnDiffEntryFocused InSelectionCallback)
+	FDetailsDiffControl(const UObject* InOldObject, const UObject* InNewObject, TArray<FSingleObjectDiffEntry> InDifferingProperties, FOnDiffEntryFocused InSelectionCallback)
 		: SelectionCallback(InSelectionCallback)
 		, OldDetails(InOldObject, FDetailsDiff::FOnDisplayedPropertiesChanged())
 		, NewDetails(InNewObject, FDetailsDiff::FOnDisplayedPropertiesChanged())
+		, DifferingProperties(MoveTemp(InDifferingProperties))
 	{
-		OldDetails.DiffAgainst(NewDetails, DifferingProperties, true);
-
 		TSet<FPropertyPath> PropertyPaths;
 		Algo::Transform(DifferingProperties, PropertyPaths,
 			[&InOldObject](const FSingleObjectDiffEntry& DiffEntry)
@@ -54,18 +153,29 @@ public:
 		NewDetails.DetailsWidget()->UpdatePropertyAllowList(PropertyPaths);
 	}
 
-	virtual void GenerateTreeEntries(TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutTreeEntries, TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutRealDifferences) override
+	virtual void GenerateTreeItems(TArray<FDifferenceTreeItem>& OutItems) override
 	{
+		if (Category.IsEmpty())
+		{
+			return;
+		}
+
+		OutItems.Reserve(OutItems.Num() + DifferingProperties.Num());
 		for (const FSingleObjectDiffEntry& Difference : DifferingProperties)
 		{
-			TSharedPtr<FBlueprintDifferenceTreeEntry> Entry = MakeShared<FBlueprintDifferenceTreeEntry>(
-				FOnDiffEntryFocused::CreateSP(AsShared(), &FDetailsDiffControl::OnSelectDiffEntry, Difference.Identifier),
-				FGenerateDiffEntryWidget::CreateStatic(&GenerateObjectDiffWidget, Difference, RightRevision));
-			Children.Push(Entry);
-			OutRealDifferences.Push(Entry);
+			OutItems.Add(MakePropertyTreeItem({ Category }, Difference,
+				FOnDiffEntryFocused::CreateSP(AsShared(), &FDetailsDiffControl::OnSelectDiffEntry, Difference.Identifier)));
 		}
 	}
 
+	const TArray<FSingleObjectDiffEntry>& GetDifferingProperties() const { return DifferingProperties; }
+
+	void HighlightProperty(const FPropertySoftPath& PropertyName)
+	{
+		OldDetails.HighlightProperty(PropertyName);
+		NewDetails.HighlightProperty(PropertyName);
+	}
+
 	TSharedRef<SWidget> OldDetailsWidget() { return OldDetails.DetailsWidget(); }
 	TSharedRef<SWidget> NewDetailsWidget() { return NewDetails.DetailsWidget(); }
 
@@ -82,7 +192,9 @@ protected:
 	FDetailsDiff NewDetails;
 
 	TArray<FSingleObjectDiffEntry> DifferingProperties;
-	TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> > Children;
+
+	/** First segment of the tree items */
+	FString Category;
 };
 
 
@@ -90,37 +202,22 @@ protected:
 class FCDODiffControl : public FDetailsDiffControl
 {
 public:
-	FCDODiffControl(const UObject* InOldObject, const UObject* InNewObject, FOnDiffEntryFocused InSelectionCallback)
-		: FDetailsDiffControl(InOldObject, InNewObject, InSelectionCallback)
+	FCDODiffControl(const UObject* InOldObject, const UObject* InNewObject, TArray<FSingleObjectDiffEntry> InDifferingProperties, FOnDiffEntryFocused InSelectionCallback)
+		: FDetailsDiffControl(InOldObject, InNewObject, MoveTemp(InDifferingProperties), InSelectionCallback)
 	{
-	}
-
-	virtual void GenerateTreeEntries(TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutTreeEntries, TArray< TSharedPtr<FBlueprintDifferenceTreeEntry> >& OutRealDifferences) override
-	{
-		FDetailsDiffControl::GenerateTreeEntries(OutTreeEntries, OutRealDifferences);
-
-		const bool bHasDifferences = Children.Num() != 0;
-		if (!bHasDifferences)
-		{
-			// make one child informing the user that there are no differences:
-			Children.Push(FBlueprintDifferenceTreeEntry::NoDifferencesEntry());
-		}
-
-		OutTreeEntries.Push(FBlueprintDifferenceTreeEntry::CreateCategoryEntry(
-			NSLOCTEXT("FBlueprintDifferenceTreeEntry", "DefaultsLabel", "Defaults"),
-			NSLOCTEXT("FBlueprintDifferenceTreeEntry", "DefaultsTooltip", "The list of changes made in the Defaults panel"),
-			SelectionCallback,
-			Children,
-			bHasDifferences
-		));
+		Category = NSLOCTEXT("FBlueprintDifferenceTreeEntry", "DefaultsLabel", "Defaults").ToString();
 	}
 };
 
 void SDataAssetDiff::Construct( const FArguments& InArgs)
 {
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataAssetDiff, 1);
+
 	check(InArgs._AssetOld && InArgs._AssetNew);
 	AssetNew = InArgs._AssetNew;
 	AssetOld = InArgs._AssetOld;
+	OldRevision = InArgs._OldRevision;
+	NewRevision = InArgs._NewRevision;
 	bLockViews = true;
 
 	if (InArgs._ParentWindow.IsValid())
@@ -151,6 +248,16 @@ void SDataAssetDiff::Construct( const FArguments& InArgs)
 		, LOCTEXT("NextDiffTooltip", "Go to next difference")
 		, FSlateIcon(FEditorStyle::GetStyleSetName(), "BlueprintDif.NextDiff")
 	);
+	NavToolBarBuilder.AddToolBarButton(
+		FUIAction(
+			FExecuteAction::CreateSP(this, &SDataAssetDiff::ExportDifferences),
+			FCanExecuteAction::CreateSP(this, &SDataAssetDiff::IsDiffComplete)
+		)
+		, NAME_None
+		, LOCTEXT("ExportDiffLabel", "Export")
+		, LOCTEXT("ExportDiffTooltip", "Save the differences as CSV, JSON or Markdown")
+		, FSlateIcon(FEditorStyle::GetStyleSetName(), "Icons.Save")
+	);
 
 	FToolBarBuilder GraphToolbarBuilder(TSharedPtr< const FUICommandList >(), FMultiBoxCustomization::None);
 	GraphToolbarBuilder.AddToolBarButton(
@@ -168,9 +275,8 @@ void SDataAssetDiff::Construct( const FArguments& InArgs)
 		, TAttribute<FSlateIcon>(this, &SDataAssetDiff::GetSplitViewModeImage)
 	);
 
-	DifferencesTreeView = DiffTreeView::CreateTreeView(&MasterDifferencesList);
-
-	GenerateDifferencesList();
+	SAssignNew(DifferenceTree, SDifferenceTree)
+		.OnContextMenuOpening(this, &SDataAssetDiff::OnDifferenceContextMenu);
 
 	const auto TextBlock = [](FText Text) -> TSharedRef<SWidget>
 	{
@@ -259,7 +365,7 @@ void SDataAssetDiff::Construct( const FArguments& InArgs)
 			SNew(SBorder)
 			.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
 		[
-			DifferencesTreeView.ToSharedRef()
+			DifferenceTree.ToSharedRef()
 		]
 		]
 	+ SSplitter::Slot()
@@ -272,12 +378,14 @@ void SDataAssetDiff::Construct( const FArguments& InArgs)
 		]
 		];
 
-	SetCurrentMode(DefaultsMode);
-
+	StartDiff();
 }
 
 SDataAssetDiff::~SDataAssetDiff()
 {
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataAssetDiff, -1);
+
+	CancelDiff();
 	if (AssetEditorCloseDelegate.IsValid())
 	{
 		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().Remove(AssetEditorCloseDelegate);
@@ -288,6 +396,8 @@ void SDataAssetDiff::OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason
 {
 	if (AssetOld == Asset || AssetNew == Asset || CloseReason == EAssetEditorCloseReason::CloseAllAssetEditors)
 	{
+		CancelDiff();
+
 		// Tell our window to close and set our selves to collapsed to try and stop it from ticking
 		SetVisibility(EVisibility::Collapsed);
 
@@ -303,6 +413,170 @@ void SDataAssetDiff::OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason
 	}
 }
 
+void SDataAssetDiff::StartDiff()
+{
+	// Created here, a GC object registers on the game thread
+	const UAssetHistorySettings* Settings = GetDefault<UAssetHistorySettings>();
+	TSharedRef<FDataAssetDiffTask, ESPMode::ThreadSafe> Task = MakeShared<FDataAssetDiffTask, ESPMode::ThreadSafe>(AssetOld, AssetNew, nullptr);
+	if (Settings->bDiffInstancedSubObjects || Settings->bDiffReferencedDataAssets)
+	{
+		FDeepObjectDiff::FOptions Options;
+		Options.bFollowInstancedSubObjects = Settings->bDiffInstancedSubObjects;
+		Options.bFollowReferencedDataAssets = Settings->bDiffReferencedDataAssets;
+		Options.MaxDepth = Settings->DeepDiffMaxDepth;
+		Options.OldRevision = OldRevision;
+		Options.NewRevision = NewRevision;
+		Options.Progress = &Task->Progress;
+		Task->DeepDiff = MakeShared<FDeepObjectDiff>(Options);
+	}
+	DiffTask = Task;
+
+	ModeContents->SetContent(
+		SNew(SBox)
+		.HAlign(HAlign_Center)
+		.VAlign(VAlign_Center)
+		.WidthOverride(400.0f)
+		[
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(0.0f, 0.0f, 0.0f, 4.0f)
+			[
+				SNew(STextBlock)
+				.Text(this, &SDataAssetDiff::GetDiffProgressText)
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(0.0f, 0.0f, 0.0f, 4.0f)
+			[
+				// Nothing tells how many properties are left, the bar only shows the diff is alive
+				SNew(SProgressBar)
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.HAlign(HAlign_Right)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("CancelDiff", "Cancel"))
+				.IsEnabled_Lambda([this]() { return DiffTask.IsValid() && !DiffTask->Progress.bCancelled; })
+				.OnClicked_Lambda([this]() { CancelDiff(); return FReply::Handled(); })
+			]
+		]);
+
+	Task->Start();
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SDataAssetDiff::PollDiff));
+}
+
+void SDataAssetDiff::CancelDiff()
+{
+	if (DiffTask.IsValid())
+	{
+		DiffTask->Progress.bCancelled = true;
+	}
+}
+
+bool SDataAssetDiff::IsDiffComplete() const
+{
+	return DiffTask.IsValid() && DiffTask->bDone && !DiffTask->Progress.bCancelled;
+}
+
+FText SDataAssetDiff::GetDiffProgressText() const
+{
+	if (!DiffTask.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+
+	const FText Counts = FText::Format(LOCTEXT("DiffProgressCounts", "{0} properties visited, {1} differences found"),
+		FText::AsNumber(DiffTask->Progress.PropertiesVisited.Load()), FText::AsNumber(DiffTask->Progress.DifferencesFound.Load()));
+	if (DiffTask->Progress.bCancelled)
+	{
+		return FText::Format(LOCTEXT("DiffCancelled", "Cancelled after {0}"), Counts);
+	}
+	return FText::Format(LOCTEXT("DiffRunning", "Comparing: {0}"), Counts);
+}
+
+EActiveTimerReturnType SDataAssetDiff::PollDiff(double InCurrentTime, float InDeltaTime)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	if (!DiffTask->bDone)
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	if (!DiffTask->Progress.bCancelled)
+	{
+		GenerateDifferencesList();
+		SetCurrentMode(DefaultsMode);
+	}
+	return EActiveTimerReturnType::Stop;
+}
+
+void SDataAssetDiff::ExportDifferences()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (!DesktopPlatform)
+	{
+		return;
+	}
+
+	const FString AssetName = AssetNew->GetName();
+	TArray<FString> Filenames;
+	if (!DesktopPlatform->SaveFileDialog(FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+		LOCTEXT("ExportDiffTitle", "Export Differences").ToString(), FPaths::ProjectSavedDir(), AssetName + TEXT("_Diff.csv"),
+		FDiffExportWriter::GetFileTypes(), EFileDialogFlags::None, Filenames) || Filenames.Num() == 0)
+	{
+		return;
+	}
+
+	EDiffExportFormat Format = EDiffExportFormat::Csv;
+	FDiffExportWriter::FormatFromFilename(Filenames[0], Format);
+	TUniquePtr<FDiffExportWriter> Writer = FDiffExportWriter::Create(Filenames[0], Format);
+	bool bSuccess = Writer.IsValid();
+	if (bSuccess)
+	{
+		FDiffExportEntry Common;
+		Common.AssetName = AssetName;
+		Common.OldRevision = OldRevision.Revision;
+		Common.NewRevision = NewRevision.Revision;
+		Common.Author = DiffExport::FindRevisionAuthor(AssetName, NewRevision.Revision);
+
+		if (DefaultsDiffControl.IsValid())
+		{
+			// Every difference, the ones shown in the struct array tables too
+			DiffExport::WriteObjectDifferences(*Writer, AssetOld, AssetNew, DiffTask->Differences, Common);
+		}
+		if (DeepDiff.IsValid())
+		{
+			for (const FDeepDiffPair& Pair : DeepDiff->GetPairs())
+			{
+				FDiffExportEntry PairCommon = Common;
+				PairCommon.AssetName = AssetName + TEXT(" / ") + Pair.Path;
+				DiffExport::WriteObjectDifferences(*Writer, Pair.OldObject, Pair.NewObject, Pair.Differences, PairCommon);
+			}
+		}
+		if (CurveDiffWidget.IsValid())
+		{
+			FDiffExportEntry Entry = Common;
+			for (const TSharedPtr<FCurveDiffEntry>& CurveEntry : CurveDiffWidget->GetEntries())
+			{
+				Entry.PropertyPath = CurveEntry->Path;
+				Entry.OldValue = FString::Printf(TEXT("%d keys"), CurveEntry->Stats.NumKeysOld);
+				Entry.NewValue = FString::Printf(TEXT("%d keys, max deviation %g"), CurveEntry->Stats.NumKeysNew, CurveEntry->Stats.MaxDeviation);
+				Writer->Write(Entry);
+			}
+		}
+		bSuccess = Writer->Close();
+	}
+
+	FNotificationInfo Info(bSuccess
+		? FText::Format(LOCTEXT("ExportDiffDone", "Exported {0} differences to {1}"), FText::AsNumber(Writer->GetNumEntries()), FText::FromString(Filenames[0]))
+		: FText::Format(LOCTEXT("ExportDiffFailed", "Failed to write {0}"), FText::FromString(Filenames[0])));
+	Info.ExpireDuration = 4.0f;
+	FSlateNotificationManager::Get().AddNotification(Info);
+}
+
 TSharedRef<SWidget> SDataAssetDiff::DefaultEmptyPanel()
 {
 	return SNew(SHorizontalBox)
@@ -317,6 +591,8 @@ TSharedRef<SWidget> SDataAssetDiff::DefaultEmptyPanel()
 
 TSharedPtr<SWindow> SDataAssetDiff::CreateDiffWindow(FText WindowTitle, UPrimaryDataAsset*OldBlueprint, UPrimaryDataAsset* NewBlueprint, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision)
 {
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
 	// sometimes we're comparing different revisions of one single asset (other 
 	// times we're comparing two completely separate assets altogether)
 	bool bIsSingleAsset = (NewBlueprint->GetName() == OldBlueprint->GetName());
@@ -349,22 +625,22 @@ TSharedPtr<SWindow> SDataAssetDiff::CreateDiffWindow(FText WindowTitle, UPrimary
 
 void SDataAssetDiff::NextDiff()
 {
-	DiffTreeView::HighlightNextDifference(DifferencesTreeView.ToSharedRef(), RealDifferences, MasterDifferencesList);
+	DifferenceTree->SelectNext();
 }
 
 void SDataAssetDiff::PrevDiff()
 {
-	DiffTreeView::HighlightPrevDifference(DifferencesTreeView.ToSharedRef(), RealDifferences, MasterDifferencesList);
+	DifferenceTree->SelectPrev();
 }
 
 bool SDataAssetDiff::HasNextDiff() const
 {
-	return DiffTreeView::HasNextDifference(DifferencesTreeView.ToSharedRef(), RealDifferences);
+	return DifferenceTree->HasNext();
 }
 
 bool SDataAssetDiff::HasPrevDiff() const
 {
-	return DiffTreeView::HasPrevDifference(DifferencesTreeView.ToSharedRef(), RealDifferences);
+	return DifferenceTree->HasPrev();
 }
 
 
@@ -395,13 +671,27 @@ FSlateIcon SDataAssetDiff::GetSplitViewModeImage() const
 
 void SDataAssetDiff::GenerateDifferencesList()
 {
-	MasterDifferencesList.Empty();
-	RealDifferences.Empty();
+	TreeItems.Reset();
 	ModePanels.Empty();
 
 	// Now that we have done the diffs, create the panel widgets
 	ModePanels.Add(DefaultsMode, GenerateDefaultsPanel());
-	DifferencesTreeView->RebuildList();
+	FDiffControl CurvesPanel = GenerateCurvesPanel();
+	if (CurvesPanel.Widget.IsValid())
+	{
+		ModePanels.Add(CurvesMode, CurvesPanel);
+	}
+	FDiffControl StructArraysPanel = GenerateStructArraysPanel();
+	if (StructArraysPanel.Widget.IsValid())
+	{
+		ModePanels.Add(StructArraysMode, StructArraysPanel);
+	}
+	FDiffControl SubObjectsPanel = GenerateSubObjectsPanel();
+	if (SubObjectsPanel.Widget.IsValid())
+	{
+		ModePanels.Add(SubObjectsMode, SubObjectsPanel);
+	}
+	DifferenceTree->SetItems(MoveTemp(TreeItems));
 }
 
 SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateDefaultsPanel()
@@ -409,8 +699,35 @@ SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateDefaultsPanel()
 	const UObject* A = AssetOld;
 	const UObject* B = AssetNew;
 
-	TSharedPtr<FCDODiffControl> NewDiffControl = MakeShared<FCDODiffControl>(A, B, FOnDiffEntryFocused::CreateRaw(this, &SDataAssetDiff::SetCurrentMode, DefaultsMode));
-	NewDiffControl->GenerateTreeEntries(MasterDifferencesList, RealDifferences);
+	// Expanding a large struct array is what makes the details panels slow, those go to the table instead
+	TArray<FSingleObjectDiffEntry> Differences = DiffTask->Differences;
+	if (DiffTask->StructArrays.Num() > 0)
+	{
+		TSet<FString> TableArrays;
+		for (const TSharedPtr<FStructArrayDiff>& Array : DiffTask->StructArrays)
+		{
+			TableArrays.Add(Array->Property->GetName());
+		}
+		Differences.RemoveAll([&TableArrays](const FSingleObjectDiffEntry& Difference)
+			{
+				// "Items[2] Name" belongs to Items
+				const FString DisplayName = Difference.Identifier.ToDisplayName();
+				int32 RootEnd = DisplayName.Len();
+				for (int32 Index = 0; Index < DisplayName.Len(); ++Index)
+				{
+					if (DisplayName[Index] == TEXT('[') || DisplayName[Index] == TEXT(' '))
+					{
+						RootEnd = Index;
+						break;
+					}
+				}
+				return TableArrays.Contains(DisplayName.Left(RootEnd));
+			});
+	}
+
+	TSharedPtr<FCDODiffControl> NewDiffControl = MakeShared<FCDODiffControl>(A, B, MoveTemp(Differences), FOnDiffEntryFocused::CreateRaw(this, &SDataAssetDiff::SetCurrentMode, DefaultsMode));
+	NewDiffControl->GenerateTreeItems(TreeItems);
+	DefaultsDiffControl = NewDiffControl;
 
 	SDataAssetDiff::FDiffControl Ret;
 	Ret.DiffControl = NewDiffControl;
@@ -430,6 +747,235 @@ SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateDefaultsPanel()
 	return Ret;
 }
 
+SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateCurvesPanel()
+{
+	SAssignNew(CurveDiffWidget, SCurveDiff)
+		.AssetOld(AssetOld)
+		.AssetNew(AssetNew);
+
+	SDataAssetDiff::FDiffControl Ret;
+	if (CurveDiffWidget->GetEntries().Num() == 0)
+	{
+		CurveDiffWidget.Reset();
+		return Ret;
+	}
+
+	const FString Category = LOCTEXT("CurvesLabel", "Curves").ToString();
+	for (const TSharedPtr<FCurveDiffEntry>& Entry : CurveDiffWidget->GetEntries())
+	{
+		FDifferenceTreeItem& Item = TreeItems.AddDefaulted_GetRef();
+		Item.Segments.Add(Category);
+		TArray<FString> PathSegments;
+		Entry->Path.ParseIntoArray(PathSegments, TEXT("."));
+		Item.Segments.Append(MoveTemp(PathSegments));
+		Item.Label = FText::Format(LOCTEXT("CurveDiffEntry", "{0} (max deviation {1})"), FText::FromString(Entry->Path), FText::AsNumber(Entry->Stats.MaxDeviation));
+		Item.OnFocused = FOnDiffEntryFocused::CreateSP(this, &SDataAssetDiff::OnCurveEntryFocused, Entry->Path);
+	}
+
+	Ret.Widget = CurveDiffWidget;
+	return Ret;
+}
+
+void SDataAssetDiff::OnCurveEntryFocused(FString CurvePath)
+{
+	SetCurrentMode(CurvesMode);
+	if (CurveDiffWidget.IsValid())
+	{
+		CurveDiffWidget->SelectCurve(CurvePath);
+	}
+}
+
+SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateStructArraysPanel()
+{
+	SDataAssetDiff::FDiffControl Ret;
+	StructArrayDiffWidget.Reset();
+	if (DiffTask->StructArrays.Num() == 0)
+	{
+		return Ret;
+	}
+
+	SAssignNew(StructArrayDiffWidget, SStructArrayDiff)
+		.Arrays(DiffTask->StructArrays);
+
+	const FString Category = NSLOCTEXT("FBlueprintDifferenceTreeEntry", "DefaultsLabel", "Defaults").ToString();
+	const TArray<TSharedPtr<FStructArrayDiff>>& Arrays = StructArrayDiffWidget->GetArrays();
+	for (int32 ArrayIndex = 0; ArrayIndex < Arrays.Num(); ++ArrayIndex)
+	{
+		const FStructArrayDiff& Array = *Arrays[ArrayIndex];
+		const FString ArrayName = Array.Property->GetName();
+		for (const TSharedPtr<FStructArrayRowDiff>& Row : Array.Rows)
+		{
+			if (Row->DiffType == EStructArrayRowDiffType::Unchanged)
+			{
+				continue;
+			}
+
+			const int32 Index = Row->NewIndex != INDEX_NONE ? Row->NewIndex : Row->OldIndex;
+			const FString ElementName = FString::Printf(TEXT("%s[%d]"), *ArrayName, Index);
+			FDifferenceTreeItem& Item = TreeItems.AddDefaulted_GetRef();
+			Item.Segments = { Category, ArrayName, FString::Printf(TEXT("[%d]"), Index) };
+			Item.OnFocused = FOnDiffEntryFocused::CreateSP(this, &SDataAssetDiff::OnStructArrayRowFocused, ArrayIndex, Row);
+
+			if (Row->DiffType == EStructArrayRowDiffType::Modified)
+			{
+				TArray<FString> FieldNames;
+				for (TConstSetBitIterator<> It(Row->ChangedFields); It; ++It)
+				{
+					FieldNames.Add(Array.Fields[It.GetIndex()]->GetName());
+				}
+				Item.Label = FText::Format(LOCTEXT("StructArrayRowModified", "{0} changed: {1}"), FText::FromString(ElementName), FText::FromString(FString::Join(FieldNames, TEXT(", "))));
+				// The tagged trees have leaves, the first changed field stands for the row
+				Item.PropertyPath = ElementName + TEXT(".") + FieldNames[0];
+			}
+			else
+			{
+				Item.Label = FText::Format(Row->DiffType == EStructArrayRowDiffType::Added ? LOCTEXT("StructArrayRowAdded", "{0} added") : LOCTEXT("StructArrayRowRemoved", "{0} removed"),
+					FText::FromString(ElementName));
+			}
+		}
+	}
+
+	Ret.Widget = StructArrayDiffWidget;
+	return Ret;
+}
+
+void SDataAssetDiff::OnStructArrayRowFocused(int32 ArrayIndex, TSharedPtr<FStructArrayRowDiff> Row)
+{
+	SetCurrentMode(StructArraysMode);
+	if (StructArrayDiffWidget.IsValid())
+	{
+		StructArrayDiffWidget->SelectRow(ArrayIndex, Row);
+	}
+}
+
+SDataAssetDiff::FDiffControl SDataAssetDiff::GenerateSubObjectsPanel()
+{
+	SDataAssetDiff::FDiffControl Ret;
+	DeepDiff = DiffTask->DeepDiff;
+	SubObjectDiffControls.Reset();
+	if (!DeepDiff.IsValid())
+	{
+		return Ret;
+	}
+
+	const TArray<FDeepDiffPair>& Pairs = DeepDiff->GetPairs();
+	if (Pairs.Num() == 0)
+	{
+		DeepDiff.Reset();
+		return Ret;
+	}
+
+	const FString Category = LOCTEXT("SubObjectsLabel", "Sub-objects").ToString();
+	for (int32 PairIndex = 0; PairIndex < Pairs.Num(); ++PairIndex)
+	{
+		const FDeepDiffPair& Pair = Pairs[PairIndex];
+		TArray<FString> Prefix = { Category };
+		TArray<FString> PathSegments;
+		Pair.Path.ParseIntoArray(PathSegments, TEXT("."));
+		Prefix.Append(MoveTemp(PathSegments));
+
+		if (Pair.bHistoryNotFetched)
+		{
+			FDifferenceTreeItem& Item = TreeItems.AddDefaulted_GetRef();
+			Item.Segments = Prefix;
+			Item.Label = FText::Format(LOCTEXT("ReferencedAssetNotFetched", "{0} not compared: history not fetched"), FText::FromString(Pair.Path));
+			Item.OnFocused = FOnDiffEntryFocused::CreateSP(this, &SDataAssetDiff::OnSubObjectEntryFocused, PairIndex, FPropertySoftPath());
+		}
+		else if (!Pair.OldObject || !Pair.NewObject)
+		{
+			FDifferenceTreeItem& Item = TreeItems.AddDefaulted_GetRef();
+			Item.Segments = Prefix;
+			Item.Label = FText::Format(Pair.NewObject ? LOCTEXT("SubObjectAdded", "{0} added") : LOCTEXT("SubObjectRemoved", "{0} removed"), FText::FromString(Pair.Path));
+			Item.OnFocused = FOnDiffEntryFocused::CreateSP(this, &SDataAssetDiff::OnSubObjectEntryFocused, PairIndex, FPropertySoftPath());
+		}
+		for (const FSingleObjectDiffEntry& Difference : Pair.Differences)
+		{
+			FDifferenceTreeItem& Item = TreeItems.Add_GetRef(MakePropertyTreeItem(Prefix, Difference,
+				FOnDiffEntryFocused::CreateSP(this, &SDataAssetDiff::OnSubObjectEntryFocused, PairIndex, Difference.Identifier)));
+			// Tagged trees prefix sub-object properties with the export name, referenced assets are other packages
+			Item.PropertyPath = Pair.bReferencedAsset ? FString() : Prefix.Last() + TEXT(":") + Item.PropertyPath;
+		}
+	}
+
+	Ret.Widget = SAssignNew(SubObjectContents, SBox);
+	return Ret;
+}
+
+TSharedPtr<SWidget> SDataAssetDiff::OnDifferenceContextMenu(const FDifferenceTreeItem& Item)
+{
+	if (Item.PropertyPath.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	FString PackageFilename = FRevisionBisect::FindPackageFilename(AssetNew, NewRevision.Revision);
+	if (PackageFilename.IsEmpty())
+	{
+		PackageFilename = FRevisionBisect::FindPackageFilename(AssetOld, OldRevision.Revision);
+	}
+
+	FMenuBuilder MenuBuilder(true, nullptr);
+	const UClass* AssetClass = AssetNew->GetClass();
+	const FString PropertyPath = Item.PropertyPath;
+	MenuBuilder.AddMenuEntry(LOCTEXT("BisectProperty", "Find When This Property Changed..."),
+		LOCTEXT("BisectPropertyTooltip", "Bisect the asset's history for the first revision where this property satisfies a condition"), FSlateIcon(),
+		FUIAction(FExecuteAction::CreateLambda([PackageFilename, AssetClass, PropertyPath]()
+			{
+				SRevisionBisect::CreateBisectWindow(PackageFilename, AssetClass, PropertyPath);
+			}),
+			FCanExecuteAction::CreateLambda([PackageFilename]() { return !PackageFilename.IsEmpty(); })));
+	return MenuBuilder.MakeWidget();
+}
+
+void SDataAssetDiff::OnSubObjectEntryFocused(int32 PairIndex, FPropertySoftPath Property)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	SetCurrentMode(SubObjectsMode);
+	if (!DeepDiff.IsValid() || !SubObjectContents.IsValid() || !DeepDiff->GetPairs().IsValidIndex(PairIndex))
+	{
+		return;
+	}
+
+	const FDeepDiffPair& Pair = DeepDiff->GetPairs()[PairIndex];
+	if (Pair.bHistoryNotFetched)
+	{
+		SubObjectContents->SetContent(SNew(STextBlock)
+			.Text(FText::Format(LOCTEXT("ReferencedAssetNotFetchedDetails", "{0} was not compared: its history has not been fetched yet. Open its History menu, or let the warm-up fetch it, then diff again"), FText::FromString(Pair.Path))));
+		return;
+	}
+	if (!Pair.OldObject || !Pair.NewObject)
+	{
+		SubObjectContents->SetContent(SNew(STextBlock)
+			.Text(FText::Format(Pair.NewObject ? LOCTEXT("SubObjectOnlyNew", "{0} only exists in the new revision") : LOCTEXT("SubObjectOnlyOld", "{0} only exists in the old revision"), FText::FromString(Pair.Path))));
+		return;
+	}
+
+	TSharedPtr<FDetailsDiffControl>& DiffControl = SubObjectDiffControls.FindOrAdd(PairIndex);
+	if (!DiffControl.IsValid())
+	{
+		DiffControl = MakeShared<FDetailsDiffControl>(Pair.OldObject, Pair.NewObject, Pair.Differences, FOnDiffEntryFocused());
+	}
+
+	SubObjectContents->SetContent(SNew(SSplitter)
+		.PhysicalSplitterHandleSize(10.0f)
+		+ SSplitter::Slot()
+		.Value(0.5f)
+		[
+			DiffControl->OldDetailsWidget()
+		]
+		+ SSplitter::Slot()
+		.Value(0.5f)
+		[
+			DiffControl->NewDetailsWidget()
+		]);
+
+	if (!(Property == FPropertySoftPath()))
+	{
+		DiffControl->HighlightProperty(Property);
+	}
+}
+
 TSharedRef<SBox> SDataAssetDiff::GenerateRevisionInfoWidgetForPanel(TSharedPtr<SWidget>& OutGeneratedWidget, const FText& InRevisionText) const
 {
 	return SAssignNew(OutGeneratedWidget,SBox)
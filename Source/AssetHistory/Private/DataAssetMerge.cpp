@@ -0,0 +1,698 @@
+
+#include "DataAssetMerge.h"
+#include "AssetHistoryMemory.h"
+#include "AssetHistorySettings.h"
+#include "SourceControlScheduler.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "ScopedTransaction.h"
+#include "FileHelpers.h"
+#include "Misc/MessageDialog.h"
+#include "UObject/Package.h"
+#include "Async/Async.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "Widgets/SNullWidget.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Views/STableRow.h"
+#include "EditorStyleSet.h"
+
+#define LOCTEXT_NAMESPACE "SDataAssetMerge"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDataAssetMerge, Log, All);
+
+namespace DataAssetMergeColumns
+{
+	static const FName Property(TEXT("Property"));
+	static const FName Change(TEXT("Change"));
+	static const FName Base(TEXT("Base"));
+	static const FName Local(TEXT("Local"));
+	static const FName Remote(TEXT("Remote"));
+	static const FName Use(TEXT("Use"));
+}
+
+namespace DataAssetMerge
+{
+	struct FClassifyContext
+	{
+		TArray<FMergeEntry>& OutEntries;
+		FDiffProgress* Progress;
+		double Tolerance;
+
+		bool IsCancelled() const
+		{
+			return Progress && Progress->bCancelled;
+		}
+
+		void Visit()
+		{
+			if (Progress)
+			{
+				++Progress->PropertiesVisited;
+			}
+		}
+
+		bool AreEqual(const FProperty* Property, const void* A, const void* B) const
+		{
+			return FPropertyComparators::Get().AreEqual(Property, A, B, Tolerance);
+		}
+
+		void Add(const FString& Path, const FProperty* Property, const void* Base, void* Local, const void* Remote, EMergeChange Change)
+		{
+			FMergeEntry& Entry = OutEntries.AddDefaulted_GetRef();
+			Entry.Path = Path;
+			Entry.Property = Property;
+			Entry.BaseValue = Base;
+			Entry.LocalValue = Local;
+			Entry.RemoteValue = Remote;
+			// A copied instanced reference would point into the remote package, those changes are merged by hand
+			Entry.bCanTakeRemote = !Property->ContainsInstancedObjectProperty();
+			Entry.Change = Change == EMergeChange::Remote && !Entry.bCanTakeRemote ? EMergeChange::Conflict : Change;
+			if (Progress && Entry.Change != EMergeChange::Local)
+			{
+				++Progress->DifferencesFound;
+			}
+		}
+	};
+
+	static void ClassifyStruct(const UStruct* Struct, const void* Base, void* Local, const void* Remote, const FString& Path, FClassifyContext& Context);
+
+	static void ClassifyValue(const FProperty* Property, const void* Base, void* Local, const void* Remote, const FString& Path, FClassifyContext& Context)
+	{
+		Context.Visit();
+		const bool bLocalChanged = !Context.AreEqual(Property, Base, Local);
+		const bool bRemoteChanged = !Context.AreEqual(Property, Base, Remote);
+		if (!bLocalChanged && !bRemoteChanged)
+		{
+			return;
+		}
+		if (bLocalChanged != bRemoteChanged)
+		{
+			Context.Add(Path, Property, Base, Local, Remote, bLocalChanged ? EMergeChange::Local : EMergeChange::Remote);
+			return;
+		}
+		if (Context.AreEqual(Property, Local, Remote))
+		{
+			Context.Add(Path, Property, Base, Local, Remote, EMergeChange::Both);
+			return;
+		}
+
+		// Both sides changed it differently, the members or elements they changed may still not overlap
+		const int32 NumBefore = Context.OutEntries.Num();
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			ClassifyStruct(StructProperty->Struct, Base, Local, Remote, Path, Context);
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			// Elements only line up when neither side added or removed any, a resized array is one value
+			FScriptArrayHelper BaseHelper(ArrayProperty, Base);
+			FScriptArrayHelper LocalHelper(ArrayProperty, Local);
+			FScriptArrayHelper RemoteHelper(ArrayProperty, Remote);
+			if (BaseHelper.Num() == LocalHelper.Num() && BaseHelper.Num() == RemoteHelper.Num())
+			{
+				for (int32 Index = 0; Index < BaseHelper.Num() && !Context.IsCancelled(); ++Index)
+				{
+					ClassifyValue(ArrayProperty->Inner, BaseHelper.GetRawPtr(Index), LocalHelper.GetRawPtr(Index), RemoteHelper.GetRawPtr(Index),
+						FString::Printf(TEXT("%s[%d]"), *Path, Index), Context);
+				}
+			}
+		}
+
+		// The split has to account for both sides, otherwise they differ in members the details don't show or in the array size, and conflict as a whole
+		bool bLocalFound = false;
+		bool bRemoteFound = false;
+		for (int32 Index = NumBefore; Index < Context.OutEntries.Num(); ++Index)
+		{
+			const EMergeChange Change = Context.OutEntries[Index].Change;
+			bLocalFound |= Change != EMergeChange::Remote;
+			bRemoteFound |= Change != EMergeChange::Local;
+		}
+		if (!(bLocalFound && bRemoteFound) && !Context.IsCancelled())
+		{
+			Context.OutEntries.SetNum(NumBefore);
+			Context.Add(Path, Property, Base, Local, Remote, EMergeChange::Conflict);
+		}
+	}
+
+	static void ClassifyStruct(const UStruct* Struct, const void* Base, void* Local, const void* Remote, const FString& Path, FClassifyContext& Context)
+	{
+		for (TFieldIterator<FProperty> It(Struct); It && !Context.IsCancelled(); ++It)
+		{
+			const FProperty* Property = *It;
+			if (!PropertyDiff::IsCompared(Property))
+			{
+				continue;
+			}
+
+			const FString PropertyPath = Path.IsEmpty() ? Property->GetName() : Path + TEXT(".") + Property->GetName();
+			for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+			{
+				ClassifyValue(Property, Property->ContainerPtrToValuePtr<void>(Base, Index), Property->ContainerPtrToValuePtr<void>(Local, Index), Property->ContainerPtrToValuePtr<void>(Remote, Index),
+					Property->ArrayDim > 1 ? FString::Printf(TEXT("%s[%d]"), *PropertyPath, Index) : PropertyPath, Context);
+			}
+		}
+	}
+
+	bool Classify(const UObject* Base, UObject* Local, const UObject* Remote, TArray<FMergeEntry>& OutEntries, FDiffProgress* Progress)
+	{
+		check(Base && Local && Remote);
+		check(Base->GetClass() == Local->GetClass() && Remote->GetClass() == Local->GetClass());
+
+		FClassifyContext Context{ OutEntries, Progress, GetDefault<UAssetHistorySettings>()->DiffTolerance };
+		ClassifyStruct(Local->GetClass(), Base, Local, Remote, FString(), Context);
+		return !Context.IsCancelled();
+	}
+
+	int32 Apply(UObject* Local, TArrayView<const FMergeEntry> Entries)
+	{
+		check(IsInGameThread());
+
+		const FScopedTransaction Transaction(LOCTEXT("MergeTransaction", "Merge Remote Changes"));
+		Local->Modify();
+
+		// Entries never nest, so no copy invalidates the value pointers of another
+		int32 NumApplied = 0;
+		for (const FMergeEntry& Entry : Entries)
+		{
+			const bool bTakeRemote = Entry.Change == EMergeChange::Remote || (Entry.Change == EMergeChange::Conflict && Entry.bTakeRemote && Entry.bCanTakeRemote);
+			if (bTakeRemote)
+			{
+				Entry.Property->CopySingleValue(Entry.LocalValue, Entry.RemoteValue);
+				++NumApplied;
+			}
+		}
+
+		if (NumApplied > 0)
+		{
+			Local->PostEditChange();
+			Local->MarkPackageDirty();
+		}
+		return NumApplied;
+	}
+
+	FString ExportValue(const FProperty* Property, const void* Value)
+	{
+		FString Text;
+		Property->ExportText_Direct(Text, Value, Value, nullptr, PPF_None);
+		return Text;
+	}
+}
+
+class FDataAssetMergeTask : public TSharedFromThis<FDataAssetMergeTask, ESPMode::ThreadSafe>
+{
+public:
+	FDataAssetMergeTask(const UObject* InBase, UObject* InLocal, const UObject* InRemote)
+		: Base(InBase)
+		, Local(InLocal)
+		, Remote(InRemote)
+	{
+	}
+
+	void Start()
+	{
+		TSharedRef<FDataAssetMergeTask, ESPMode::ThreadSafe> This = AsShared();
+		Async(EAsyncExecution::ThreadPool, [This]()
+			{
+				LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+				// The window keeps the three objects referenced and cancels before it lets go of them, garbage collection isn't blocked meanwhile
+				if (!This->Progress.bCancelled)
+				{
+					DataAssetMerge::Classify(This->Base, This->Local, This->Remote, This->Entries, &This->Progress);
+				}
+				This->bDone = true;
+			});
+	}
+
+	const UObject* Base;
+	UObject* Local;
+	const UObject* Remote;
+
+	/** Only read once done */
+	TArray<FMergeEntry> Entries;
+
+	FDiffProgress Progress;
+	TAtomic<bool> bDone { false };
+};
+
+class SMergeEntryRow : public SMultiColumnTableRow<TSharedPtr<FMergeEntry>>
+{
+public:
+	SLATE_BEGIN_ARGS(SMergeEntryRow){}
+		SLATE_ARGUMENT(TSharedPtr<FMergeEntry>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FMergeEntry>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		if (ColumnName == DataAssetMergeColumns::Use)
+		{
+			if (Item->Change != EMergeChange::Conflict)
+			{
+				return SNullWidget::NullWidget;
+			}
+
+			TSharedPtr<FMergeEntry> Entry = Item;
+			return SNew(SCheckBox)
+				.IsEnabled(Item->bCanTakeRemote)
+				.ToolTipText(Item->bCanTakeRemote ? LOCTEXT("TakeRemoteTooltip", "Checked takes the remote value, unchecked keeps the local one")
+					: LOCTEXT("CantTakeRemoteTooltip", "Instanced sub-objects can't be copied from the remote revision, merge this one by hand"))
+				.IsChecked_Lambda([Entry]() { return Entry->bTakeRemote ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+				.OnCheckStateChanged_Lambda([Entry](ECheckBoxState InState) { Entry->bTakeRemote = InState == ECheckBoxState::Checked; })
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UseRemote", "Remote"))
+				];
+		}
+
+		FText Text;
+		if (ColumnName == DataAssetMergeColumns::Property)
+		{
+			Text = FText::FromString(Item->Path);
+		}
+		else if (ColumnName == DataAssetMergeColumns::Change)
+		{
+			switch (Item->Change)
+			{
+			case EMergeChange::Local: Text = LOCTEXT("ChangeLocal", "Local"); break;
+			case EMergeChange::Remote: Text = LOCTEXT("ChangeRemote", "Remote"); break;
+			case EMergeChange::Both: Text = LOCTEXT("ChangeBoth", "Both, same"); break;
+			default: Text = LOCTEXT("ChangeConflict", "Conflict"); break;
+			}
+		}
+		else
+		{
+			// Only the visible rows export their values
+			const void* Value = ColumnName == DataAssetMergeColumns::Base ? Item->BaseValue : ColumnName == DataAssetMergeColumns::Local ? Item->LocalValue : Item->RemoteValue;
+			Text = FText::FromString(DataAssetMerge::ExportValue(Item->Property, Value));
+		}
+
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+				.ColorAndOpacity(Item->Change == EMergeChange::Conflict ? FSlateColor(FLinearColor(1.0f, 0.4f, 0.3f)) : FSlateColor::UseForeground())
+			];
+	}
+
+private:
+	TSharedPtr<FMergeEntry> Item;
+};
+
+void SDataAssetMerge::Construct(const FArguments& InArgs)
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataAssetMerge, 1);
+
+	BaseAsset = const_cast<UObject*>(InArgs._BaseAsset);
+	LocalAsset = InArgs._LocalAsset;
+	RemoteAsset = const_cast<UObject*>(InArgs._RemoteAsset);
+	OnMergeResolved = InArgs._OnMergeResolved;
+	WeakParentWindow = InArgs._ParentWindow;
+
+	this->ChildSlot
+		[
+			SNew(SBorder)
+			.BorderImage(FEditorStyle::GetBrush("Docking.Tab", ".ContentAreaBrush"))
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					.VAlign(VAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text(this, &SDataAssetMerge::GetStatusText)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					.Padding(4.0f, 0.0f)
+					[
+						SNew(SCheckBox)
+						.IsChecked_Lambda([this]() { return bShowAutoMerged ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+						.OnCheckStateChanged_Lambda([this](ECheckBoxState InState)
+							{
+								bShowAutoMerged = InState == ECheckBoxState::Checked;
+								RefreshVisibleEntries();
+							})
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("ShowAutoMerged", "Show auto-merged"))
+						]
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(4.0f, 0.0f)
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("AllLocal", "All Conflicts Local"))
+						.IsEnabled_Lambda([this]() { return Task.IsValid() && Task->bDone; })
+						.OnClicked_Lambda([this]() { SetAllConflicts(false); return FReply::Handled(); })
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("AllRemote", "All Conflicts Remote"))
+						.IsEnabled_Lambda([this]() { return Task.IsValid() && Task->bDone; })
+						.OnClicked_Lambda([this]() { SetAllConflicts(true); return FReply::Handled(); })
+					]
+				]
+				+ SVerticalBox::Slot()
+				[
+					SNew(SBorder)
+					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+					[
+						SAssignNew(ListView, SListView<TSharedPtr<FMergeEntry>>)
+						.ListItemsSource(&VisibleEntries)
+						.OnGenerateRow(this, &SDataAssetMerge::OnGenerateRow)
+						.SelectionMode(ESelectionMode::Single)
+						.HeaderRow
+						(
+							SNew(SHeaderRow)
+							+ SHeaderRow::Column(DataAssetMergeColumns::Property)
+							.DefaultLabel(LOCTEXT("PropertyColumn", "Property"))
+							.ManualWidth(220.0f)
+							+ SHeaderRow::Column(DataAssetMergeColumns::Change)
+							.DefaultLabel(LOCTEXT("ChangeColumn", "Changed By"))
+							.ManualWidth(80.0f)
+							+ SHeaderRow::Column(DataAssetMergeColumns::Base)
+							.DefaultLabel(LOCTEXT("BaseColumn", "Base"))
+							+ SHeaderRow::Column(DataAssetMergeColumns::Local)
+							.DefaultLabel(LOCTEXT("LocalColumn", "Local"))
+							+ SHeaderRow::Column(DataAssetMergeColumns::Remote)
+							.DefaultLabel(LOCTEXT("RemoteColumn", "Remote"))
+							+ SHeaderRow::Column(DataAssetMergeColumns::Use)
+							.DefaultLabel(LOCTEXT("UseColumn", "Use"))
+							.ManualWidth(80.0f)
+						)
+					]
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					[
+						SNew(SSpacer)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("ApplyMerge", "Apply"))
+						.ToolTipText(LOCTEXT("ApplyMergeTooltip", "Copies every remote change and the conflicts picked remote into the local asset, as one undoable change"))
+						.IsEnabled_Lambda([this]() { return Task.IsValid() && Task->bDone && !Task->Progress.bCancelled; })
+						.OnClicked(this, &SDataAssetMerge::OnApplyClicked)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("CancelMerge", "Cancel"))
+						.OnClicked(this, &SDataAssetMerge::OnCancelClicked)
+					]
+				]
+			]
+		];
+
+	// Revisions saved with another class don't line up property by property
+	if (BaseAsset->GetClass() != LocalAsset->GetClass() || RemoteAsset->GetClass() != LocalAsset->GetClass())
+	{
+		UE_LOG(LogDataAssetMerge, Warning, TEXT("Can't merge %s, its class differs between the base, local and remote revisions"), *LocalAsset->GetPathName());
+		return;
+	}
+
+	Task = MakeShared<FDataAssetMergeTask, ESPMode::ThreadSafe>(BaseAsset, LocalAsset, RemoteAsset);
+	Task->Start();
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SDataAssetMerge::PollClassify));
+}
+
+SDataAssetMerge::~SDataAssetMerge()
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataAssetMerge, -1);
+
+	if (Task.IsValid())
+	{
+		Task->Progress.bCancelled = true;
+	}
+	Resolve(EMergeResult::Cancelled);
+}
+
+void SDataAssetMerge::CreateMergeWindow(const UObject* BaseAsset, UObject* LocalAsset, const UObject* RemoteAsset, const FOnMergeResolved& OnMergeResolved)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	TSharedPtr<SWindow> Window = SNew(SWindow)
+		.Title(FText::Format(LOCTEXT("MergeWindowTitle", "Merge {0}"), FText::FromString(LocalAsset->GetName())))
+		.ClientSize(FVector2D(1100, 700));
+
+	Window->SetContent(SNew(SDataAssetMerge)
+		.BaseAsset(BaseAsset)
+		.LocalAsset(LocalAsset)
+		.RemoteAsset(RemoteAsset)
+		.OnMergeResolved(OnMergeResolved)
+		.ParentWindow(Window));
+
+	// The worker reads the local asset and the entries point into it, so nothing else may edit it or undo until the window is closed
+	FSlateApplication::Get().AddModalWindow(Window.ToSharedRef(), FSlateApplication::Get().GetActiveTopLevelWindow());
+}
+
+/** Loads a revision of Asset's package for diffing, null when it can't be fetched or doesn't have the asset */
+static UObject* LoadRevision(const UObject* Asset, const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision)
+{
+	FString Filename;
+	if (!Revision.IsValid() || !FSourceControlScheduler::Get().FetchRevisionFile(Revision, ESourceControlJobPriority::Interactive, Filename))
+	{
+		return nullptr;
+	}
+
+	UPackage* Package = LoadPackage(nullptr, *Filename, LOAD_ForDiff | LOAD_DisableCompileOnLoad);
+	return Package ? FindObject<UObject>(Package, *Asset->GetName()) : nullptr;
+}
+
+static void OpenConflictMerge(TWeakObjectPtr<UObject> WeakAsset, bool bHistoryQueried)
+{
+	UObject* LocalAsset = WeakAsset.Get();
+	if (!LocalAsset)
+	{
+		return;
+	}
+
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(LocalAsset->GetOutermost());
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	FSourceControlStatePtr State = SourceControlProvider.GetState(PackageFilename, EStateCacheUsage::Use);
+	if (!bHistoryQueried && (!State.IsValid() || State->GetHistorySize() == 0 || !State->GetBaseRevForMerge().IsValid()))
+	{
+		TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+		UpdateStatusOp->SetUpdateHistory(true);
+		FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, { PackageFilename }, ESourceControlJobPriority::Interactive,
+			FSourceControlOperationComplete::CreateLambda([WeakAsset](const FSourceControlOperationRef&, ECommandResult::Type InResult)
+				{
+					if (InResult != ECommandResult::Cancelled)
+					{
+						OpenConflictMerge(WeakAsset, true);
+					}
+				}));
+		return;
+	}
+
+	if (!State.IsValid() || !State->IsConflicted() || State->GetHistorySize() == 0 || !State->GetBaseRevForMerge().IsValid())
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("NotConflicted", "{0} is not in conflict, or source control doesn't know the revision it was edited from"), FText::FromString(LocalAsset->GetName())));
+		return;
+	}
+
+	// The base is what the local edit started from, the remote is what the sync brought in
+	const UObject* BaseAsset = LoadRevision(LocalAsset, State->GetBaseRevForMerge());
+	const UObject* RemoteAsset = LoadRevision(LocalAsset, State->GetHistoryItem(0));
+	if (!BaseAsset || !RemoteAsset)
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("UnableToLoadMerge", "Unable to load the base and remote revisions to merge"));
+		return;
+	}
+
+	SDataAssetMerge::CreateMergeWindow(BaseAsset, LocalAsset, RemoteAsset, FOnMergeResolved::CreateLambda([PackageFilename](UPackage* MergedPackage, EMergeResult::Type Result)
+		{
+			if (Result != EMergeResult::Completed || !MergedPackage)
+			{
+				return;
+			}
+
+			// The merged state is what gets submitted, save it then tell source control the conflict is settled
+			if (FEditorFileUtils::PromptForCheckoutAndSave({ MergedPackage }, false, false) != FEditorFileUtils::PR_Success)
+			{
+				return;
+			}
+			FSourceControlScheduler::Get().QueueOperation(ISourceControlOperation::Create<FResolve>(), { PackageFilename }, ESourceControlJobPriority::Interactive,
+				FSourceControlOperationComplete::CreateLambda([PackageFilename](const FSourceControlOperationRef&, ECommandResult::Type InResult)
+					{
+						if (InResult != ECommandResult::Succeeded)
+						{
+							UE_LOG(LogDataAssetMerge, Warning, TEXT("Merged %s but could not mark it resolved"), *PackageFilename);
+							return;
+						}
+						FNotificationInfo Info(FText::Format(LOCTEXT("MergeResolved", "{0} merged and marked resolved"), FText::FromString(FPaths::GetBaseFilename(PackageFilename))));
+						Info.ExpireDuration = 4.0f;
+						FSlateNotificationManager::Get().AddNotification(Info);
+					}));
+		}));
+}
+
+void SDataAssetMerge::MergeConflictedAsset(UObject* LocalAsset)
+{
+	OpenConflictMerge(LocalAsset, false);
+}
+
+void SDataAssetMerge::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(BaseAsset);
+	Collector.AddReferencedObject(LocalAsset);
+	Collector.AddReferencedObject(RemoteAsset);
+	// Only cleared for an object destroyed anyway, a forced delete: the worker stops at its next check
+	if (Task.IsValid() && (!BaseAsset || !LocalAsset || !RemoteAsset))
+	{
+		Task->Progress.bCancelled = true;
+	}
+}
+
+EActiveTimerReturnType SDataAssetMerge::PollClassify(double InCurrentTime, float InDeltaTime)
+{
+	if (!Task->bDone)
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	Entries.Reset(Task->Entries.Num());
+	for (FMergeEntry& Entry : Task->Entries)
+	{
+		Entries.Add(MakeShared<FMergeEntry>(MoveTemp(Entry)));
+	}
+	Task->Entries.Empty();
+	RefreshVisibleEntries();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SDataAssetMerge::RefreshVisibleEntries()
+{
+	// Conflicts first, they are what needs looking at
+	VisibleEntries.Reset();
+	for (const TSharedPtr<FMergeEntry>& Entry : Entries)
+	{
+		if (Entry->Change == EMergeChange::Conflict)
+		{
+			VisibleEntries.Add(Entry);
+		}
+	}
+	if (bShowAutoMerged)
+	{
+		for (const TSharedPtr<FMergeEntry>& Entry : Entries)
+		{
+			if (Entry->Change != EMergeChange::Conflict)
+			{
+				VisibleEntries.Add(Entry);
+			}
+		}
+	}
+	ListView->RequestListRefresh();
+}
+
+FReply SDataAssetMerge::OnApplyClicked()
+{
+	TArray<FMergeEntry> EntriesToApply;
+	EntriesToApply.Reserve(Entries.Num());
+	for (const TSharedPtr<FMergeEntry>& Entry : Entries)
+	{
+		EntriesToApply.Add(*Entry);
+	}
+
+	const int32 NumApplied = DataAssetMerge::Apply(LocalAsset, EntriesToApply);
+	UE_LOG(LogDataAssetMerge, Log, TEXT("Merged %d remote changes into %s"), NumApplied, *LocalAsset->GetPathName());
+
+	Resolve(EMergeResult::Completed);
+	if (TSharedPtr<SWindow> ParentWindow = WeakParentWindow.Pin())
+	{
+		ParentWindow->RequestDestroyWindow();
+	}
+	return FReply::Handled();
+}
+
+FReply SDataAssetMerge::OnCancelClicked()
+{
+	Resolve(EMergeResult::Cancelled);
+	if (TSharedPtr<SWindow> ParentWindow = WeakParentWindow.Pin())
+	{
+		ParentWindow->RequestDestroyWindow();
+	}
+	return FReply::Handled();
+}
+
+void SDataAssetMerge::SetAllConflicts(bool bTakeRemote)
+{
+	for (const TSharedPtr<FMergeEntry>& Entry : Entries)
+	{
+		if (Entry->Change == EMergeChange::Conflict && Entry->bCanTakeRemote)
+		{
+			Entry->bTakeRemote = bTakeRemote;
+		}
+	}
+}
+
+FText SDataAssetMerge::GetStatusText() const
+{
+	if (!Task.IsValid())
+	{
+		return LOCTEXT("ClassMismatch", "The asset's class differs between the base, local and remote revisions, it can't be merged property by property");
+	}
+	if (!Task->bDone)
+	{
+		return FText::Format(LOCTEXT("Classifying", "Comparing both sides with the base: {0} properties visited"), FText::AsNumber(Task->Progress.PropertiesVisited.Load()));
+	}
+
+	int32 NumRemote = 0;
+	int32 NumConflicts = 0;
+	for (const TSharedPtr<FMergeEntry>& Entry : Entries)
+	{
+		NumRemote += Entry->Change == EMergeChange::Remote ? 1 : 0;
+		NumConflicts += Entry->Change == EMergeChange::Conflict ? 1 : 0;
+	}
+	return FText::Format(LOCTEXT("MergeStatus", "{0} remote changes merge automatically, {1} local and shared changes are kept, {2} conflicts"),
+		FText::AsNumber(NumRemote), FText::AsNumber(Entries.Num() - NumRemote - NumConflicts), FText::AsNumber(NumConflicts));
+}
+
+TSharedRef<ITableRow> SDataAssetMerge::OnGenerateRow(TSharedPtr<FMergeEntry> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SMergeEntryRow, OwnerTable)
+		.Item(Item);
+}
+
+void SDataAssetMerge::Resolve(EMergeResult::Type Result)
+{
+	if (bResolved)
+	{
+		return;
+	}
+	bResolved = true;
+	OnMergeResolved.ExecuteIfBound(LocalAsset ? LocalAsset->GetOutermost() : nullptr, Result);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,417 @@
+
+#include "DataTableDiff.h"
+#include "AssetHistoryMemory.h"
+#include "DiffUtils.h"
+#include "PropertyDiff.h"
+#include "AssetHistorySettings.h"
+#include "Engine/DataTable.h"
+#include "DataTableUtils.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/ArchiveUObject.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Layout/SScrollBox.h"
+
+#define LOCTEXT_NAMESPACE "SDataTableDiff"
+
+static const FName RowNameColumnId(TEXT("RowName"));
+static const FName StatusColumnId(TEXT("Status"));
+/** Property columns use this name with the column index as number, so a field called "Status" can't collide */
+static const FName PropertyColumnId(TEXT("DiffColumn"));
+
+/** Folds everything a row serializes into a 64 bit hash, without keeping the bytes around */
+class FRowHashArchive : public FArchiveUObject
+{
+public:
+	FRowHashArchive()
+	{
+		SetIsSaving(true);
+		SetIsPersistent(false);
+	}
+
+	virtual void Serialize(void* Data, int64 Num) override
+	{
+		if (Num > 0)
+		{
+			Hash = CityHash64WithSeed(static_cast<const char*>(Data), Num, Hash);
+		}
+	}
+
+	virtual FArchive& operator<<(FName& Value) override
+	{
+		// Both revisions live in the same process so the name entries are shared
+		uint32 Entry[2] = { Value.GetComparisonIndex().ToUnstableInt(), (uint32)Value.GetNumber() };
+		Serialize(Entry, sizeof(Entry));
+		return *this;
+	}
+
+	virtual FArchive& operator<<(UObject*& Value) override
+	{
+		FString Path = Value ? Value->GetPathName() : FString();
+		return *this << Path;
+	}
+
+	virtual FString GetArchiveName() const override { return TEXT("FRowHashArchive"); }
+
+	uint64 Hash = 0;
+};
+
+uint64 DataTableDiff::HashRow(const UScriptStruct* RowStruct, const uint8* RowData)
+{
+	FRowHashArchive Ar;
+	RowStruct->SerializeBin(Ar, const_cast<uint8*>(RowData));
+	return Ar.Hash;
+}
+
+void DataTableDiff::DiffTables(const UDataTable* TableOld, const UDataTable* TableNew, FDataTableDiffResult& OutResult)
+{
+	check(TableOld && TableNew);
+
+	const UScriptStruct* OldStruct = TableOld->GetRowStruct();
+	const UScriptStruct* NewStruct = TableNew->GetRowStruct();
+	if (!OldStruct || !NewStruct)
+	{
+		return;
+	}
+
+	const TMap<FName, uint8*>& OldRows = TableOld->GetRowMap();
+	const TMap<FName, uint8*>& NewRows = TableNew->GetRowMap();
+
+	// Pair the rows by name first, hashing is done in parallel afterwards
+	TArray<FName> NewNames;
+	TArray<const uint8*> NewData;
+	TArray<const uint8*> MatchingOldData;
+	NewNames.Reserve(NewRows.Num());
+	NewData.Reserve(NewRows.Num());
+	MatchingOldData.Reserve(NewRows.Num());
+	for (const TPair<FName, uint8*>& Row : NewRows)
+	{
+		uint8* const* OldRow = OldRows.Find(Row.Key);
+		NewNames.Add(Row.Key);
+		NewData.Add(Row.Value);
+		MatchingOldData.Add(OldRow ? *OldRow : nullptr);
+	}
+
+	// When the row struct itself changed the binary layout differs, so every paired row is compared column by column
+	const bool bSameStruct = OldStruct == NewStruct;
+	const double Tolerance = GetDefault<UAssetHistorySettings>()->DiffTolerance;
+	TArray<bool> RowChanged;
+	RowChanged.SetNumZeroed(NewNames.Num());
+	ParallelFor(NewNames.Num(), [&](int32 Index)
+		{
+			if (MatchingOldData[Index])
+			{
+				RowChanged[Index] = !bSameStruct || DataTableDiff::HashRow(OldStruct, MatchingOldData[Index]) != DataTableDiff::HashRow(NewStruct, NewData[Index]);
+			}
+		});
+
+	TArray<const FProperty*> NewColumns;
+	TArray<const FProperty*> OldColumns;
+	for (TFieldIterator<const FProperty> It(NewStruct); It; ++It)
+	{
+		NewColumns.Add(*It);
+		OldColumns.Add(FindFProperty<FProperty>(OldStruct, It->GetFName()));
+	}
+
+	TMap<int32, int32> UsedColumns;
+	auto GetColumn = [&](int32 PropertyIndex)
+	{
+		if (const int32* Found = UsedColumns.Find(PropertyIndex))
+		{
+			return *Found;
+		}
+		const FProperty* Property = NewColumns[PropertyIndex];
+		OutResult.Columns.Add(Property->GetFName());
+		OutResult.ColumnDisplayNames.Add(DataTableUtils::GetPropertyDisplayName(Property, Property->GetName()));
+		return UsedColumns.Add(PropertyIndex, OutResult.Columns.Num() - 1);
+	};
+
+	for (int32 RowIndex = 0; RowIndex < NewNames.Num(); ++RowIndex)
+	{
+		const uint8* OldRow = MatchingOldData[RowIndex];
+		const uint8* NewRow = NewData[RowIndex];
+		if (OldRow == nullptr)
+		{
+			TSharedPtr<FDataTableRowDiff> RowDiff = MakeShared<FDataTableRowDiff>();
+			RowDiff->RowName = NewNames[RowIndex];
+			RowDiff->DiffType = EDataTableRowDiffType::Added;
+			OutResult.Rows.Add(RowDiff);
+			++OutResult.NumRowsAdded;
+			continue;
+		}
+
+		++OutResult.NumRowsCompared;
+		if (!RowChanged[RowIndex])
+		{
+			++OutResult.NumRowsHashMatched;
+			continue;
+		}
+
+		TSharedPtr<FDataTableRowDiff> RowDiff = MakeShared<FDataTableRowDiff>();
+		RowDiff->RowName = NewNames[RowIndex];
+		for (int32 PropertyIndex = 0; PropertyIndex < NewColumns.Num(); ++PropertyIndex)
+		{
+			const FProperty* NewProperty = NewColumns[PropertyIndex];
+			const FProperty* OldProperty = OldColumns[PropertyIndex];
+			if (OldProperty && OldProperty->SameType(NewProperty)
+				&& FPropertyComparators::Get().AreEqual(NewProperty, OldProperty->ContainerPtrToValuePtr<void>(OldRow), NewProperty->ContainerPtrToValuePtr<void>(NewRow), Tolerance))
+			{
+				continue;
+			}
+
+			FDataTableCellDiff& Cell = RowDiff->Cells.AddDefaulted_GetRef();
+			Cell.ColumnIndex = GetColumn(PropertyIndex);
+			Cell.OldValue = OldProperty ? DataTableUtils::GetPropertyValueAsString(OldProperty, OldRow, EDataTableExportFlags::None) : FString();
+			Cell.NewValue = DataTableUtils::GetPropertyValueAsString(NewProperty, NewRow, EDataTableExportFlags::None);
+		}
+
+		// A hash mismatch without any differing column is non-editable data or values within the tolerance, don't report it
+		if (RowDiff->Cells.Num() > 0)
+		{
+			OutResult.Rows.Add(RowDiff);
+			++OutResult.NumRowsModified;
+		}
+	}
+
+	for (const TPair<FName, uint8*>& Row : OldRows)
+	{
+		if (!NewRows.Contains(Row.Key))
+		{
+			TSharedPtr<FDataTableRowDiff> RowDiff = MakeShared<FDataTableRowDiff>();
+			RowDiff->RowName = Row.Key;
+			RowDiff->DiffType = EDataTableRowDiffType::Removed;
+			OutResult.Rows.Add(RowDiff);
+			++OutResult.NumRowsRemoved;
+		}
+	}
+}
+
+/** Row of the virtualized diff table, cells are only built for the rows the list view asks for */
+class SDataTableDiffRow : public SMultiColumnTableRow<TSharedPtr<FDataTableRowDiff>>
+{
+public:
+	SLATE_BEGIN_ARGS(SDataTableDiffRow){}
+		SLATE_ARGUMENT(TSharedPtr<FDataTableRowDiff>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FDataTableRowDiff>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		if (ColumnName == RowNameColumnId)
+		{
+			return MakeCell(FText::FromName(Item->RowName), FLinearColor::White);
+		}
+
+		if (ColumnName == StatusColumnId)
+		{
+			switch (Item->DiffType)
+			{
+			case EDataTableRowDiffType::Added:
+				return MakeCell(LOCTEXT("RowAdded", "Added"), DiffViewUtils::Differs());
+			case EDataTableRowDiffType::Removed:
+				return MakeCell(LOCTEXT("RowRemoved", "Removed"), DiffViewUtils::Differs());
+			default:
+				return MakeCell(FText::Format(LOCTEXT("RowModified", "Modified ({0})"), FText::AsNumber(Item->Cells.Num())), DiffViewUtils::Differs());
+			}
+		}
+
+		if (!ColumnName.IsEqual(PropertyColumnId, ENameCase::IgnoreCase, false))
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		const int32 ColumnIndex = NAME_INTERNAL_TO_EXTERNAL(ColumnName.GetNumber());
+		const FDataTableCellDiff* Cell = Item->Cells.FindByPredicate([ColumnIndex](const FDataTableCellDiff& InCell) { return InCell.ColumnIndex == ColumnIndex; });
+		if (!Cell)
+		{
+			return MakeCell(FText::GetEmpty(), DiffViewUtils::Identical());
+		}
+
+		const FText CellText = FText::Format(LOCTEXT("CellDiff", "{0} -> {1}"), FText::FromString(Cell->OldValue), FText::FromString(Cell->NewValue));
+		return MakeCell(CellText, DiffViewUtils::Differs());
+	}
+
+private:
+	static TSharedRef<SWidget> MakeCell(const FText& Text, const FLinearColor& Color)
+	{
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+				.ColorAndOpacity(Color)
+			];
+	}
+
+	TSharedPtr<FDataTableRowDiff> Item;
+};
+
+void SDataTableDiff::Construct(const FArguments& InArgs)
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataTableDiff, 1);
+
+	check(InArgs._TableOld && InArgs._TableNew);
+	TableOld = InArgs._TableOld;
+	TableNew = InArgs._TableNew;
+
+	if (InArgs._ParentWindow.IsValid())
+	{
+		WeakParentWindow = InArgs._ParentWindow;
+
+		AssetEditorCloseDelegate = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().AddSP(this, &SDataTableDiff::OnCloseAssetEditor);
+	}
+
+	DataTableDiff::DiffTables(TableOld, TableNew, DiffResult);
+
+	TSharedRef<SHeaderRow> HeaderRow = SNew(SHeaderRow)
+		+ SHeaderRow::Column(RowNameColumnId)
+		.DefaultLabel(LOCTEXT("RowNameColumn", "Row Name"))
+		.ManualWidth(180.0f)
+		+ SHeaderRow::Column(StatusColumnId)
+		.DefaultLabel(LOCTEXT("StatusColumn", "Status"))
+		.ManualWidth(100.0f);
+
+	for (int32 ColumnIndex = 0; ColumnIndex < DiffResult.Columns.Num(); ++ColumnIndex)
+	{
+		HeaderRow->AddColumn(SHeaderRow::Column(FName(PropertyColumnId, NAME_EXTERNAL_TO_INTERNAL(ColumnIndex)))
+			.DefaultLabel(DiffResult.ColumnDisplayNames[ColumnIndex])
+			.ManualWidth(200.0f));
+	}
+
+	const FText RevisionText = FText::Format(LOCTEXT("DataTableRevisions", "{0}  ->  {1}"),
+		FText::FromString(InArgs._OldRevision.Revision), FText::FromString(InArgs._NewRevision.Revision));
+
+	this->ChildSlot
+		[
+			SNew(SBorder)
+			.BorderImage(FEditorStyle::GetBrush("Docking.Tab", ".ContentAreaBrush"))
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(STextBlock)
+						.TextStyle(FEditorStyle::Get(), "DetailsView.CategoryTextStyle")
+						.Text(RevisionText)
+					]
+					+ SHorizontalBox::Slot()
+					[
+						SNew(SSpacer)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(STextBlock)
+						.Text(GetSummaryText())
+					]
+				]
+				+ SVerticalBox::Slot()
+				[
+					SNew(SBorder)
+					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+					[
+						SNew(SScrollBox)
+						.Orientation(Orient_Horizontal)
+						+ SScrollBox::Slot()
+						[
+							SAssignNew(RowListView, SListView<TSharedPtr<FDataTableRowDiff>>)
+							.ListItemsSource(&DiffResult.Rows)
+							.OnGenerateRow(this, &SDataTableDiff::OnGenerateRow)
+							.SelectionMode(ESelectionMode::Single)
+							.HeaderRow(HeaderRow)
+						]
+					]
+				]
+			]
+		];
+}
+
+SDataTableDiff::~SDataTableDiff()
+{
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::DataTableDiff, -1);
+
+	if (AssetEditorCloseDelegate.IsValid())
+	{
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().Remove(AssetEditorCloseDelegate);
+	}
+}
+
+TSharedPtr<SWindow> SDataTableDiff::CreateDiffWindow(FText WindowTitle, const UDataTable* OldTable, const UDataTable* NewTable, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffWindows);
+
+	TSharedPtr<SWindow> Window = SNew(SWindow)
+		.Title(WindowTitle)
+		.ClientSize(FVector2D(1000, 800));
+
+	Window->SetContent(SNew(SDataTableDiff)
+		.TableOld(OldTable)
+		.TableNew(NewTable)
+		.OldRevision(OldRevision)
+		.NewRevision(NewRevision)
+		.ParentWindow(Window));
+
+	// Make this window a child of the modal window if we've been spawned while one is active.
+	TSharedPtr<SWindow> ActiveModal = FSlateApplication::Get().GetActiveModalWindow();
+	if (ActiveModal.IsValid())
+	{
+		FSlateApplication::Get().AddWindowAsNativeChild(Window.ToSharedRef(), ActiveModal.ToSharedRef());
+	}
+	else
+	{
+		FSlateApplication::Get().AddWindow(Window.ToSharedRef());
+	}
+
+	return Window;
+}
+
+TSharedRef<ITableRow> SDataTableDiff::OnGenerateRow(TSharedPtr<FDataTableRowDiff> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SDataTableDiffRow, OwnerTable)
+		.Item(Item);
+}
+
+void SDataTableDiff::OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason CloseReason)
+{
+	if (TableOld == Asset || TableNew == Asset || CloseReason == EAssetEditorCloseReason::CloseAllAssetEditors)
+	{
+		// Tell our window to close and set our selves to collapsed to try and stop it from ticking
+		SetVisibility(EVisibility::Collapsed);
+
+		if (AssetEditorCloseDelegate.IsValid())
+		{
+			GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OnAssetEditorRequestClose().Remove(AssetEditorCloseDelegate);
+		}
+
+		if (WeakParentWindow.IsValid())
+		{
+			WeakParentWindow.Pin()->RequestDestroyWindow();
+		}
+	}
+}
+
+FText SDataTableDiff::GetSummaryText() const
+{
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Added"), FText::AsNumber(DiffResult.NumRowsAdded));
+	Args.Add(TEXT("Removed"), FText::AsNumber(DiffResult.NumRowsRemoved));
+	Args.Add(TEXT("Modified"), FText::AsNumber(DiffResult.NumRowsModified));
+	Args.Add(TEXT("Compared"), FText::AsNumber(DiffResult.NumRowsCompared));
+	Args.Add(TEXT("Skipped"), FText::AsNumber(DiffResult.NumRowsHashMatched));
+	return FText::Format(LOCTEXT("DataTableDiffSummary", "{Added} added, {Removed} removed, {Modified} modified ({Skipped} of {Compared} rows unchanged)"), Args);
+}
+
+#undef LOCTEXT_NAMESPACE
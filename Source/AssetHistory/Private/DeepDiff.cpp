@@ -0,0 +1,271 @@
+
+#include "DeepDiff.h"
+#include "AssetHistoryMemory.h"
+#include "SourceControlScheduler.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "SourceControlHelpers.h"
+#include "Engine/DataAsset.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UnrealType.h"
+#include "UObject/GarbageCollection.h"
+#include "Async/Async.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDeepDiff, Log, All);
+
+FDeepObjectDiff::FDeepObjectDiff(const FOptions& InOptions)
+	: Options(InOptions)
+{
+}
+
+void FDeepObjectDiff::Diff(const UObject* OldRoot, const UObject* NewRoot)
+{
+	Visited.Add(MakeTuple(OldRoot, NewRoot));
+	KeepObject(OldRoot);
+	KeepObject(NewRoot);
+	if (Options.bFollowInstancedSubObjects)
+	{
+		DiffSubObjects(OldRoot, NewRoot, FString(), 1);
+	}
+	if (Options.bFollowReferencedDataAssets)
+	{
+		DiffReferencedAssets(OldRoot, NewRoot, 1);
+	}
+	UE_LOG(LogDeepDiff, Verbose, TEXT("%s: %d pairs compared, %d differ"), *NewRoot->GetName(), Visited.Num(), Pairs.Num());
+}
+
+void FDeepObjectDiff::DiffPair(const UObject* OldObject, const UObject* NewObject, const FString& Path, int32 Depth, bool bReferencedAsset)
+{
+	// Also what stops cycles, the pair is marked before its children are followed
+	bool bAlreadyVisited = false;
+	Visited.Add(MakeTuple(OldObject, NewObject), &bAlreadyVisited);
+	if (bAlreadyVisited || IsCancelled())
+	{
+		return;
+	}
+
+	KeepObject(OldObject);
+	KeepObject(NewObject);
+
+	FDeepDiffPair Pair;
+	Pair.Path = Path;
+	Pair.OldObject = OldObject;
+	Pair.NewObject = NewObject;
+	Pair.bReferencedAsset = bReferencedAsset;
+	// Both are kept already, by DiffSubObjects or LoadAtRevision, so the compare doesn't need to hold up garbage collection
+	if (OldObject && NewObject && !PropertyDiff::CompareObjects(OldObject, NewObject, Pair.Differences, Options.Progress))
+	{
+		return;
+	}
+
+	const bool bOneSided = !OldObject || !NewObject;
+	if (bOneSided || Pair.Differences.Num() > 0)
+	{
+		Pairs.Add(MoveTemp(Pair));
+	}
+
+	if (bOneSided || Depth >= Options.MaxDepth)
+	{
+		return;
+	}
+
+	if (Options.bFollowInstancedSubObjects)
+	{
+		DiffSubObjects(OldObject, NewObject, Path, Depth + 1);
+	}
+	if (Options.bFollowReferencedDataAssets)
+	{
+		DiffReferencedAssets(OldObject, NewObject, Depth + 1);
+	}
+}
+
+void FDeepObjectDiff::DiffSubObjects(const UObject* OldObject, const UObject* NewObject, const FString& Path, int32 Depth)
+{
+	// Instanced objects keep their name across saves, pair them by it
+	TArray<UObject*> OldSubObjects;
+	TArray<UObject*> NewSubObjects;
+	{
+		// Kept before the guard ends, an unreachable sub-object could be purged under the worker otherwise
+		FGCScopeGuard GCGuard;
+		GetObjectsWithOuter(OldObject, OldSubObjects, false);
+		GetObjectsWithOuter(NewObject, NewSubObjects, false);
+		for (const TArray<UObject*>* SubObjects : { &OldSubObjects, &NewSubObjects })
+		{
+			for (const UObject* SubObject : *SubObjects)
+			{
+				KeepObject(SubObject);
+			}
+		}
+	}
+
+	TMap<FName, const UObject*> NewByName;
+	for (const UObject* SubObject : NewSubObjects)
+	{
+		NewByName.Add(SubObject->GetFName(), SubObject);
+	}
+
+	const FString Prefix = Path.IsEmpty() ? FString() : Path + TEXT(".");
+	for (const UObject* OldSubObject : OldSubObjects)
+	{
+		const UObject* NewSubObject = nullptr;
+		NewByName.RemoveAndCopyValue(OldSubObject->GetFName(), NewSubObject);
+		DiffPair(OldSubObject, NewSubObject, Prefix + OldSubObject->GetName(), Depth, false);
+	}
+	for (const TPair<FName, const UObject*>& Added : NewByName)
+	{
+		DiffPair(nullptr, Added.Value, Prefix + Added.Value->GetName(), Depth, false);
+	}
+}
+
+static void CollectReferencedDataAssets(const UObject* Object, TMap<FString, const UObject*>& OutAssets)
+{
+	for (TPropertyValueIterator<FObjectPropertyBase> It(Object->GetClass(), Object, EPropertyValueIteratorFlags::FullRecursion); It; ++It)
+	{
+		const UObject* Referenced = It.Key()->GetObjectPropertyValue(It.Value());
+		// Sub-objects are paired by DiffSubObjects
+		if (Referenced && Referenced->IsA<UPrimaryDataAsset>() && !Referenced->IsIn(Object))
+		{
+			OutAssets.Add(Referenced->GetPathName(), Referenced);
+		}
+	}
+}
+
+void FDeepObjectDiff::DiffReferencedAssets(const UObject* OldObject, const UObject* NewObject, int32 Depth)
+{
+	// Both sides point to the asset loaded in the editor, only those referenced on both sides are compared:
+	// a reference that was added or removed already shows as a property change of the referencing object
+	TMap<FString, const UObject*> OldReferences;
+	TMap<FString, const UObject*> NewReferences;
+	{
+		FGCScopeGuard GCGuard;
+		CollectReferencedDataAssets(OldObject, OldReferences);
+		CollectReferencedDataAssets(NewObject, NewReferences);
+	}
+
+	for (const TPair<FString, const UObject*>& Reference : OldReferences)
+	{
+		if (IsCancelled())
+		{
+			return;
+		}
+		if (!NewReferences.Contains(Reference.Key))
+		{
+			continue;
+		}
+
+		const UObject* OldVersion = LoadAtRevision(Reference.Value, Options.OldRevision);
+		const UObject* NewVersion = LoadAtRevision(Reference.Value, Options.NewRevision);
+		const FString Path = Reference.Value->GetName() + TEXT(":");
+		if (OldVersion && NewVersion && OldVersion != NewVersion)
+		{
+			DiffPair(OldVersion, NewVersion, Path, Depth, true);
+		}
+		else if (AssetsWithoutHistory.Contains(Reference.Value)
+			&& !Pairs.ContainsByPredicate([&Path](const FDeepDiffPair& Pair) { return Pair.bHistoryNotFetched && Pair.Path == Path; }))
+		{
+			// Shown rather than dropped, the sub-objects panel would otherwise suggest the asset didn't change
+			FDeepDiffPair& Pair = Pairs.AddDefaulted_GetRef();
+			Pair.Path = Path;
+			Pair.bReferencedAsset = true;
+			Pair.bHistoryNotFetched = true;
+		}
+	}
+}
+
+const UObject* FDeepObjectDiff::LoadAtRevision(const UObject* Asset, const FRevisionInfo& Revision)
+{
+	if (!IsInGameThread())
+	{
+		// LoadPackage is game thread only. The worker holds no GC guard while it waits, the game thread never waits on it
+		const UObject* Result = nullptr;
+		FEvent* Done = FPlatformProcess::GetSynchEventFromPool(true);
+		AsyncTask(ENamedThreads::GameThread, [this, Asset, &Revision, &Result, Done]()
+			{
+				if (!IsCancelled())
+				{
+					Result = LoadAtRevision(Asset, Revision);
+				}
+				Done->Trigger();
+			});
+		Done->Wait();
+		FPlatformProcess::ReturnSynchEventToPool(Done);
+		return Result;
+	}
+
+	const TPair<const UObject*, FString> Key(Asset, Revision.Revision);
+	if (const UObject** Loaded = LoadedRevisions.Find(Key))
+	{
+		return *Loaded;
+	}
+	// Null while it loads: the fetch and LoadPackage can reenter and add to the map, so no reference into it is held across them
+	LoadedRevisions.Add(Key, nullptr);
+
+	if (Revision.Revision == TEXT("HEAD"))
+	{
+		// The current asset may be edited while the worker compares it
+		const UObject* Copy = PropertyDiff::MakeWorkerCopy(Asset);
+		KeepObject(Copy);
+		LoadedRevisions[Key] = Copy;
+		return Copy;
+	}
+
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (!SourceControlModule.IsEnabled())
+	{
+		return nullptr;
+	}
+
+	// Histories are not queried from here, the warm up and the History menu fill the cache
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(Asset->GetOutermost()->GetName());
+	FSourceControlStatePtr State = SourceControlModule.GetProvider().GetState(PackageFilename, EStateCacheUsage::Use);
+	if (!State.IsValid() || State->GetHistorySize() == 0)
+	{
+		UE_LOG(LogDeepDiff, Verbose, TEXT("No cached history for %s, not compared"), *PackageFilename);
+		AssetsWithoutHistory.Add(Asset);
+		return nullptr;
+	}
+
+	// Revision names are per file for Perforce, dates work for every provider. The history is newest first
+	TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Match;
+	for (int32 HistoryIndex = 0; !Match.IsValid() && HistoryIndex < State->GetHistorySize(); ++HistoryIndex)
+	{
+		TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Item = State->GetHistoryItem(HistoryIndex);
+		if (Item.IsValid() && Item->GetDate() <= Revision.Date)
+		{
+			Match = Item;
+		}
+	}
+	if (!Match.IsValid())
+	{
+		return nullptr;
+	}
+
+	FString Filename;
+	if (!FSourceControlScheduler::Get().FetchRevisionFile(Match, ESourceControlJobPriority::Interactive, Filename))
+	{
+		return nullptr;
+	}
+
+	LLM_SCOPE_BYTAG(AssetHistory_DiffPackages);
+	UPackage* Package = LoadPackage(nullptr, *Filename, LOAD_ForDiff | LOAD_DisableCompileOnLoad);
+	const UObject* Loaded = Package ? FindObject<UObject>(Package, *Asset->GetName()) : nullptr;
+	KeepObject(Loaded);
+	LoadedRevisions[Key] = Loaded;
+	return Loaded;
+}
+
+void FDeepObjectDiff::KeepObject(const UObject* Object)
+{
+	if (Object)
+	{
+		FScopeLock ScopeLock(&KeptObjectsLock);
+		KeptObjects.Add(const_cast<UObject*>(Object));
+	}
+}
+
+void FDeepObjectDiff::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	FScopeLock ScopeLock(&KeptObjectsLock);
+	Collector.AddReferencedObjects(KeptObjects);
+}
@@ -0,0 +1,230 @@
+
+#include "DiffExport.h"
+#include "TaggedPropertyReader.h"
+#include "DiffUtils.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDiffExport, Log, All);
+
+static FString EscapeJson(const FString& Value)
+{
+	FString Result;
+	Result.Reserve(Value.Len() + 2);
+	Result += TEXT('"');
+	for (const TCHAR Character : Value)
+	{
+		switch (Character)
+		{
+		case TEXT('"'): Result += TEXT("\\\""); break;
+		case TEXT('\\'): Result += TEXT("\\\\"); break;
+		case TEXT('\n'): Result += TEXT("\\n"); break;
+		case TEXT('\r'): Result += TEXT("\\r"); break;
+		case TEXT('\t'): Result += TEXT("\\t"); break;
+		default:
+			if (Character < 0x20)
+			{
+				Result += FString::Printf(TEXT("\\u%04x"), static_cast<uint32>(Character));
+			}
+			else
+			{
+				Result += Character;
+			}
+		}
+	}
+	Result += TEXT('"');
+	return Result;
+}
+
+static FString EscapeCsv(const FString& Value)
+{
+	int32 Index;
+	if (!Value.FindChar(TEXT(','), Index) && !Value.FindChar(TEXT('"'), Index) && !Value.FindChar(TEXT('\n'), Index) && !Value.FindChar(TEXT('\r'), Index))
+	{
+		return Value;
+	}
+	return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+}
+
+static FString EscapeMarkdown(const FString& Value)
+{
+	// Table cells are single line, pipes would split the cell
+	return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("|"), TEXT("\\|")).Replace(TEXT("\r\n"), TEXT("<br>")).Replace(TEXT("\n"), TEXT("<br>"));
+}
+
+TUniquePtr<FDiffExportWriter> FDiffExportWriter::Create(const FString& Filename, EDiffExportFormat Format)
+{
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Archive)
+	{
+		UE_LOG(LogDiffExport, Warning, TEXT("Can't write %s"), *Filename);
+		return nullptr;
+	}
+	return TUniquePtr<FDiffExportWriter>(new FDiffExportWriter(MoveTemp(Archive), Format));
+}
+
+bool FDiffExportWriter::FormatFromFilename(const FString& Filename, EDiffExportFormat& OutFormat)
+{
+	const FString Extension = FPaths::GetExtension(Filename);
+	if (Extension == TEXT("json"))
+	{
+		OutFormat = EDiffExportFormat::Json;
+	}
+	else if (Extension == TEXT("csv"))
+	{
+		OutFormat = EDiffExportFormat::Csv;
+	}
+	else if (Extension == TEXT("md"))
+	{
+		OutFormat = EDiffExportFormat::Markdown;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+const TCHAR* FDiffExportWriter::GetFileTypes()
+{
+	return TEXT("CSV (*.csv)|*.csv|JSON (*.json)|*.json|Markdown (*.md)|*.md");
+}
+
+FDiffExportWriter::FDiffExportWriter(TUniquePtr<FArchive>&& InArchive, EDiffExportFormat InFormat)
+	: Archive(MoveTemp(InArchive))
+	, Format(InFormat)
+{
+	switch (Format)
+	{
+	case EDiffExportFormat::Json:
+		WriteUtf8(TEXT("["));
+		break;
+	case EDiffExportFormat::Csv:
+		// The BOM makes spreadsheets read the file as UTF-8
+		WriteUtf8(TEXT("\xFEFF") TEXT("Asset,Property,Old Value,New Value,Old Revision,New Revision,Author\r\n"));
+		break;
+	case EDiffExportFormat::Markdown:
+		WriteUtf8(TEXT("| Asset | Property | Old Value | New Value | Old Revision | New Revision | Author |\n|---|---|---|---|---|---|---|\n"));
+		break;
+	}
+}
+
+FDiffExportWriter::~FDiffExportWriter()
+{
+	Close();
+}
+
+void FDiffExportWriter::Write(const FDiffExportEntry& Entry)
+{
+	if (!Archive)
+	{
+		return;
+	}
+
+	switch (Format)
+	{
+	case EDiffExportFormat::Json:
+		WriteUtf8(FString::Printf(TEXT("%s\n\t{\"asset\": %s, \"property\": %s, \"oldValue\": %s, \"newValue\": %s, \"oldRevision\": %s, \"newRevision\": %s, \"author\": %s}"),
+			NumEntries > 0 ? TEXT(",") : TEXT(""),
+			*EscapeJson(Entry.AssetName), *EscapeJson(Entry.PropertyPath), *EscapeJson(Entry.OldValue), *EscapeJson(Entry.NewValue),
+			*EscapeJson(Entry.OldRevision), *EscapeJson(Entry.NewRevision), *EscapeJson(Entry.Author)));
+		break;
+	case EDiffExportFormat::Csv:
+		WriteUtf8(FString::Printf(TEXT("%s,%s,%s,%s,%s,%s,%s\r\n"),
+			*EscapeCsv(Entry.AssetName), *EscapeCsv(Entry.PropertyPath), *EscapeCsv(Entry.OldValue), *EscapeCsv(Entry.NewValue),
+			*EscapeCsv(Entry.OldRevision), *EscapeCsv(Entry.NewRevision), *EscapeCsv(Entry.Author)));
+		break;
+	case EDiffExportFormat::Markdown:
+		WriteUtf8(FString::Printf(TEXT("| %s | `%s` | %s | %s | %s | %s | %s |\n"),
+			*EscapeMarkdown(Entry.AssetName), *EscapeMarkdown(Entry.PropertyPath), *EscapeMarkdown(Entry.OldValue), *EscapeMarkdown(Entry.NewValue),
+			*EscapeMarkdown(Entry.OldRevision), *EscapeMarkdown(Entry.NewRevision), *EscapeMarkdown(Entry.Author)));
+		break;
+	}
+	++NumEntries;
+}
+
+bool FDiffExportWriter::Close()
+{
+	if (!Archive)
+	{
+		return true;
+	}
+
+	if (Format == EDiffExportFormat::Json)
+	{
+		WriteUtf8(NumEntries > 0 ? TEXT("\n]\n") : TEXT("]\n"));
+	}
+
+	const bool bSuccess = Archive->Close() && !Archive->IsError();
+	Archive.Reset();
+	return bSuccess;
+}
+
+void FDiffExportWriter::WriteUtf8(const FString& Text)
+{
+	FTCHARToUTF8 Utf8(*Text);
+	Archive->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+}
+
+static FString ExportPropertyValue(const FPropertySoftPath& Path, const UObject* Object)
+{
+	FString Value;
+	if (Object)
+	{
+		const FResolvedProperty Resolved = Path.Resolve(Object);
+		if (Resolved.Property && Resolved.Object)
+		{
+			Resolved.Property->ExportText_Direct(Value, Resolved.Property->ContainerPtrToValuePtr<void>(Resolved.Object), nullptr, nullptr, PPF_None);
+		}
+	}
+	return Value;
+}
+
+void DiffExport::WriteObjectDifferences(FDiffExportWriter& Writer, const UObject* OldObject, const UObject* NewObject, TArrayView<const FSingleObjectDiffEntry> Differences, const FDiffExportEntry& Common)
+{
+	FDiffExportEntry Entry = Common;
+	for (const FSingleObjectDiffEntry& Difference : Differences)
+	{
+		Entry.PropertyPath = Difference.Identifier.ToDisplayName();
+		Entry.OldValue = Difference.DiffType == EPropertyDiffType::PropertyAddedToA || Difference.DiffType == EPropertyDiffType::PropertyValueChanged ? ExportPropertyValue(Difference.Identifier, OldObject) : FString();
+		Entry.NewValue = Difference.DiffType == EPropertyDiffType::PropertyAddedToB || Difference.DiffType == EPropertyDiffType::PropertyValueChanged ? ExportPropertyValue(Difference.Identifier, NewObject) : FString();
+		Writer.Write(Entry);
+	}
+}
+
+void DiffExport::WriteTaggedDifferences(FDiffExportWriter& Writer, TArrayView<const FTaggedPropertyDifference> Differences, const FDiffExportEntry& Common)
+{
+	FDiffExportEntry Entry = Common;
+	for (const FTaggedPropertyDifference& Difference : Differences)
+	{
+		Entry.PropertyPath = Difference.Path;
+		Entry.OldValue = Difference.OldValue;
+		Entry.NewValue = Difference.NewValue;
+		Writer.Write(Entry);
+	}
+}
+
+FSourceControlStatePtr DiffExport::FindStateWithRevision(const FString& AssetName, const FString& Revision)
+{
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (!SourceControlModule.IsEnabled() || Revision.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	// Match the asset by name among the cached histories
+	const TArray<FSourceControlStateRef> States = SourceControlModule.GetProvider().GetCachedStateByPredicate([&AssetName, &Revision](const FSourceControlStateRef& State)
+		{
+			return FPaths::GetBaseFilename(State->GetFilename()) == AssetName && State->FindHistoryRevision(Revision).IsValid();
+		});
+	return States.Num() > 0 ? FSourceControlStatePtr(States[0]) : nullptr;
+}
+
+FString DiffExport::FindRevisionAuthor(const FString& AssetName, const FString& Revision)
+{
+	FSourceControlStatePtr State = FindStateWithRevision(AssetName, Revision);
+	return State.IsValid() ? State->FindHistoryRevision(Revision)->GetUserName() : FString();
+}
@@ -0,0 +1,295 @@
+
+#include "DifferenceTree.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Views/STableRow.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+
+#define LOCTEXT_NAMESPACE "SDifferenceTree"
+
+void SDifferenceTree::Construct(const FArguments& InArgs)
+{
+	OnItemContextMenuOpening = InArgs._OnContextMenuOpening;
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(2.0f)
+		[
+			SNew(SSearchBox)
+			.HintText(LOCTEXT("FilterHint", "Filter differences"))
+			.OnTextChanged(this, &SDifferenceTree::OnFilterTextChanged)
+		]
+		+ SVerticalBox::Slot()
+		[
+			SAssignNew(TreeView, STreeView<TSharedPtr<FDifferenceTreeNode>>)
+			.TreeItemsSource(&RootNodes)
+			.SelectionMode(ESelectionMode::Single)
+			.OnGenerateRow(this, &SDifferenceTree::OnGenerateRow)
+			.OnGetChildren(this, &SDifferenceTree::OnGetChildren)
+			.OnSelectionChanged(this, &SDifferenceTree::OnSelectionChanged)
+			.OnContextMenuOpening(this, &SDifferenceTree::OnContextMenuOpening)
+		]
+	];
+}
+
+void SDifferenceTree::SetItems(TArray<FDifferenceTreeItem>&& InItems)
+{
+	Items = MoveTemp(InItems);
+
+	TMap<FString, int32> CategoryOrder;
+	for (const FDifferenceTreeItem& Item : Items)
+	{
+		CategoryOrder.FindOrAdd(Item.Segments.Num() > 0 ? Item.Segments[0] : FString(), CategoryOrder.Num());
+	}
+
+	// Path order, with a path before the paths it prefixes, so every group ends up contiguous. Case is ignored as when grouping
+	Algo::StableSort(Items, [&CategoryOrder](const FDifferenceTreeItem& A, const FDifferenceTreeItem& B)
+		{
+			const int32 CategoryA = A.Segments.Num() > 0 ? CategoryOrder[A.Segments[0]] : 0;
+			const int32 CategoryB = B.Segments.Num() > 0 ? CategoryOrder[B.Segments[0]] : 0;
+			if (CategoryA != CategoryB)
+			{
+				return CategoryA < CategoryB;
+			}
+			for (int32 Index = 1; Index < A.Segments.Num() && Index < B.Segments.Num(); ++Index)
+			{
+				const int32 Compare = A.Segments[Index].Compare(B.Segments[Index], ESearchCase::IgnoreCase);
+				if (Compare != 0)
+				{
+					return Compare < 0;
+				}
+			}
+			return A.Segments.Num() < B.Segments.Num();
+		});
+
+	RebuildVisibleItems();
+}
+
+void SDifferenceTree::OnFilterTextChanged(const FText& InFilterText)
+{
+	FilterText = InFilterText.ToString().TrimStartAndEnd();
+	RebuildVisibleItems();
+}
+
+void SDifferenceTree::RebuildVisibleItems()
+{
+	VisibleItems.Reset(Items.Num());
+	for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+	{
+		const FDifferenceTreeItem& Item = Items[ItemIndex];
+		const bool bPasses = FilterText.IsEmpty()
+			|| Item.Segments.ContainsByPredicate([this](const FString& Segment) { return Segment.Contains(FilterText); })
+			|| Item.Label.ToString().Contains(FilterText);
+		if (bPasses)
+		{
+			VisibleItems.Add(ItemIndex);
+		}
+	}
+
+	RootNodes.Reset();
+	CurrentPosition = INDEX_NONE;
+	if (VisibleItems.Num() > 0)
+	{
+		BuildNodes(0, 0, VisibleItems.Num(), RootNodes);
+	}
+	else
+	{
+		TSharedPtr<FDifferenceTreeNode> EmptyNode = MakeShared<FDifferenceTreeNode>();
+		EmptyNode->Name = Items.Num() > 0 ? LOCTEXT("NoMatches", "No matching differences").ToString() : LOCTEXT("NoDifferences", "No differences detected").ToString();
+		EmptyNode->bChildrenBuilt = true;
+		RootNodes.Add(EmptyNode);
+	}
+
+	TreeView->RequestTreeRefresh();
+	for (const TSharedPtr<FDifferenceTreeNode>& RootNode : RootNodes)
+	{
+		TreeView->SetItemExpansion(RootNode, true);
+	}
+}
+
+void SDifferenceTree::BuildChildren(FDifferenceTreeNode& Node)
+{
+	if (!Node.bChildrenBuilt)
+	{
+		Node.bChildrenBuilt = true;
+		BuildNodes(Node.Depth, Node.Begin, Node.End, Node.Children);
+	}
+}
+
+void SDifferenceTree::BuildNodes(int32 Depth, int32 Begin, int32 End, TArray<TSharedPtr<FDifferenceTreeNode>>& OutNodes)
+{
+	for (int32 Position = Begin; Position < End; )
+	{
+		const FDifferenceTreeItem& Item = Items[VisibleItems[Position]];
+
+		// The group itself changed, e.g. a whole array
+		if (Item.Segments.Num() <= Depth)
+		{
+			TSharedPtr<FDifferenceTreeNode> Leaf = MakeShared<FDifferenceTreeNode>();
+			Leaf->Name = Item.Segments.Num() > 0 ? Item.Segments.Last() : FString();
+			Leaf->Depth = Depth;
+			Leaf->Begin = Position;
+			Leaf->End = Position + 1;
+			Leaf->ItemIndex = VisibleItems[Position];
+			OutNodes.Add(Leaf);
+			++Position;
+			continue;
+		}
+
+		const FString& Segment = Item.Segments[Depth];
+		int32 RunEnd = Position + 1;
+		while (RunEnd < End && Items[VisibleItems[RunEnd]].Segments.IsValidIndex(Depth) && Items[VisibleItems[RunEnd]].Segments[Depth].Equals(Segment, ESearchCase::IgnoreCase))
+		{
+			++RunEnd;
+		}
+
+		TSharedPtr<FDifferenceTreeNode> Node = MakeShared<FDifferenceTreeNode>();
+		Node->Begin = Position;
+		Node->End = RunEnd;
+		Node->Depth = Depth + 1;
+		if (RunEnd - Position == 1 && Depth > 0)
+		{
+			// A group of one would only add a level, show the rest of the path on the leaf
+			Node->Name = FString::Join(TArrayView<const FString>(Item.Segments).RightChop(Depth), TEXT(" "));
+			Node->ItemIndex = VisibleItems[Position];
+		}
+		else
+		{
+			Node->Name = Segment;
+		}
+		OutNodes.Add(Node);
+		Position = RunEnd;
+	}
+}
+
+void SDifferenceTree::SelectPosition(int32 Position)
+{
+	if (!VisibleItems.IsValidIndex(Position))
+	{
+		return;
+	}
+
+	// Nodes of a level cover consecutive ranges, the one holding Position is found by its Begin
+	TArray<TSharedPtr<FDifferenceTreeNode>>* Nodes = &RootNodes;
+	while (Nodes->Num() > 0)
+	{
+		const int32 NodeIndex = Algo::UpperBoundBy(*Nodes, Position, [](const TSharedPtr<FDifferenceTreeNode>& Node) { return Node->Begin; }) - 1;
+		if (!Nodes->IsValidIndex(NodeIndex))
+		{
+			return;
+		}
+
+		TSharedPtr<FDifferenceTreeNode> Node = (*Nodes)[NodeIndex];
+		if (Node->IsLeaf())
+		{
+			CurrentPosition = Position;
+			TGuardValue<bool> GuardSelecting(bSelectingPosition, true);
+			TreeView->SetSelection(Node);
+			TreeView->RequestScrollIntoView(Node);
+			Items[Node->ItemIndex].OnFocused.ExecuteIfBound();
+			return;
+		}
+
+		BuildChildren(*Node);
+		TreeView->SetItemExpansion(Node, true);
+		Nodes = &Node->Children;
+	}
+}
+
+void SDifferenceTree::SelectNext()
+{
+	SelectPosition(CurrentPosition + 1);
+}
+
+void SDifferenceTree::SelectPrev()
+{
+	SelectPosition(CurrentPosition - 1);
+}
+
+bool SDifferenceTree::HasNext() const
+{
+	return CurrentPosition + 1 < VisibleItems.Num();
+}
+
+bool SDifferenceTree::HasPrev() const
+{
+	return CurrentPosition > 0;
+}
+
+TSharedRef<ITableRow> SDifferenceTree::OnGenerateRow(TSharedPtr<FDifferenceTreeNode> Node, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	TSharedRef<SWidget> Content = SNullWidget::NullWidget;
+	if (Node->IsLeaf())
+	{
+		const FDifferenceTreeItem& Item = Items[Node->ItemIndex];
+		const FText Text = Item.Label.IsEmpty() ? FText::FromString(Node->Name) : Item.Label;
+		Content = SNew(STextBlock)
+			.Text(Text)
+			.ToolTipText(Text)
+			.ColorAndOpacity(DiffViewUtils::Differs());
+	}
+	else if (Node->Num() == 0)
+	{
+		Content = SNew(STextBlock)
+			.Text(FText::FromString(Node->Name));
+	}
+	else
+	{
+		Content = SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(Node->Name))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(6.0f, 0.0f, 0.0f, 0.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::Format(LOCTEXT("GroupCount", "({0})"), FText::AsNumber(Node->Num())))
+				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+			];
+	}
+
+	return SNew(STableRow<TSharedPtr<FDifferenceTreeNode>>, OwnerTable)
+		[
+			Content
+		];
+}
+
+void SDifferenceTree::OnGetChildren(TSharedPtr<FDifferenceTreeNode> Node, TArray<TSharedPtr<FDifferenceTreeNode>>& OutChildren)
+{
+	if (!Node->IsLeaf())
+	{
+		BuildChildren(*Node);
+		OutChildren = Node->Children;
+	}
+}
+
+void SDifferenceTree::OnSelectionChanged(TSharedPtr<FDifferenceTreeNode> Node, ESelectInfo::Type SelectInfo)
+{
+	if (!Node.IsValid() || bSelectingPosition || Node->Num() == 0)
+	{
+		return;
+	}
+
+	// A group shows its first difference, next then continues inside it
+	CurrentPosition = Node->IsLeaf() ? Node->Begin : Node->Begin - 1;
+	Items[Node->IsLeaf() ? Node->ItemIndex : VisibleItems[Node->Begin]].OnFocused.ExecuteIfBound();
+}
+
+TSharedPtr<SWidget> SDifferenceTree::OnContextMenuOpening()
+{
+	const TArray<TSharedPtr<FDifferenceTreeNode>> SelectedNodes = TreeView->GetSelectedItems();
+	if (SelectedNodes.Num() != 1 || !SelectedNodes[0]->IsLeaf() || !OnItemContextMenuOpening.IsBound())
+	{
+		return nullptr;
+	}
+	return OnItemContextMenuOpening.Execute(Items[SelectedNodes[0]->ItemIndex]);
+}
+
+#undef LOCTEXT_NAMESPACE
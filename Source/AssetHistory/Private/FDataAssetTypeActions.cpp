@@ -1,6 +1,7 @@
 
 #include "FDataAssetTypeActions.h"
 #include "DataAssetDiff.h"
+#include "DataAssetMerge.h"
 #include "ToolMenuSection.h"
 #include "PrimaryAssetEditorToolkit.h"
 
@@ -24,6 +25,15 @@ void FDataAssetTypeActions::PerformAssetDiff(UObject* OldAsset, UObject* NewAsse
 	SDataAssetDiff::CreateDiffWindow(WindowTitle, OldPrimaryAsset, NewPrimaryAsset, OldRevision, NewRevision);
 }
 
+void FDataAssetTypeActions::Merge(UObject* InObject)
+{
+	SDataAssetMerge::MergeConflictedAsset(InObject);
+}
+
+void FDataAssetTypeActions::Merge(UObject* BaseAsset, UObject* RemoteAsset, UObject* LocalAsset, const FOnMergeResolved& ResolutionCallback)
+{
+	SDataAssetMerge::CreateMergeWindow(BaseAsset, LocalAsset, RemoteAsset, ResolutionCallback);
+}
 
 UClass* FDataAssetTypeActions::GetSupportedClass() const
 {
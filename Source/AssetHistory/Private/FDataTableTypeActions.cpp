@@ -0,0 +1,23 @@
+
+#include "FDataTableTypeActions.h"
+#include "DataTableDiff.h"
+#include "Engine/DataTable.h"
+
+#define LOCTEXT_NAMESPACE "DataTableTypeActions"
+
+void FDataTableTypeActions::PerformAssetDiff(UObject* OldAsset, UObject* NewAsset, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision) const
+{
+	const UDataTable* OldTable = CastChecked<UDataTable>(OldAsset);
+	const UDataTable* NewTable = CastChecked<UDataTable>(NewAsset);
+
+	FText WindowTitle = LOCTEXT("NamelessDataTableDiff", "DataTable Diff");
+	// if we're diffing one asset against itself 
+	if (OldAsset->GetName() == NewAsset->GetName())
+	{
+		// identify the assumed single asset in the window's title
+		WindowTitle = FText::Format(LOCTEXT("DataTableDiff", "{0}"), FText::FromString(NewAsset->GetName()));
+	}
+	SDataTableDiff::CreateDiffWindow(WindowTitle, OldTable, NewTable, OldRevision, NewRevision);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,263 @@
+
+#include "GitBatchFetcher.h"
+#include "AssetHistoryMemory.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlRevision.h"
+#include "SourceControlHelpers.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ConfigCacheIni.h"
+#include "HAL/FileManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGitBatchFetcher, Log, All);
+
+/** No output for longer than this means the process hangs, e.g. on an LFS smudge waiting for credentials */
+static constexpr double ReadTimeoutSeconds = 60.0;
+
+FGitBatchProcess::FGitBatchProcess(const FString& GitBinary, const FString& InRepositoryRoot)
+	: RepositoryRoot(InRepositoryRoot)
+{
+	FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite);
+	FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true);
+
+	// --filters runs the smudge filters, so LFS tracked assets come out as content rather than pointers
+	Process = FPlatformProcess::CreateProc(*GitBinary, TEXT("cat-file --batch --filters"), false, true, true, nullptr, 0, *RepositoryRoot, StdOutWrite, StdInRead);
+	if (!Process.IsValid())
+	{
+		UE_LOG(LogGitBatchFetcher, Warning, TEXT("Failed to start %s cat-file in %s"), *GitBinary, *RepositoryRoot);
+	}
+}
+
+FGitBatchProcess::~FGitBatchProcess()
+{
+	if (Process.IsValid())
+	{
+		// Closing stdin ends the batch loop, terminate in case it is stuck in a filter
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+		StdInRead = StdInWrite = nullptr;
+		if (FPlatformProcess::IsProcRunning(Process))
+		{
+			FPlatformProcess::TerminateProc(Process);
+		}
+		FPlatformProcess::CloseProc(Process);
+	}
+
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+	if (StdInRead || StdInWrite)
+	{
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+	}
+}
+
+bool FGitBatchProcess::IsRunning() const
+{
+	return Process.IsValid() && FPlatformProcess::IsProcRunning(const_cast<FProcHandle&>(Process));
+}
+
+bool FGitBatchProcess::ReadObject(const FString& Object, TArray64<uint8>& OutData)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!IsRunning())
+	{
+		return false;
+	}
+
+	const FTCHARToUTF8 Request(*(Object + TEXT("\n")));
+	if (!FPlatformProcess::WritePipe(StdInWrite, reinterpret_cast<const uint8*>(Request.Get()), Request.Length()))
+	{
+		return false;
+	}
+
+	// "<sha> <type> <size>" then the content and a newline, or "<object> missing"
+	FString Header;
+	if (!ReadLine(Header))
+	{
+		return false;
+	}
+
+	TArray<FString> Fields;
+	Header.ParseIntoArrayWS(Fields);
+	int64 Size = 0;
+	if (Fields.Num() != 3 || Fields[1] != TEXT("blob") || !LexTryParseString(Size, *Fields[2]) || Size < 0)
+	{
+		UE_LOG(LogGitBatchFetcher, Verbose, TEXT("%s: %s"), *Object, *Header);
+		return false;
+	}
+
+	TArray64<uint8> Terminator;
+	return ReadBytes(Size, OutData) && ReadBytes(1, Terminator);
+}
+
+bool FGitBatchProcess::ReadLine(FString& OutLine)
+{
+	for (int64 Scanned = 0;; )
+	{
+		for (; BufferOffset + Scanned < Buffer.Num(); ++Scanned)
+		{
+			if (Buffer[BufferOffset + Scanned] == '\n')
+			{
+				OutLine = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Buffer.GetData() + BufferOffset), Scanned).Get(), Scanned);
+				BufferOffset += Scanned + 1;
+				return true;
+			}
+		}
+
+		if (!FillBuffer(Scanned + 1))
+		{
+			return false;
+		}
+	}
+}
+
+bool FGitBatchProcess::ReadBytes(int64 NumBytes, TArray64<uint8>& OutData)
+{
+	if (!FillBuffer(NumBytes))
+	{
+		return false;
+	}
+
+	OutData.Reset(NumBytes);
+	OutData.Append(Buffer.GetData() + BufferOffset, NumBytes);
+	BufferOffset += NumBytes;
+	return true;
+}
+
+bool FGitBatchProcess::FillBuffer(int64 NumBytes)
+{
+	// Drop what was consumed before growing, so the buffer stays around the size of one blob
+	if (BufferOffset > 0 && Buffer.Num() - BufferOffset < NumBytes)
+	{
+		Buffer.RemoveAt(0, BufferOffset, false);
+		BufferOffset = 0;
+	}
+
+	// The timeout is on silence, a large blob streaming in slowly is still an answer
+	double LastReadTime = FPlatformTime::Seconds();
+	TArray<uint8> Chunk;
+	while (Buffer.Num() - BufferOffset < NumBytes)
+	{
+		if (FPlatformProcess::ReadPipeToArray(StdOutRead, Chunk) && Chunk.Num() > 0)
+		{
+			Buffer.Append(Chunk.GetData(), Chunk.Num());
+			LastReadTime = FPlatformTime::Seconds();
+			continue;
+		}
+
+		if (!FPlatformProcess::IsProcRunning(Process) || FPlatformTime::Seconds() - LastReadTime > ReadTimeoutSeconds)
+		{
+			UE_LOG(LogGitBatchFetcher, Warning, TEXT("git cat-file in %s stopped answering"), *RepositoryRoot);
+			FPlatformProcess::TerminateProc(Process);
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
+
+SIZE_T FGitBatchProcess::GetAllocatedSize()
+{
+	FScopeLock ScopeLock(&Lock);
+	return Buffer.GetAllocatedSize() + RepositoryRoot.GetAllocatedSize();
+}
+
+static FCriticalSection ProcessesLock;
+static TMap<FString, TSharedPtr<FGitBatchProcess, ESPMode::ThreadSafe>> Processes;
+
+static FString FindRepositoryRoot(const FString& Filename)
+{
+	FString Directory = FPaths::GetPath(FPaths::ConvertRelativePathToFull(Filename));
+	while (!Directory.IsEmpty())
+	{
+		// .git is a directory in a clone and a file in a worktree or submodule
+		const FString GitPath = Directory / TEXT(".git");
+		if (IFileManager::Get().DirectoryExists(*GitPath) || IFileManager::Get().FileExists(*GitPath))
+		{
+			return Directory;
+		}
+
+		const FString Parent = FPaths::GetPath(Directory);
+		if (Parent == Directory)
+		{
+			break;
+		}
+		Directory = Parent;
+	}
+	return FString();
+}
+
+static FString GetGitBinary()
+{
+	// Same setting the Git provider uses, otherwise git from the PATH
+	FString BinaryPath;
+	if (GConfig && GConfig->GetString(TEXT("GitSourceControl.GitSourceControlSettings"), TEXT("BinaryPath"), BinaryPath, SourceControlHelpers::GetSettingsIni()) && !BinaryPath.IsEmpty())
+	{
+		return BinaryPath;
+	}
+	return TEXT("git");
+}
+
+bool GitBatchFetcher::IsAvailable()
+{
+	return ISourceControlModule::Get().IsEnabled() && ISourceControlModule::Get().GetProvider().GetName() == FName(TEXT("Git"));
+}
+
+bool GitBatchFetcher::FetchRevision(const ISourceControlRevision& Revision, TArray64<uint8>& OutData)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_SourceControl);
+
+	if (!IsAvailable())
+	{
+		return false;
+	}
+
+	const FString Filename = FPaths::ConvertRelativePathToFull(Revision.GetFilename());
+	const FString RepositoryRoot = FindRepositoryRoot(Filename);
+	FString RelativePath = Filename;
+	if (RepositoryRoot.IsEmpty() || !RelativePath.RemoveFromStart(RepositoryRoot / TEXT("")))
+	{
+		return false;
+	}
+
+	TSharedPtr<FGitBatchProcess, ESPMode::ThreadSafe> Process;
+	{
+		FScopeLock ScopeLock(&ProcessesLock);
+		TSharedPtr<FGitBatchProcess, ESPMode::ThreadSafe>& CachedProcess = Processes.FindOrAdd(RepositoryRoot);
+		if (!CachedProcess.IsValid() || !CachedProcess->IsRunning())
+		{
+			CachedProcess = MakeShared<FGitBatchProcess, ESPMode::ThreadSafe>(GetGitBinary(), RepositoryRoot);
+		}
+		Process = CachedProcess;
+	}
+
+	if (!Process->ReadObject(FString::Printf(TEXT("%s:%s"), *Revision.GetRevision(), *RelativePath), OutData))
+	{
+		return false;
+	}
+
+	// An LFS pointer means the smudge filter isn't installed, the provider knows how to get the real file
+	static const ANSICHAR LfsPointerPrefix[] = "version https://git-lfs";
+	const int64 PrefixLength = UE_ARRAY_COUNT(LfsPointerPrefix) - 1;
+	if (OutData.Num() >= PrefixLength && FMemory::Memcmp(OutData.GetData(), LfsPointerPrefix, PrefixLength) == 0)
+	{
+		OutData.Reset();
+		return false;
+	}
+	return true;
+}
+
+SIZE_T GitBatchFetcher::GetAllocatedSize()
+{
+	FScopeLock ScopeLock(&ProcessesLock);
+	SIZE_T Size = Processes.GetAllocatedSize();
+	for (const TPair<FString, TSharedPtr<FGitBatchProcess, ESPMode::ThreadSafe>>& Process : Processes)
+	{
+		Size += Process.Key.GetAllocatedSize() + (Process.Value.IsValid() ? Process.Value->GetAllocatedSize() : 0);
+	}
+	return Size;
+}
+
+void GitBatchFetcher::Shutdown()
+{
+	FScopeLock ScopeLock(&ProcessesLock);
+	Processes.Empty();
+}
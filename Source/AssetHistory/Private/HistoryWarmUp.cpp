@@ -0,0 +1,289 @@
+
+#include "HistoryWarmUp.h"
+#include "AssetHistoryMemory.h"
+#include "AssetHistorySettings.h"
+#include "RevisionStore.h"
+#include "SourceControlScheduler.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Misc/PackageName.h"
+#include "Editor.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHistoryWarmUp, Log, All);
+
+/** Seconds between two scans of the sources once the queue ran dry */
+static constexpr double RescanInterval = 60.0;
+/** Assets taken from the selected Content Browser folder */
+static constexpr int32 MaxFolderAssets = 64;
+
+FHistoryWarmUp::~FHistoryWarmUp()
+{
+	if (GEditor && AssetOpenedHandle.IsValid())
+	{
+		if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+		{
+			AssetEditorSubsystem->OnAssetOpenedInEditor().Remove(AssetOpenedHandle);
+		}
+	}
+
+	if (InFlightQuery != 0)
+	{
+		FSourceControlScheduler::Get().Cancel(InFlightQuery);
+	}
+}
+
+TStatId FHistoryWarmUp::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FHistoryWarmUp, STATGROUP_Tickables);
+}
+
+void FHistoryWarmUp::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_SourceControl);
+
+	AverageFrameTime = FMath::Lerp(AverageFrameTime, DeltaTime, 0.05f);
+
+	// The subsystem doesn't exist yet when the module starts
+	if (!AssetOpenedHandle.IsValid() && GEditor)
+	{
+		if (UAssetEditorSubsystem* AssetEditorSubsystem = GEditor->GetEditorSubsystem<UAssetEditorSubsystem>())
+		{
+			AssetOpenedHandle = AssetEditorSubsystem->OnAssetOpenedInEditor().AddSP(this, &FHistoryWarmUp::OnAssetOpened);
+		}
+	}
+
+	const UAssetHistorySettings* Settings = GetDefault<UAssetHistorySettings>();
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (!Settings->bEnableWarmUp || !SourceControlModule.IsEnabled() || !SourceControlModule.GetProvider().IsAvailable())
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double TokensPerSecond = Settings->MaxRequestsPerMinute / 60.0;
+	Tokens = FMath::Min(Tokens + (Now - LastTokenTime) * TokensPerSecond, FMath::Max(1.0, TokensPerSecond * 5.0));
+	LastTokenTime = Now;
+
+	if (Tokens < 1.0 || InFlightQuery != 0 || bRevisionDownloadInFlight || IsEditorBusy())
+	{
+		return;
+	}
+
+	if (PendingRevisions.Num() > 0)
+	{
+		Tokens -= 1.0;
+		StartRevisionDownload();
+		return;
+	}
+
+	if (PendingFiles.Num() == 0 && Now >= NextRescanTime)
+	{
+		NextRescanTime = Now + RescanInterval;
+		RefillQueue();
+	}
+
+	if (PendingFiles.Num() > 0)
+	{
+		Tokens -= 1.0;
+		StartHistoryQuery();
+	}
+}
+
+void FHistoryWarmUp::OnAssetOpened(UObject* Asset, IAssetEditorInstance* EditorInstance)
+{
+	if (!Asset || !Asset->GetOutermost())
+	{
+		return;
+	}
+
+	const FString PackageName = Asset->GetOutermost()->GetName();
+	UAssetHistorySettings* Settings = GetMutableDefault<UAssetHistorySettings>();
+	// Reopening the most recent asset leaves the list as it is, the config file is only written when it changes
+	if (Settings->RecentAssets.Num() == 0 || Settings->RecentAssets[0] != PackageName)
+	{
+		Settings->RecentAssets.Remove(PackageName);
+		Settings->RecentAssets.Insert(PackageName, 0);
+		Settings->RecentAssets.SetNum(FMath::Min(Settings->RecentAssets.Num(), UAssetHistorySettings::MaxRecentAssets));
+		Settings->SaveConfig();
+	}
+
+	EnqueueFile(SourceControlHelpers::PackageFilename(PackageName), true);
+}
+
+bool FHistoryWarmUp::IsEditorBusy() const
+{
+	if (GEditor && GEditor->PlayWorld)
+	{
+		return true;
+	}
+
+	const UAssetHistorySettings* Settings = GetDefault<UAssetHistorySettings>();
+	if (AverageFrameTime * 1000.0f > Settings->MaxFrameTimeMs)
+	{
+		return true;
+	}
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication& SlateApplication = FSlateApplication::Get();
+		if (SlateApplication.GetActiveModalWindow().IsValid()
+			|| FPlatformTime::Seconds() - SlateApplication.GetLastUserInteractionTime() < Settings->IdleSeconds)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FHistoryWarmUp::RefillQueue()
+{
+	const UAssetHistorySettings* Settings = GetDefault<UAssetHistorySettings>();
+	for (const FString& PackageName : Settings->RecentAssets)
+	{
+		if (FPackageName::IsValidLongPackageName(PackageName))
+		{
+			EnqueueFile(SourceControlHelpers::PackageFilename(PackageName), false);
+		}
+	}
+
+	// Checked out in a changelist for Perforce, locally modified for Git
+	const TArray<FSourceControlStateRef> OpenStates = ISourceControlModule::Get().GetProvider().GetCachedStateByPredicate([](const FSourceControlStateRef& State)
+		{
+			return State->IsCheckedOut() || State->IsModified();
+		});
+	for (const FSourceControlStateRef& State : OpenStates)
+	{
+		if (FPackageName::IsPackageFilename(State->GetFilename()))
+		{
+			EnqueueFile(State->GetFilename(), false);
+		}
+	}
+
+	if (FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>("ContentBrowser"))
+	{
+		TArray<FString> Folders;
+		ContentBrowserModule->Get().GetSelectedPathViewFolders(Folders);
+
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		int32 NumFolderAssets = 0;
+		for (FString Folder : Folders)
+		{
+			// Virtual paths carry an /All prefix when the browser shows all folders
+			Folder.RemoveFromStart(TEXT("/All"), ESearchCase::CaseSensitive);
+
+			TArray<FAssetData> Assets;
+			AssetRegistry.GetAssetsByPath(FName(*Folder), Assets, false);
+			for (const FAssetData& Asset : Assets)
+			{
+				if (NumFolderAssets++ >= MaxFolderAssets)
+				{
+					break;
+				}
+				EnqueueFile(SourceControlHelpers::PackageFilename(Asset.PackageName.ToString()), false);
+			}
+		}
+	}
+
+	UE_LOG(LogHistoryWarmUp, Verbose, TEXT("%d files to warm up"), PendingFiles.Num());
+}
+
+void FHistoryWarmUp::EnqueueFile(const FString& Filename, bool bInFront)
+{
+	const double RefreshSeconds = GetDefault<UAssetHistorySettings>()->RefreshMinutes * 60.0;
+	if (const double* LastWarmedTime = LastWarmedTimes.Find(Filename))
+	{
+		if (FPlatformTime::Seconds() - *LastWarmedTime < RefreshSeconds)
+		{
+			return;
+		}
+	}
+
+	if (bInFront)
+	{
+		PendingFiles.Remove(Filename);
+		PendingFiles.Insert(Filename, 0);
+	}
+	else
+	{
+		PendingFiles.AddUnique(Filename);
+	}
+}
+
+void FHistoryWarmUp::StartHistoryQuery()
+{
+	const int32 BatchSize = FMath::Min(GetDefault<UAssetHistorySettings>()->HistoryBatchSize, PendingFiles.Num());
+	TArray<FString> Files(PendingFiles.GetData(), BatchSize);
+	PendingFiles.RemoveAt(0, BatchSize);
+
+	TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+	UpdateStatusOp->SetUpdateHistory(true);
+	InFlightQuery = FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, Files, ESourceControlJobPriority::Background,
+		FSourceControlOperationComplete::CreateSP(this, &FHistoryWarmUp::OnHistoryQueryComplete, Files));
+
+	// A provider that refuses the query completes it before QueueOperation returns
+	if (!FSourceControlScheduler::Get().IsActive(InFlightQuery))
+	{
+		InFlightQuery = 0;
+	}
+}
+
+void FHistoryWarmUp::OnHistoryQueryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult, TArray<FString> Files)
+{
+	InFlightQuery = 0;
+
+	// Failures are not retried before the refresh period either, a broken file must not eat the whole budget
+	const double Now = FPlatformTime::Seconds();
+	for (const FString& Filename : Files)
+	{
+		LastWarmedTimes.Add(Filename, Now);
+	}
+
+	const UAssetHistorySettings* Settings = GetDefault<UAssetHistorySettings>();
+	if (InResult != ECommandResult::Succeeded || !Settings->bWarmUpRevisionFiles)
+	{
+		return;
+	}
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	for (const FString& Filename : Files)
+	{
+		FSourceControlStatePtr State = SourceControlProvider.GetState(Filename, EStateCacheUsage::Use);
+		if (!State.IsValid())
+		{
+			continue;
+		}
+
+		const int32 NumRevisions = FMath::Min(State->GetHistorySize(), Settings->RevisionFilesPerAsset);
+		for (int32 HistoryIndex = 0; HistoryIndex < NumRevisions; ++HistoryIndex)
+		{
+			TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = State->GetHistoryItem(HistoryIndex);
+			if (Revision.IsValid() && !FRevisionStore::Get().Contains(Revision->GetFilename(), Revision->GetRevision()))
+			{
+				PendingRevisions.Add(Revision);
+			}
+		}
+	}
+}
+
+void FHistoryWarmUp::StartRevisionDownload()
+{
+	TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = PendingRevisions[0];
+	PendingRevisions.RemoveAt(0);
+
+	bRevisionDownloadInFlight = true;
+	TSharedRef<FHistoryWarmUp> This = AsShared();
+	FSourceControlScheduler::Get().QueueRevisionData(Revision, ESourceControlJobPriority::Background, FOnRevisionDataReady::CreateLambda([This, Revision](bool bSuccess, const TArray64<uint8>& Data)
+		{
+			if (!bSuccess)
+			{
+				UE_LOG(LogHistoryWarmUp, Verbose, TEXT("Failed to warm up revision %s of %s"), *Revision->GetRevision(), *Revision->GetFilename());
+			}
+			This->bRevisionDownloadInFlight = false;
+		}));
+}
@@ -0,0 +1,340 @@
+
+#include "LocalSnapshotStore.h"
+#include "AssetHistoryMemory.h"
+#include "RevisionStore.h"
+#include "AssetHistorySettings.h"
+#include "Engine/DataAsset.h"
+#include "Engine/DataTable.h"
+#include "Engine/CurveTable.h"
+#include "UObject/Package.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Async/Async.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLocalSnapshotStore, Log, All);
+
+static const uint32 LocalSnapshotMagic = 0x4c485341;
+static const int32 LocalSnapshotVersion = 1;
+/** Past this many deltas a new snapshot is taken, even if the deltas stay small */
+static constexpr int32 MaxDeltasPerSnapshot = 16;
+
+static FString GetStoreRoot()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AssetHistory") / TEXT("Local");
+}
+
+FLocalSnapshotStore& FLocalSnapshotStore::Get()
+{
+	static FLocalSnapshotStore Store;
+	return Store;
+}
+
+void FLocalSnapshotStore::Initialize()
+{
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FLocalSnapshotStore::OnPackageSaved);
+}
+
+void FLocalSnapshotStore::Shutdown()
+{
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+	PackageSavedHandle.Reset();
+}
+
+FString FLocalSnapshotStore::GetRevisionName(int32 Id)
+{
+	return FString::Printf(TEXT("Local %d"), Id);
+}
+
+void FLocalSnapshotStore::OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext)
+{
+	if (!GetDefault<UAssetHistorySettings>()->bEnableLocalSnapshots || !Package
+		|| SaveContext.IsProceduralSave() || (SaveContext.GetSaveFlags() & SAVE_FromAutosave) != 0)
+	{
+		return;
+	}
+
+	// Only the assets that have a History menu
+	const UObject* Asset = FindObject<UObject>(Package, *FPackageName::GetShortName(Package));
+	if (!Asset || !(Asset->IsA<UPrimaryDataAsset>() || Asset->IsA<UDataTable>() || Asset->IsA<UCurveTable>()))
+	{
+		return;
+	}
+
+	// Reading, encoding and writing stay off the save. One task per package at a time, so snapshots are added in save order
+	const FString Filename = FPaths::ConvertRelativePathToFull(PackageFilename);
+	bool bStartTask = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		bStartTask = !PendingSaves.Contains(Filename);
+		PendingSaves.Add(Filename, FDateTime::Now());
+	}
+	if (bStartTask)
+	{
+		Async(EAsyncExecution::ThreadPool, [Filename]()
+			{
+				FLocalSnapshotStore::Get().TakePendingSnapshots(Filename);
+			});
+	}
+}
+
+void FLocalSnapshotStore::TakePendingSnapshots(const FString& PackageFilename)
+{
+	for (;;)
+	{
+		FDateTime Date;
+		{
+			FScopeLock ScopeLock(&Lock);
+			TOptional<FDateTime>& Pending = PendingSaves.FindChecked(PackageFilename);
+			if (!Pending.IsSet())
+			{
+				PendingSaves.Remove(PackageFilename);
+				return;
+			}
+			Date = Pending.GetValue();
+			Pending.Reset();
+		}
+
+		// Saves made while this one was read are only snapshotted once, the file holds the latest of them
+		TArray64<uint8> Data;
+		if (FFileHelper::LoadFileToArray(Data, *PackageFilename, FILEREAD_Silent))
+		{
+			AddSnapshot(PackageFilename, Data, Date);
+		}
+	}
+}
+
+bool FLocalSnapshotStore::AddSnapshot(const FString& PackageFilename, TArrayView64<const uint8> Data, const FDateTime& Date)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	const uint64 Hash = CityHash64(reinterpret_cast<const char*>(Data.GetData()), Data.Num());
+
+	FScopeLock ScopeLock(&Lock);
+	FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+	const FEntry* LastEntry = nullptr;
+	for (int32 EntryIndex = Index.Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		if (!Index.Entries[EntryIndex].bEvicted)
+		{
+			LastEntry = &Index.Entries[EntryIndex];
+			break;
+		}
+	}
+	if (LastEntry && LastEntry->Hash == Hash && LastEntry->RawSize == Data.Num())
+	{
+		return true;
+	}
+
+	// Same scheme as the revision store: deltas against the latest snapshot until they grow too large or too many
+	FEntry Entry;
+	Entry.Id = Index.NextId;
+	Entry.Date = Date;
+	Entry.Hash = Hash;
+	Entry.RawSize = Data.Num();
+
+	TArray64<uint8> Delta;
+	const int32 SnapshotIndex = Index.Entries.FindLastByPredicate([](const FEntry& Candidate) { return Candidate.BaseId == INDEX_NONE; });
+	if (SnapshotIndex != INDEX_NONE)
+	{
+		const FEntry& Snapshot = Index.Entries[SnapshotIndex];
+		const int32 NumDeltas = Index.Entries.FilterByPredicate([&Snapshot](const FEntry& Candidate) { return Candidate.BaseId == Snapshot.Id; }).Num();
+		const FString SnapshotFilename = GetEntryFilename(Index, Snapshot);
+		if (NumDeltas < MaxDeltasPerSnapshot && CachedSnapshotFilename != SnapshotFilename)
+		{
+			CachedSnapshotFilename = ReadEntry(Index, Snapshot, CachedSnapshot) ? SnapshotFilename : FString();
+		}
+		if (NumDeltas < MaxDeltasPerSnapshot && CachedSnapshotFilename == SnapshotFilename)
+		{
+			RevisionDelta::Encode(CachedSnapshot, Data, Delta);
+			if (Delta.Num() <= Data.Num() / 4)
+			{
+				Entry.BaseId = Snapshot.Id;
+			}
+		}
+	}
+
+	const FString EntryFilename = GetEntryFilename(Index, Entry);
+	if (!RevisionStoreFile::WriteCompressed(EntryFilename, Entry.BaseId == INDEX_NONE ? Data : TArrayView64<const uint8>(Delta), Entry.StoredSize))
+	{
+		UE_LOG(LogLocalSnapshotStore, Warning, TEXT("Failed to store a snapshot of %s"), *PackageFilename);
+		return false;
+	}
+
+	if (Entry.BaseId == INDEX_NONE)
+	{
+		CachedSnapshotFilename = EntryFilename;
+		CachedSnapshot = TArray64<uint8>(Data.GetData(), Data.Num());
+	}
+
+	++Index.NextId;
+	Index.Entries.Add(Entry);
+	Trim(Index);
+	SaveIndex(Index);
+	return true;
+}
+
+void FLocalSnapshotStore::GetSnapshots(const FString& PackageFilename, TArray<FLocalSnapshot>& OutSnapshots)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	OutSnapshots.Reset();
+
+	FScopeLock ScopeLock(&Lock);
+	const FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+	for (int32 EntryIndex = Index.Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		const FEntry& Entry = Index.Entries[EntryIndex];
+		if (!Entry.bEvicted)
+		{
+			FLocalSnapshot& Snapshot = OutSnapshots.AddDefaulted_GetRef();
+			Snapshot.Id = Entry.Id;
+			Snapshot.Date = Entry.Date;
+			Snapshot.Size = Entry.RawSize;
+		}
+	}
+}
+
+bool FLocalSnapshotStore::ReadSnapshot(const FString& PackageFilename, int32 Id, TArray64<uint8>& OutData)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	FScopeLock ScopeLock(&Lock);
+	const FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+	const FEntry* Entry = Index.Entries.FindByPredicate([Id](const FEntry& Candidate) { return Candidate.Id == Id; });
+	return Entry && ReadEntry(Index, *Entry, OutData);
+}
+
+bool FLocalSnapshotStore::GetSnapshotFile(const FString& PackageFilename, int32 Id, FString& OutFilename)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	TArray64<uint8> Data;
+	if (!ReadSnapshot(PackageFilename, Id, Data))
+	{
+		return false;
+	}
+
+	// Named like the revision files, so LoadPackage and the readers treat it the same way
+	return RevisionStoreFile::WriteTempPackage(PackageFilename, FString::Printf(TEXT("Local%d"), Id), Data, OutFilename);
+}
+
+bool FLocalSnapshotStore::ReadEntry(const FFileIndex& Index, const FEntry& Entry, TArray64<uint8>& OutData)
+{
+	if (Entry.BaseId == INDEX_NONE)
+	{
+		return RevisionStoreFile::ReadCompressed(GetEntryFilename(Index, Entry), OutData);
+	}
+
+	const FEntry* Snapshot = Index.Entries.FindByPredicate([&Entry](const FEntry& Candidate) { return Candidate.Id == Entry.BaseId; });
+	TArray64<uint8> SnapshotData;
+	TArray64<uint8> Delta;
+	if (!Snapshot
+		|| !RevisionStoreFile::ReadCompressed(GetEntryFilename(Index, *Snapshot), SnapshotData)
+		|| !RevisionStoreFile::ReadCompressed(GetEntryFilename(Index, Entry), Delta)
+		|| !RevisionDelta::Apply(SnapshotData, Delta, OutData))
+	{
+		UE_LOG(LogLocalSnapshotStore, Warning, TEXT("Failed to rebuild snapshot %d in %s"), Entry.Id, *Index.Directory);
+		return false;
+	}
+	return true;
+}
+
+void FLocalSnapshotStore::Trim(FFileIndex& Index)
+{
+	const int32 MaxSnapshots = FMath::Max(1, GetDefault<UAssetHistorySettings>()->MaxLocalSnapshots);
+	int32 NumListed = Index.Entries.FilterByPredicate([](const FEntry& Entry) { return !Entry.bEvicted; }).Num();
+	for (FEntry& Entry : Index.Entries)
+	{
+		if (NumListed <= MaxSnapshots)
+		{
+			break;
+		}
+		if (!Entry.bEvicted)
+		{
+			Entry.bEvicted = true;
+			--NumListed;
+		}
+	}
+
+	for (int32 EntryIndex = Index.Entries.Num() - 1; EntryIndex >= 0; --EntryIndex)
+	{
+		const FEntry& Entry = Index.Entries[EntryIndex];
+		const bool bNeeded = !Entry.bEvicted || (Entry.BaseId == INDEX_NONE
+			&& Index.Entries.ContainsByPredicate([&Entry](const FEntry& Candidate) { return Candidate.BaseId == Entry.Id; }));
+		if (!bNeeded)
+		{
+			IFileManager::Get().Delete(*GetEntryFilename(Index, Entry), false, false, true);
+			Index.Entries.RemoveAt(EntryIndex);
+		}
+	}
+}
+
+SIZE_T FLocalSnapshotStore::GetAllocatedSize()
+{
+	FScopeLock ScopeLock(&Lock);
+	SIZE_T Size = Indices.GetAllocatedSize() + CachedSnapshotFilename.GetAllocatedSize() + CachedSnapshot.GetAllocatedSize();
+	for (const TPair<FString, FFileIndex>& Index : Indices)
+	{
+		Size += Index.Key.GetAllocatedSize() + Index.Value.Directory.GetAllocatedSize() + Index.Value.Entries.GetAllocatedSize();
+	}
+	return Size;
+}
+
+FLocalSnapshotStore::FFileIndex& FLocalSnapshotStore::FindOrLoadIndex(const FString& PackageFilename)
+{
+	const FString Key = FPaths::ConvertRelativePathToFull(PackageFilename);
+	if (FFileIndex* Index = Indices.Find(Key))
+	{
+		return *Index;
+	}
+
+	FFileIndex& Index = Indices.Add(Key);
+	Index.Directory = GetStoreRoot() / FString::Printf(TEXT("%s_%016llx"), *FPaths::GetBaseFilename(Key), RevisionStoreFile::HashPackagePath(Key));
+
+	TArray<uint8> FileData;
+	if (FFileHelper::LoadFileToArray(FileData, *(Index.Directory / TEXT("Index.bin")), FILEREAD_Silent))
+	{
+		FMemoryReader Reader(FileData);
+		uint32 Magic = 0;
+		int32 Version = 0;
+		Reader << Magic << Version;
+		if (Magic == LocalSnapshotMagic && Version == LocalSnapshotVersion)
+		{
+			Reader << Index.NextId << Index.Entries;
+		}
+		if (Reader.IsError())
+		{
+			Index.NextId = 0;
+			Index.Entries.Reset();
+		}
+	}
+	return Index;
+}
+
+void FLocalSnapshotStore::SaveIndex(const FFileIndex& Index)
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	uint32 Magic = LocalSnapshotMagic;
+	int32 Version = LocalSnapshotVersion;
+	int32 NextId = Index.NextId;
+	Writer << Magic << Version << NextId;
+	Writer << const_cast<TArray<FEntry>&>(Index.Entries);
+
+	// A truncated index would hand out ids that existing files already use
+	if (!RevisionStoreFile::SaveAtomically(FileData, Index.Directory / TEXT("Index.bin")))
+	{
+		UE_LOG(LogLocalSnapshotStore, Warning, TEXT("Failed to save the snapshot index in %s"), *Index.Directory);
+	}
+}
+
+FString FLocalSnapshotStore::GetEntryFilename(const FFileIndex& Index, const FEntry& Entry) const
+{
+	return Index.Directory / FString::Printf(TEXT("%d.%s"), Entry.Id, Entry.BaseId == INDEX_NONE ? TEXT("snap") : TEXT("delta"));
+}
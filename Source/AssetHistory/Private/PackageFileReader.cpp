@@ -0,0 +1,340 @@
+
+#include "PackageFileReader.h"
+#include "Misc/FileHelper.h"
+#include "Hash/CityHash.h"
+#include "UObject/ObjectVersion.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "Misc/ScopeLock.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPackageFileReader, Log, All);
+
+/**
+ * Versions whose property tags have the layout FSerializedPropertyTag reads: struct and property guids (UE4.12),
+ * no tag extension byte yet (UE5 file version 1011). Other packages are left to LoadPackage.
+ */
+static constexpr int32 MinTaggedFileVersionUE4 = VER_UE4_PROPERTY_GUID_IN_PROPERTY_TAG;
+static constexpr int32 MaxTaggedFileVersionUE5 = 1010;
+
+FPackageNameArchive::FPackageNameArchive(TArrayView64<const uint8> InData, const TArray<FName>& InNameMap)
+	: FLargeMemoryReader(InData.GetData(), InData.Num())
+	, NameMap(InNameMap)
+{
+}
+
+FArchive& FPackageNameArchive::operator<<(FName& Name)
+{
+	int32 NameIndex = 0;
+	int32 Number = 0;
+	FArchive& Ar = *this;
+	Ar << NameIndex << Number;
+
+	if (NameMap.IsValidIndex(NameIndex))
+	{
+		Name = FName(NameMap[NameIndex], Number);
+	}
+	else
+	{
+		Name = NAME_None;
+		SetError();
+	}
+	return *this;
+}
+
+void FPackageNameArchive::ApplySummaryVersions(const FPackageFileSummary& Summary)
+{
+	SetUEVer(Summary.GetFileVersionUE());
+	SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+	SetEngineVer(Summary.SavedByEngineVersion);
+	SetCustomVersions(Summary.GetCustomVersionContainer());
+	SetFilterEditorOnly((Summary.GetPackageFlags() & PKG_FilterEditorOnly) != 0);
+}
+
+static uint64 HashName(FName Name, uint64 Hash)
+{
+	const FString NameString = Name.ToString();
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(*NameString), NameString.Len() * sizeof(TCHAR), Hash);
+	const int32 Number = Name.GetNumber();
+	return CityHash64WithSeed(reinterpret_cast<const char*>(&Number), sizeof(Number), Hash);
+}
+
+template<typename ValueType>
+static uint64 HashValue(const ValueType& Value, uint64 Hash)
+{
+	return CityHash64WithSeed(reinterpret_cast<const char*>(&Value), sizeof(ValueType), Hash);
+}
+
+FPackageFileReader::FPackageFileReader() = default;
+
+FPackageFileReader::~FPackageFileReader()
+{
+	// The region has to go before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+bool FPackageFileReader::Open(const FString& InFilename)
+{
+	Filename = InFilename;
+
+	// Mapping lets the OS page in only the header and the exports we actually read
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedHandle.IsValid() && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = TArrayView64<const uint8>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	}
+	else
+	{
+		MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Data = FileData;
+	}
+	return ParseTables();
+}
+
+bool FPackageFileReader::OpenData(const FString& InFilename, TArray64<uint8>&& InData)
+{
+	Filename = InFilename;
+	FileData = MoveTemp(InData);
+	Data = FileData;
+	return ParseTables();
+}
+
+bool FPackageFileReader::ParseTables()
+{
+	TArray<FName> EmptyNameMap;
+	{
+		FPackageNameArchive SummaryAr(Data, EmptyNameMap);
+		SummaryAr << Summary;
+		if (SummaryAr.IsError() || Summary.Tag != PACKAGE_FILE_TAG)
+		{
+			UE_LOG(LogPackageFileReader, Verbose, TEXT("%s is not a package"), *Filename);
+			return false;
+		}
+	}
+
+	// A newer saver may have changed the tag layout, misreading it would give wrong values without any error
+	const FPackageFileVersion FileVersion = Summary.GetFileVersionUE();
+	if (FileVersion.FileVersionUE4 < MinTaggedFileVersionUE4 || FileVersion.FileVersionUE5 > MaxTaggedFileVersionUE5
+		|| FileVersion.FileVersionUE5 > GPackageFileUEVersion.FileVersionUE5)
+	{
+		UE_LOG(LogPackageFileReader, Verbose, TEXT("%s was saved with file version %d/%d, its property tags aren't read"), *Filename, FileVersion.FileVersionUE4, FileVersion.FileVersionUE5);
+		return false;
+	}
+
+	FPackageNameArchive Ar(Data, NameMap);
+	Ar.ApplySummaryVersions(Summary);
+
+	if (Summary.NameCount > 0)
+	{
+		Ar.Seek(Summary.NameOffset);
+		NameMap.Reserve(Summary.NameCount);
+		FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+		for (int32 NameIndex = 0; NameIndex < Summary.NameCount && !Ar.IsError(); ++NameIndex)
+		{
+			Ar << NameEntry;
+			NameMap.Emplace(FName(NameEntry));
+		}
+	}
+
+	if (Summary.ImportCount > 0)
+	{
+		Ar.Seek(Summary.ImportOffset);
+		ImportMap.SetNum(Summary.ImportCount);
+		for (FObjectImport& Import : ImportMap)
+		{
+			Ar << Import;
+		}
+	}
+
+	if (Summary.ExportCount > 0)
+	{
+		Ar.Seek(Summary.ExportOffset);
+		ExportMap.SetNum(Summary.ExportCount);
+		for (FObjectExport& Export : ExportMap)
+		{
+			Ar << Export;
+		}
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogPackageFileReader, Warning, TEXT("Failed to read the header tables of %s"), *Filename);
+		return false;
+	}
+
+	for (const FObjectExport& Export : ExportMap)
+	{
+		if (Export.SerialOffset < 0 || Export.SerialSize < 0 || Export.SerialOffset + Export.SerialSize > Data.Num())
+		{
+			UE_LOG(LogPackageFileReader, Warning, TEXT("%s has an export outside of the file, it is probably split or cooked"), *Filename);
+			return false;
+		}
+	}
+	return true;
+}
+
+TArrayView<const uint8> FPackageFileReader::GetExportData(const FObjectExport& Export) const
+{
+	return TArrayView<const uint8>(Data.GetData() + Export.SerialOffset, (int32)Export.SerialSize);
+}
+
+TUniquePtr<FPackageNameArchive> FPackageFileReader::CreateExportArchive(const FObjectExport& Export) const
+{
+	TArrayView<const uint8> ExportData = GetExportData(Export);
+	TUniquePtr<FPackageNameArchive> Ar = MakeUnique<FPackageNameArchive>(TArrayView64<const uint8>(ExportData.GetData(), ExportData.Num()), NameMap);
+	Ar->ApplySummaryVersions(Summary);
+	return Ar;
+}
+
+int32 FPackageFileReader::FindAssetExportIndex() const
+{
+	const FString AssetName = FPaths::GetBaseFilename(Filename);
+	for (int32 ExportIndex = 0; ExportIndex < ExportMap.Num(); ++ExportIndex)
+	{
+		const FObjectExport& Export = ExportMap[ExportIndex];
+		if (Export.OuterIndex.IsNull() && Export.ObjectName.ToString() == AssetName)
+		{
+			return ExportIndex;
+		}
+	}
+
+	// Temp files from source control carry a revision suffix, fall back to the only public top level export
+	for (int32 ExportIndex = 0; ExportIndex < ExportMap.Num(); ++ExportIndex)
+	{
+		const FObjectExport& Export = ExportMap[ExportIndex];
+		if (Export.OuterIndex.IsNull() && (Export.ObjectFlags & RF_Public) != 0)
+		{
+			return ExportIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+FString FPackageFileReader::GetObjectPath(FPackageIndex Index) const
+{
+	FString Path;
+	// Bounded in case of a corrupt outer chain
+	for (int32 Depth = 0; !Index.IsNull() && Depth < 64; ++Depth)
+	{
+		FName ObjectName;
+		FPackageIndex OuterIndex;
+		if (Index.IsImport() && ImportMap.IsValidIndex(Index.ToImport()))
+		{
+			ObjectName = ImportMap[Index.ToImport()].ObjectName;
+			OuterIndex = ImportMap[Index.ToImport()].OuterIndex;
+		}
+		else if (Index.IsExport() && ExportMap.IsValidIndex(Index.ToExport()))
+		{
+			ObjectName = ExportMap[Index.ToExport()].ObjectName;
+			OuterIndex = ExportMap[Index.ToExport()].OuterIndex;
+		}
+		else
+		{
+			break;
+		}
+
+		const TCHAR* Separator = Path.IsEmpty() ? TEXT("") : (OuterIndex.IsNull() ? TEXT(".") : TEXT(":"));
+		Path = ObjectName.ToString() + Separator + Path;
+		Index = OuterIndex;
+	}
+	return Path;
+}
+
+uint64 FPackageFileReader::GetFileHash() const
+{
+	return CityHash64(reinterpret_cast<const char*>(Data.GetData()), Data.Num());
+}
+
+uint64 FPackageFileReader::GetTablesHash() const
+{
+	// Export data refers to names and objects by index, so the tables are hashed by value in order
+	uint64 Hash = HashValue(NameMap.Num(), 0);
+	for (FName Name : NameMap)
+	{
+		Hash = HashName(Name, Hash);
+	}
+
+	Hash = HashValue(ImportMap.Num(), Hash);
+	for (const FObjectImport& Import : ImportMap)
+	{
+		Hash = HashName(Import.ClassPackage, Hash);
+		Hash = HashName(Import.ClassName, Hash);
+		Hash = HashName(Import.ObjectName, Hash);
+		Hash = HashValue(Import.OuterIndex.ForDebugging(), Hash);
+	}
+
+	Hash = HashValue(ExportMap.Num(), Hash);
+	for (const FObjectExport& Export : ExportMap)
+	{
+		Hash = HashName(Export.ObjectName, Hash);
+		Hash = HashValue(Export.OuterIndex.ForDebugging(), Hash);
+	}
+	return Hash;
+}
+
+uint64 FPackageFileReader::GetContentHash() const
+{
+	uint64 Hash = GetTablesHash();
+	for (const FObjectExport& Export : ExportMap)
+	{
+		Hash = HashValue(Export.ClassIndex.ForDebugging(), Hash);
+		Hash = HashValue(Export.SuperIndex.ForDebugging(), Hash);
+		Hash = HashValue(Export.TemplateIndex.ForDebugging(), Hash);
+		Hash = HashValue(Export.ObjectFlags, Hash);
+		Hash = HashValue(Export.SerialSize, Hash);
+
+		TArrayView<const uint8> ExportData = GetExportData(Export);
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(ExportData.GetData()), ExportData.Num(), Hash);
+	}
+	return Hash;
+}
+
+bool PackageContent::AreContentsIdentical(const FString& FilenameA, const FString& FilenameB)
+{
+	if (FilenameA.IsEmpty() || FilenameB.IsEmpty())
+	{
+		return false;
+	}
+
+	FPackageFileReader ReaderA;
+	FPackageFileReader ReaderB;
+	if (!ReaderA.Open(FilenameA) || !ReaderB.Open(FilenameB))
+	{
+		return false;
+	}
+
+	return ReaderA.GetFileHash() == ReaderB.GetFileHash() || ReaderA.GetContentHash() == ReaderB.GetContentHash();
+}
+
+static FCriticalSection IdenticalRevisionsLock;
+static TSet<FString> IdenticalRevisions;
+
+static FString MakeIdenticalKey(const FString& PackageFilename, const FString& RevisionA, const FString& RevisionB)
+{
+	// The pair is unordered
+	return RevisionA < RevisionB
+		? FString::Printf(TEXT("%s|%s|%s"), *PackageFilename, *RevisionA, *RevisionB)
+		: FString::Printf(TEXT("%s|%s|%s"), *PackageFilename, *RevisionB, *RevisionA);
+}
+
+void PackageContent::MarkIdentical(const FString& PackageFilename, const FString& RevisionA, const FString& RevisionB)
+{
+	FScopeLock Lock(&IdenticalRevisionsLock);
+	IdenticalRevisions.Add(MakeIdenticalKey(PackageFilename, RevisionA, RevisionB));
+}
+
+bool PackageContent::IsKnownIdentical(const FString& PackageFilename, const FString& RevisionA, const FString& RevisionB)
+{
+	FScopeLock Lock(&IdenticalRevisionsLock);
+	return IdenticalRevisions.Contains(MakeIdenticalKey(PackageFilename, RevisionA, RevisionB));
+}
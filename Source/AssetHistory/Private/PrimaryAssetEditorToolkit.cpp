@@ -1,5 +1,6 @@
 
 #include "PrimaryAssetEditorToolkit.h"
+#include "AssetHistoryMemory.h"
 #include "Widgets/SWidget.h"
 #include "Widgets/Images/SThrobber.h"
 #include "ISourceControlModule.h"
@@ -8,10 +9,162 @@
 #include "Misc/MessageDialog.h"
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/Images/SSpinningImage.h"
+#include "CurveDiff.h"
+#include "PackageFileReader.h"
+#include "TaggedPropertyReader.h"
+#include "SourceControlScheduler.h"
+#include "LocalSnapshotStore.h"
+#include "AssetHistorySettings.h"
+#include "RevisionBisect.h"
+#include "ChurnStatistics.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "SipherSkillDataAssetTypeActions"
 
-static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo, const FRevisionInfoExtended& RevisionInfo, UPrimaryDataAsset* InCurrentAsset);
+static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo, const FRevisionInfoExtended& RevisionInfo, UObject* InCurrentAsset);
+static void OnDiffLocalSnapshotPicked(int32 OldId, int32 NewId, TWeakObjectPtr<UObject> WeakCurrentAsset);
+static void DiffLoadedAssets(UObject* PreviousAsset, UObject* Asset, const FRevisionInfo& OldRevision, const FRevisionInfo& CurrentRevision);
+
+void AssetHistoryToolbar::AddHistoryButton(FToolBarBuilder& ToolbarBuilder, FOnGetContent OnGetMenuContent)
+{
+	ToolbarBuilder.BeginSection("SourceControl");
+	ToolbarBuilder.AddComboButton(FUIAction(), OnGetMenuContent,
+		LOCTEXT("Diff", "History"),
+		LOCTEXT("BlueprintEditorDiffToolTip", "Diff against previous revisions"),
+		FSlateIcon(FAppStyle::Get().GetStyleSetName(), "BlueprintDiff.ToolbarIcon"));
+
+	ToolbarBuilder.EndSection();
+}
+
+TSharedRef<SWidget> AssetHistoryToolbar::MakeHistoryMenu(UObject* Object, TSharedPtr<SRevisionMenu>& InOutRevisionPicker)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Menus);
+
+	if (!Object)
+	{
+		// if BlueprintObj is null then this means that multiple blueprints are selected
+		FMenuBuilder MenuBuilder(true, NULL);
+		MenuBuilder.AddMenuEntry(LOCTEXT("NoRevisionsForMultipleBlueprints", "Invalid object"),
+			FText(), FSlateIcon(), FUIAction());
+		return MenuBuilder.MakeWidget();
+	}
+
+	TSharedPtr<SWidget> SourceControlMenu;
+	TSharedRef<SWidget> BisectMenu = SNullWidget::NullWidget;
+	if (ISourceControlModule::Get().IsEnabled() && ISourceControlModule::Get().GetProvider().IsAvailable())
+	{
+		const FString PackageFilename = SourceControlHelpers::PackageFilename(Object->GetPathName());
+		const UClass* AssetClass = Object->GetClass();
+		FMenuBuilder BisectMenuBuilder(true, NULL);
+		BisectMenuBuilder.AddMenuEntry(LOCTEXT("BisectProperty", "Find When a Property Changed..."),
+			LOCTEXT("BisectPropertyTooltip", "Bisect the history for the first revision where a property satisfies a condition"), FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([PackageFilename, AssetClass]()
+				{
+					SRevisionBisect::CreateBisectWindow(PackageFilename, AssetClass, FString());
+				})));
+		BisectMenu = BisectMenuBuilder.MakeWidget();
+
+		if (InOutRevisionPicker.IsValid())
+		{
+			SourceControlMenu = InOutRevisionPicker;
+		}
+		else
+		{
+			// Add our async SCC task widget
+			SourceControlMenu = SAssignNew(InOutRevisionPicker, SRevisionMenu, Object)
+				.OnRevisionSelected_Static(&OnDiffRevisionPicked, Object);
+		}
+	}
+	else
+	{
+		FMenuBuilder MenuBuilder(true, NULL);
+		MenuBuilder.AddMenuEntry(LOCTEXT("SourceControlDisabled", "Source control is disabled"),
+			FText(), FSlateIcon(), FUIAction());
+		SourceControlMenu = MenuBuilder.MakeWidget();
+	}
+
+	return SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			MakeLocalHistoryMenu(Object)
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			BisectMenu
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SourceControlMenu.ToSharedRef()
+		];
+}
+
+TSharedRef<SWidget> AssetHistoryToolbar::MakeLocalHistoryMenu(UObject* Object)
+{
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(Object->GetPathName());
+	TArray<FLocalSnapshot> Snapshots;
+	FLocalSnapshotStore::Get().GetSnapshots(PackageFilename, Snapshots);
+
+	FMenuBuilder MenuBuilder(true, NULL);
+	MenuBuilder.BeginSection("LocalSnapshots", LOCTEXT("LocalSnapshotsHeading", "Local Snapshots"));
+	if (Snapshots.Num() == 0)
+	{
+		MenuBuilder.AddMenuEntry(LOCTEXT("NoLocalSnapshots", "No local snapshots yet, one is taken on every save"),
+			FText(), FSlateIcon(), FUIAction());
+	}
+
+	TWeakObjectPtr<UObject> WeakObject = Object;
+	for (const FLocalSnapshot& Snapshot : Snapshots)
+	{
+		const FText Label = FText::Format(LOCTEXT("LocalSnapshotLabel", "{0}  {1}"), FText::AsDateTime(Snapshot.Date), FText::AsMemory(Snapshot.Size));
+		const int32 SnapshotId = Snapshot.Id;
+		MenuBuilder.AddSubMenu(Label, LOCTEXT("LocalSnapshotTooltip", "Diff this save against the current state or another save"),
+			FNewMenuDelegate::CreateLambda([Snapshots, SnapshotId, WeakObject](FMenuBuilder& SubMenuBuilder)
+				{
+					SubMenuBuilder.AddMenuEntry(LOCTEXT("DiffSnapshotAgainstCurrent", "Against current"), FText(), FSlateIcon(),
+						FUIAction(FExecuteAction::CreateStatic(&OnDiffLocalSnapshotPicked, SnapshotId, int32(INDEX_NONE), WeakObject)));
+					SubMenuBuilder.AddMenuSeparator();
+					for (const FLocalSnapshot& Other : Snapshots)
+					{
+						if (Other.Id != SnapshotId)
+						{
+							SubMenuBuilder.AddMenuEntry(FText::Format(LOCTEXT("DiffSnapshotAgainstOther", "Against {0}"), FText::AsDateTime(Other.Date)), FText(), FSlateIcon(),
+								FUIAction(FExecuteAction::CreateStatic(&OnDiffLocalSnapshotPicked, FMath::Min(SnapshotId, Other.Id), FMath::Max(SnapshotId, Other.Id), WeakObject)));
+						}
+					}
+				}));
+	}
+	MenuBuilder.EndSection();
+	return MenuBuilder.MakeWidget(nullptr, 300);
+}
+
+TSharedRef<FExtender> AssetHistoryToolbar::MakeToolbarExtender(const TSharedRef<FUICommandList> CommandList, const TArray<UObject*> EditingObjects)
+{
+	TSharedRef<FExtender> ToolbarExtender = MakeShared<FExtender>();
+	if (EditingObjects.Num() != 1)
+	{
+		return ToolbarExtender;
+	}
+
+	TWeakObjectPtr<UObject> WeakObject = EditingObjects[0];
+	ToolbarExtender->AddToolBarExtension(
+		"Asset",
+		EExtensionHook::After,
+		CommandList,
+		FToolBarExtensionDelegate::CreateLambda([WeakObject](FToolBarBuilder& ToolbarBuilder)
+			{
+				AddHistoryButton(ToolbarBuilder, FOnGetContent::CreateLambda([WeakObject]()
+					{
+						// Stock editors don't own a picker, so the menu is rebuilt each time; the history itself stays cached by the provider
+						TSharedPtr<SRevisionMenu> RevisionPicker;
+						return MakeHistoryMenu(WeakObject.Get(), RevisionPicker);
+					}));
+			}));
+	return ToolbarExtender;
+}
 
 TSharedRef<FSimpleAssetEditor> PrimaryAssetEditorToolkit::CreateEditor(const EToolkitMode::Type Mode, const TSharedPtr<IToolkitHost>& InitToolkitHost, const TArray<UObject*>& ObjectsToEdit, FGetDetailsViewObjects GetDetailsViewObjects)
 {
@@ -37,13 +190,7 @@ void PrimaryAssetEditorToolkit::InitEditor(const EToolkitMode::Type Mode, const
 		GetToolkitCommands(),
 		FToolBarExtensionDelegate::CreateLambda([this](FToolBarBuilder& ToolbarBuilder)
 			{
-				ToolbarBuilder.BeginSection("SourceControl");
-				ToolbarBuilder.AddComboButton(FUIAction(), FOnGetContent::CreateRaw(this, &PrimaryAssetEditorToolkit::MakeDiffMenu),
-					LOCTEXT("Diff", "History"),
-					LOCTEXT("BlueprintEditorDiffToolTip", "Diff against previous revisions"),
-					FSlateIcon(FAppStyle::Get().GetStyleSetName(), "BlueprintDiff.ToolbarIcon"));
-
-				ToolbarBuilder.EndSection();
+				AssetHistoryToolbar::AddHistoryButton(ToolbarBuilder, FOnGetContent::CreateRaw(this, &PrimaryAssetEditorToolkit::MakeDiffMenu));
 			}));
 	AddToolbarExtender(ToolbarExtender);
 
@@ -56,30 +203,7 @@ void PrimaryAssetEditorToolkit::InitToolMenuContext(FToolMenuContext& MenuContex
 
 TSharedRef<SWidget> PrimaryAssetEditorToolkit::MakeDiffMenu()
 {
-	if (ISourceControlModule::Get().IsEnabled() && ISourceControlModule::Get().GetProvider().IsAvailable())
-	{
-		if (RevisionPicker.IsValid())
-			return RevisionPicker.ToSharedRef();
-		if (auto Object = Cast<UPrimaryDataAsset>(GetEditingObject()))
-		{
-			// Add our async SCC task widget
-			return SAssignNew(RevisionPicker, SRevisionMenu, Object)
-				.OnRevisionSelected_Static(&OnDiffRevisionPicked, Object);
-		}
-		else
-		{
-			// if BlueprintObj is null then this means that multiple blueprints are selected
-			FMenuBuilder MenuBuilder(true, NULL);
-			MenuBuilder.AddMenuEntry(LOCTEXT("NoRevisionsForMultipleBlueprints", "Invalid object"),
-				FText(), FSlateIcon(), FUIAction());
-			return MenuBuilder.MakeWidget();
-		}
-	}
-
-	FMenuBuilder MenuBuilder(true, NULL);
-	MenuBuilder.AddMenuEntry(LOCTEXT("SourceControlDisabled", "Source control is disabled"),
-		FText(), FSlateIcon(), FUIAction());
-	return MenuBuilder.MakeWidget();
+	return AssetHistoryToolbar::MakeHistoryMenu(Cast<UPrimaryDataAsset>(GetEditingObject()), RevisionPicker);
 }
 
 /**  */
@@ -96,20 +220,22 @@ namespace ESourceControlQueryState
 //------------------------------------------------------------------------------
 SRevisionMenu::~SRevisionMenu()
 {
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::RevisionMenu, -1);
+
 	// cancel any operation if this widget is destroyed while in progress
 	if (SourceControlQueryState == ESourceControlQueryState::QueryInProgress)
 	{
-		ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
-		if (SourceControlQueryOp.IsValid() && SourceControlProvider.CanCancelOperation(SourceControlQueryOp.ToSharedRef()))
-		{
-			SourceControlProvider.CancelOperation(SourceControlQueryOp.ToSharedRef());
-		}
+		FSourceControlScheduler::Get().Cancel(SourceControlQueryJob);
 	}
+	CancelPrefetch();
 }
 
 //------------------------------------------------------------------------------
-void SRevisionMenu::Construct(const FArguments& InArgs, UPrimaryDataAsset const* Blueprint)
+void SRevisionMenu::Construct(const FArguments& InArgs, UObject const* Blueprint)
 {
+	LLM_SCOPE_BYTAG(AssetHistory_Menus);
+	AssetHistoryMemory::TrackWidget(AssetHistoryMemory::EWidget::RevisionMenu, 1);
+
 	OnRevisionSelected = InArgs._OnRevisionSelected;
 
 	SourceControlQueryState = ESourceControlQueryState::NotQueried;
@@ -164,16 +290,21 @@ void SRevisionMenu::Construct(const FArguments& InArgs, UPrimaryDataAsset const*
 		Filename = SourceControlHelpers::PackageFilename(Blueprint->GetPathName());
 
 		// make sure the history info is up to date
-		SourceControlQueryOp = ISourceControlOperation::Create<FUpdateStatus>();
+		TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
 		// get the cached state
 		ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
 		FSourceControlStatePtr SourceControlState = SourceControlProvider.GetState(Filename, EStateCacheUsage::Use);
 		if (SourceControlState->GetHistorySize() == 0)
-			SourceControlQueryOp->SetUpdateHistory(true);
-		SourceControlProvider.Execute(SourceControlQueryOp.ToSharedRef(), Filename, EConcurrency::Asynchronous, FSourceControlOperationComplete::CreateSP(this, &SRevisionMenu::OnSourceControlQueryComplete));
+			UpdateStatusOp->SetUpdateHistory(true);
+		SourceControlQueryJob = FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, { Filename }, ESourceControlJobPriority::Interactive, FSourceControlOperationComplete::CreateSP(this, &SRevisionMenu::OnSourceControlQueryComplete));
 
 		SourceControlQueryState = ESourceControlQueryState::QueryInProgress;
 	}
+
+	if (GetDefault<UAssetHistorySettings>()->bPrefetchHoveredRevisions)
+	{
+		RegisterActiveTimer(0.05f, FWidgetActiveTimerDelegate::CreateSP(this, &SRevisionMenu::UpdatePrefetch));
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -185,18 +316,13 @@ EVisibility SRevisionMenu::GetInProgressVisibility() const
 //------------------------------------------------------------------------------
 EVisibility SRevisionMenu::GetCancelButtonVisibility() const
 {
-	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
-	return SourceControlQueryOp.IsValid() && SourceControlProvider.CanCancelOperation(SourceControlQueryOp.ToSharedRef()) ? EVisibility::Visible : EVisibility::Collapsed;
+	return FSourceControlScheduler::Get().IsActive(SourceControlQueryJob) ? EVisibility::Visible : EVisibility::Collapsed;
 }
 
 //------------------------------------------------------------------------------
 FReply SRevisionMenu::OnCancelButtonClicked() const
 {
-	if (SourceControlQueryOp.IsValid())
-	{
-		ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
-		SourceControlProvider.CancelOperation(SourceControlQueryOp.ToSharedRef());
-	}
+	FSourceControlScheduler::Get().Cancel(SourceControlQueryJob);
 
 	return FReply::Handled();
 }
@@ -204,7 +330,7 @@ FReply SRevisionMenu::OnCancelButtonClicked() const
 //------------------------------------------------------------------------------
 void SRevisionMenu::OnSourceControlQueryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
 {
-	check(SourceControlQueryOp == InOperation);
+	LLM_SCOPE_BYTAG(AssetHistory_Menus);
 
 	// Add pop-out menu for each revision
 	FMenuBuilder MenuBuilder(/*bInShouldCloseWindowAfterMenuSelection =*/false, /*InCommandList =*/NULL);
@@ -214,16 +340,15 @@ void SRevisionMenu::OnSourceControlQueryComplete(const FSourceControlOperationRe
 			{
 				if (SourceControlQueryState == ESourceControlQueryState::QueryInProgress)
 					return;
-				ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
-				SourceControlQueryOp = ISourceControlOperation::Create<FUpdateStatus>();
-				SourceControlQueryOp->SetUpdateHistory(true);
+				TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+				UpdateStatusOp->SetUpdateHistory(true);
 				if (MenuBox->IsValidSlotIndex(3))
 				{
 					auto& MenuSlot = MenuBox->GetSlot(3);
 					MenuBox->RemoveSlot(MenuSlot.GetWidget());
 				}
 				SourceControlQueryState = ESourceControlQueryState::QueryInProgress;
-				SourceControlProvider.Execute(SourceControlQueryOp.ToSharedRef(), Filename, EConcurrency::Asynchronous, FSourceControlOperationComplete::CreateSP(this, &SRevisionMenu::OnUpdateHistoryComplete));
+				SourceControlQueryJob = FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, { Filename }, ESourceControlJobPriority::Interactive, FSourceControlOperationComplete::CreateSP(this, &SRevisionMenu::OnUpdateHistoryComplete));
 			})));
 	MenuBuilder.EndSection();
 
@@ -249,7 +374,12 @@ void SRevisionMenu::OnSourceControlQueryComplete(const FSourceControlOperationRe
 
 void SRevisionMenu::OnUpdateHistoryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
 {
+	LLM_SCOPE_BYTAG(AssetHistory_Menus);
+
 	FMenuBuilder MenuBuilder(/*bInShouldCloseWindowAfterMenuSelection =*/true, /*InCommandList =*/NULL);
+	CancelPrefetch();
+	PrefetchEntries.Reset();
+	PrefetchCandidate = INDEX_NONE;
 
 	if (InResult == ECommandResult::Succeeded)
 	{
@@ -276,8 +406,11 @@ void SRevisionMenu::OnUpdateHistoryComplete(const FSourceControlOperationRef& In
 				{
 					OnRevisionSelectedDelegate.ExecuteIfBound(Prev, LocalRevision);
 				};
-				MenuBuilder.AddMenuEntry(LOCTEXT("RevisionNumber", "Local"), LOCTEXT("RevisionNumber", "Diff local changes"), FSlateIcon(),
-					FUIAction(FExecuteAction::CreateLambda(OnItemLocalSelected)));
+				TSharedRef<SWidget> EntryContents = SNew(STextBlock)
+					.TextStyle(FEditorStyle::Get(), "Menu.Label")
+					.Text(LOCTEXT("RevisionNumber", "Local"));
+				PrefetchEntries.Add({ EntryContents, Prev, LocalRevision });
+				MenuBuilder.AddMenuEntry(FUIAction(FExecuteAction::CreateLambda(OnItemLocalSelected)), EntryContents, NAME_None, LOCTEXT("RevisionNumber", "Diff local changes"));
 			}
 			for (int32 HistoryIndex = 0; HistoryIndex < SourceControlState->GetHistorySize(); HistoryIndex++)
 			{
@@ -286,8 +419,6 @@ void SRevisionMenu::OnUpdateHistoryComplete(const FSourceControlOperationRef& In
 				{
 					FInternationalization& I18N = FInternationalization::Get();
 
-					FText Label = FText::Format(LOCTEXT("RevisionNumber", "{0}"), FText::FromString(Revision->GetRevision()));
-
 					FFormatNamedArguments Args;
 					Args.Add(TEXT("CheckInNumber"), FText::AsNumber(Revision->GetCheckInIdentifier(), NULL, I18N.GetInvariantCulture()));
 					Args.Add(TEXT("Revision"), FText::FromString(Revision->GetRevision()));
@@ -324,14 +455,30 @@ void SRevisionMenu::OnUpdateHistoryComplete(const FSourceControlOperationRef& In
 
 					RevisionInfo.RevisionData = Revision;
 
+					// Pairs found identical by a previous diff are flagged without asking the server again
+					const FString RevisionFilename = Filename;
+					const FString PrevRevisionName = Prev.Revision;
+					const FString RevisionName = RevisionInfo.Revision;
+					TAttribute<FText> Label = TAttribute<FText>::Create([RevisionFilename, PrevRevisionName, RevisionName]()
+						{
+							if (PackageContent::IsKnownIdentical(RevisionFilename, PrevRevisionName, RevisionName))
+							{
+								return FText::Format(LOCTEXT("RevisionNumberIdentical", "{0} (content unchanged)"), FText::FromString(RevisionName));
+							}
+							return FText::Format(LOCTEXT("RevisionNumber", "{0}"), FText::FromString(RevisionName));
+						});
+
 					FOnRevisionSelected OnRevisionSelectedDelegate = OnRevisionSelected;
 					auto OnMenuItemSelected = [RevisionInfo, OnRevisionSelectedDelegate, Prev]()
 					{
 						OnRevisionSelectedDelegate.ExecuteIfBound(Prev, RevisionInfo);
 					};
+					TSharedRef<SWidget> EntryContents = SNew(STextBlock)
+						.TextStyle(FEditorStyle::Get(), "Menu.Label")
+						.Text(Label);
+					PrefetchEntries.Add({ EntryContents, Prev, RevisionInfo });
 					Prev = RevisionInfo;
-					MenuBuilder.AddMenuEntry( TAttribute<FText>(Label), ToolTipText, FSlateIcon(),
-						FUIAction(FExecuteAction::CreateLambda(OnMenuItemSelected)) );
+					MenuBuilder.AddMenuEntry(FUIAction(FExecuteAction::CreateLambda(OnMenuItemSelected)), EntryContents, NAME_None, ToolTipText);
 				}
 			}
 		}
@@ -353,22 +500,123 @@ void SRevisionMenu::OnUpdateHistoryComplete(const FSourceControlOperationRef& In
 			MenuBuilder.MakeWidget(nullptr, 500)
 		];
 
-	SourceControlQueryOp.Reset();
+	SourceControlQueryJob = 0;
 	SourceControlQueryState = ESourceControlQueryState::Queried;
 }
 
+/** The row a menu entry's contents sit in, hovered and keyboard focused as a whole */
+static TSharedPtr<SWidget> FindMenuEntryRow(const TSharedRef<SWidget>& Contents)
+{
+	static const FName MenuEntryBlockType(TEXT("SMenuEntryBlock"));
+	for (TSharedPtr<SWidget> Widget = Contents; Widget.IsValid(); Widget = Widget->GetParentWidget())
+	{
+		if (Widget->GetType() == MenuEntryBlockType)
+		{
+			return Widget;
+		}
+	}
+	return Contents;
+}
+
+EActiveTimerReturnType SRevisionMenu::UpdatePrefetch(double InCurrentTime, float InDeltaTime)
+{
+	// Sweeping over entries on the way to another one starts nothing
+	static const double HoverDelay = 0.15;
+
+	int32 Candidate = INDEX_NONE;
+	for (int32 EntryIndex = 0; EntryIndex < PrefetchEntries.Num() && Candidate == INDEX_NONE; ++EntryIndex)
+	{
+		const TSharedPtr<SWidget> Contents = PrefetchEntries[EntryIndex].Contents.Pin();
+		const TSharedPtr<SWidget> Row = Contents.IsValid() ? FindMenuEntryRow(Contents.ToSharedRef()) : nullptr;
+		if (Row.IsValid() && (Row->IsHovered() || Row->HasKeyboardFocus() || Row->HasFocusedDescendants()))
+		{
+			Candidate = EntryIndex;
+		}
+	}
+
+	if (Candidate != PrefetchCandidate)
+	{
+		CancelPrefetch();
+		PrefetchCandidate = Candidate;
+		PrefetchCandidateTime = InCurrentTime;
+	}
+	else if (Candidate != INDEX_NONE && !bCandidatePrefetched && InCurrentTime - PrefetchCandidateTime >= HoverDelay)
+	{
+		// Only the downloads are speculative, loading a package is game thread work the click still does. A click merges into these jobs
+		bCandidatePrefetched = true;
+		const FPrefetchEntry& Entry = PrefetchEntries[Candidate];
+		for (const FRevisionInfoExtended* RevisionInfo : { &Entry.Revision, &Entry.Prev })
+		{
+			if (RevisionInfo->RevisionData.IsValid())
+			{
+				PrefetchJobs.Add(FSourceControlScheduler::Get().QueueRevisionData(RevisionInfo->RevisionData, ESourceControlJobPriority::Prefetch, FOnRevisionDataReady()));
+			}
+		}
+	}
+	return EActiveTimerReturnType::Continue;
+}
+
+void SRevisionMenu::CancelPrefetch()
+{
+	// Finished jobs are no longer known to the scheduler, cancelling them does nothing
+	for (FSourceControlJobId JobId : PrefetchJobs)
+	{
+		FSourceControlScheduler::Get().Cancel(JobId);
+	}
+	PrefetchJobs.Reset();
+	bCandidatePrefetched = false;
+}
+
 
 /** Delegate called to diff a specific revision with the current */
-static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo, const FRevisionInfoExtended& RevisionInfo, UPrimaryDataAsset* InCurrentAsset)
+static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo, const FRevisionInfoExtended& RevisionInfo, UObject* InCurrentAsset)
 {
+	LLM_SCOPE_BYTAG(AssetHistory_DiffPackages);
+
 	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
 	FString CurrentPkgName;
 	FString PrevPkgName;
+	// Get the revisions of this package, from the local store when they were fetched before
 	if (RevisionInfo.RevisionData.IsValid())
-		RevisionInfo.RevisionData->Get(CurrentPkgName);
-	// Get the revision of this package from source control
+		FSourceControlScheduler::Get().FetchRevisionFile(RevisionInfo.RevisionData, ESourceControlJobPriority::Interactive, CurrentPkgName);
 	if (PrevRevisionInfo.RevisionData.IsValid())
-		PrevRevisionInfo.RevisionData->Get(PrevPkgName);
+		FSourceControlScheduler::Get().FetchRevisionFile(PrevRevisionInfo.RevisionData, ESourceControlJobPriority::Interactive, PrevPkgName);
+
+	// A move, a resave or a changelist that only touched other files gives two revisions with the same content, find that out before loading anything
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(InCurrentAsset->GetPathName());
+	FString CurrentContentFilename = CurrentPkgName;
+	if (RevisionInfo.Revision == "HEAD" && !InCurrentAsset->GetOutermost()->IsDirty())
+	{
+		CurrentContentFilename = PackageFilename;
+	}
+	// Export bytes can also change without any property changing (serial offsets, name map order), the tagged trees settle that without loading either side.
+	// Native data after the tags is one of their leaves, so a data table or curve table whose rows changed still takes the full diff
+	TArray<FTaggedPropertyDifference> PropertyDifferences;
+	if (PackageContent::AreContentsIdentical(PrevPkgName, CurrentContentFilename)
+		|| (TaggedPropertyDiff::DiffFiles(PrevPkgName, CurrentContentFilename, PropertyDifferences) && PropertyDifferences.Num() == 0))
+	{
+		if (RevisionInfo.Revision != "HEAD" && PrevRevisionInfo.RevisionData.IsValid())
+		{
+			FChurnStatistics::Get().AddDifferences(PackageFilename, RevisionInfo.Revision, TArray<FString>());
+		}
+		PackageContent::MarkIdentical(PackageFilename, PrevRevisionInfo.Revision, RevisionInfo.Revision);
+
+		FNotificationInfo Info(FText::Format(LOCTEXT("NoContentDifferences", "No differences, {0} and {1} have the same content"),
+			FText::FromString(PrevRevisionInfo.Revision), FText::FromString(RevisionInfo.Revision)));
+		Info.ExpireDuration = 4.0f;
+		FSlateNotificationManager::Get().AddNotification(Info);
+		return;
+	}
+	// The menu pairs each revision with the one before it, that pair is what the revision changed
+	if (RevisionInfo.Revision != "HEAD" && PrevRevisionInfo.RevisionData.IsValid() && PropertyDifferences.Num() > 0)
+	{
+		TArray<FString> ChangedPaths;
+		for (const FTaggedPropertyDifference& Difference : PropertyDifferences)
+		{
+			ChangedPaths.Add(Difference.Path);
+		}
+		FChurnStatistics::Get().AddDifferences(PackageFilename, RevisionInfo.Revision, ChangedPaths);
+	}
 
 	FString AssetName = FPaths::GetBaseFilename(InCurrentAsset->GetPathName());
 	if (RevisionInfo.RevisionData.IsValid())
@@ -401,7 +649,7 @@ static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo,
 				CurrentRevision = {"HEAD", 0, FDateTime::Now()};
 			else
 				CurrentRevision = { RevisionInfo.RevisionData->GetRevision(), RevisionInfo.RevisionData->GetCheckInIdentifier(), RevisionInfo.RevisionData->GetDate() };
-			AssetToolsModule.Get().DiffAssets(PreviousAsset, Asset, OldRevision, CurrentRevision);
+			DiffLoadedAssets(PreviousAsset, Asset, OldRevision, CurrentRevision);
 		}
 		else
 		{
@@ -412,4 +660,59 @@ static void OnDiffRevisionPicked(const FRevisionInfoExtended& PrevRevisionInfo,
 	{
 		FMessageDialog::Open(EAppMsgType::Ok, NSLOCTEXT("SourceControl.HistoryWindow", "UnableToLoadAssets", "Unable to load assets to diff. Content may no longer be supported?"));
 	}
-}
\ No newline at end of file
+}
+
+static void DiffLoadedAssets(UObject* PreviousAsset, UObject* Asset, const FRevisionInfo& OldRevision, const FRevisionInfo& CurrentRevision)
+{
+	if (CurveDiff::IsCurveAsset(Asset))
+	{
+		// The stock curve diff is a text diff of every key, use the numeric one instead
+		SCurveDiff::CreateDiffWindow(FText::FromString(Asset->GetName()), PreviousAsset, Asset, OldRevision, CurrentRevision);
+	}
+	else
+	{
+		FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+		AssetToolsModule.Get().DiffAssets(PreviousAsset, Asset, OldRevision, CurrentRevision);
+	}
+}
+
+/** Diffs two local snapshots, or one against the asset as it is in the editor when NewId is INDEX_NONE */
+static void OnDiffLocalSnapshotPicked(int32 OldId, int32 NewId, TWeakObjectPtr<UObject> WeakCurrentAsset)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_DiffPackages);
+
+	UObject* CurrentAsset = WeakCurrentAsset.Get();
+	if (!CurrentAsset)
+	{
+		return;
+	}
+
+	const FString PackageFilename = SourceControlHelpers::PackageFilename(CurrentAsset->GetPathName());
+	const FString AssetName = CurrentAsset->GetName();
+	TArray<FLocalSnapshot> Snapshots;
+	FLocalSnapshotStore::Get().GetSnapshots(PackageFilename, Snapshots);
+	auto LoadSnapshot = [&PackageFilename, &AssetName, &Snapshots](int32 Id, FRevisionInfo& OutRevision) -> UObject*
+	{
+		const FLocalSnapshot* Snapshot = Snapshots.FindByPredicate([Id](const FLocalSnapshot& Candidate) { return Candidate.Id == Id; });
+		FString Filename;
+		if (!Snapshot || !FLocalSnapshotStore::Get().GetSnapshotFile(PackageFilename, Id, Filename))
+		{
+			return nullptr;
+		}
+
+		OutRevision = { FLocalSnapshotStore::GetRevisionName(Id), 0, Snapshot->Date };
+		UPackage* Package = LoadPackage(NULL, *Filename, LOAD_ForDiff | LOAD_DisableCompileOnLoad);
+		return Package ? FindObject<UObject>(Package, *AssetName) : nullptr;
+	};
+
+	FRevisionInfo OldRevision;
+	FRevisionInfo NewRevision = { "HEAD", 0, FDateTime::Now() };
+	UObject* PreviousAsset = LoadSnapshot(OldId, OldRevision);
+	UObject* Asset = NewId == INDEX_NONE ? CurrentAsset : LoadSnapshot(NewId, NewRevision);
+	if (!IsValid(PreviousAsset) || !IsValid(Asset))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("UnableToLoadSnapshot", "Unable to load the local snapshot to diff."));
+		return;
+	}
+	DiffLoadedAssets(PreviousAsset, Asset, OldRevision, NewRevision);
+}
@@ -0,0 +1,357 @@
+
+#include "PropertyDiff.h"
+#include "AssetHistorySettings.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+static bool AreBytesEqual(const FProperty* Property, const void* A, const void* B, double Tolerance)
+{
+	return FMemory::Memcmp(A, B, Property->ElementSize) == 0;
+}
+
+template<typename FloatType>
+static bool AreFloatsEqual(const FProperty* Property, const void* A, const void* B, double Tolerance)
+{
+	const FloatType ValueA = *static_cast<const FloatType*>(A);
+	const FloatType ValueB = *static_cast<const FloatType*>(B);
+	return ValueA == ValueB || FMath::Abs(double(ValueA) - double(ValueB)) <= Tolerance;
+}
+
+static bool AreBoolsEqual(const FProperty* Property, const void* A, const void* B, double Tolerance)
+{
+	// Bitfields share their byte with other members
+	const FBoolProperty* BoolProperty = CastFieldChecked<const FBoolProperty>(Property);
+	return BoolProperty->GetPropertyValue(A) == BoolProperty->GetPropertyValue(B);
+}
+
+static bool AreNamesEqual(const FProperty* Property, const void* A, const void* B, double Tolerance)
+{
+	return *static_cast<const FName*>(A) == *static_cast<const FName*>(B);
+}
+
+FPropertyComparators& FPropertyComparators::Get()
+{
+	static FPropertyComparators Comparators;
+	return Comparators;
+}
+
+FPropertyComparators::FPropertyComparators()
+{
+	// Found by walking up the property class, the floating point ones before the other numbers
+	PropertyClassComparators.Add(FNumericProperty::StaticClass(), &AreBytesEqual);
+	PropertyClassComparators.Add(FFloatProperty::StaticClass(), &AreFloatsEqual<float>);
+	PropertyClassComparators.Add(FDoubleProperty::StaticClass(), &AreFloatsEqual<double>);
+	PropertyClassComparators.Add(FEnumProperty::StaticClass(), &AreBytesEqual);
+	PropertyClassComparators.Add(FBoolProperty::StaticClass(), &AreBoolsEqual);
+	PropertyClassComparators.Add(FNameProperty::StaticClass(), &AreNamesEqual);
+
+	StructComparators.Add(TBaseStructure<FVector>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FVector*>(A)->Equals(*static_cast<const FVector*>(B), Tolerance);
+		});
+	StructComparators.Add(TBaseStructure<FVector2D>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FVector2D*>(A)->Equals(*static_cast<const FVector2D*>(B), Tolerance);
+		});
+	StructComparators.Add(TBaseStructure<FVector4>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FVector4*>(A)->Equals(*static_cast<const FVector4*>(B), Tolerance);
+		});
+	StructComparators.Add(TBaseStructure<FRotator>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FRotator*>(A)->Equals(*static_cast<const FRotator*>(B), Tolerance);
+		});
+	StructComparators.Add(TBaseStructure<FQuat>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FQuat*>(A)->Equals(*static_cast<const FQuat*>(B), Tolerance);
+		});
+	StructComparators.Add(TBaseStructure<FLinearColor>::Get(), [](const FProperty* Property, const void* A, const void* B, double Tolerance)
+		{
+			return static_cast<const FLinearColor*>(A)->Equals(*static_cast<const FLinearColor*>(B), float(Tolerance));
+		});
+}
+
+void FPropertyComparators::RegisterPropertyClass(FFieldClass* PropertyClass, FPropertyValueComparator Comparator)
+{
+	check(IsInGameThread() && PropertyClass && Comparator);
+	PropertyClassComparators.Add(PropertyClass, Comparator);
+}
+
+void FPropertyComparators::RegisterStruct(const UScriptStruct* Struct, FPropertyValueComparator Comparator)
+{
+	check(IsInGameThread() && Struct && Comparator);
+	StructComparators.Add(Struct, Comparator);
+}
+
+bool FPropertyComparators::AreEqual(const FProperty* Property, const void* A, const void* B, double Tolerance) const
+{
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		if (const FPropertyValueComparator* Comparator = StructComparators.Find(StructProperty->Struct))
+		{
+			return (*Comparator)(Property, A, B, Tolerance);
+		}
+		return AreStructsEqual(StructProperty->Struct, A, B, Tolerance);
+	}
+
+	if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		return AreArraysEqual(ArrayProperty, A, B, Tolerance);
+	}
+
+	for (FFieldClass* PropertyClass = Property->GetClass(); PropertyClass; PropertyClass = PropertyClass->GetSuperClass())
+	{
+		if (const FPropertyValueComparator* Comparator = PropertyClassComparators.Find(PropertyClass))
+		{
+			return (*Comparator)(Property, A, B, Tolerance);
+		}
+	}
+
+	// Instanced objects belong to the package of their owner, two revisions never share one. Identical would compare their pointers
+	if (Property->HasAnyPropertyFlags(CPF_InstancedReference))
+	{
+		if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			return AreInstancesEqual(ObjectProperty, A, B, Tolerance);
+		}
+	}
+
+	// Strings, texts, containers and references
+	return Property->Identical(A, B, PPF_DeepComparison | PPF_DeepCompareInstances);
+}
+
+/** Instanced graphs are trees in practice, the bound only stops a malformed cycle */
+static constexpr int32 MaxInstanceDepth = 8;
+
+bool FPropertyComparators::AreInstancesEqual(const FObjectPropertyBase* Property, const void* A, const void* B, double Tolerance) const
+{
+	const UObject* ObjectA = Property->GetObjectPropertyValue(A);
+	const UObject* ObjectB = Property->GetObjectPropertyValue(B);
+	if (ObjectA == ObjectB)
+	{
+		return true;
+	}
+
+	// Instanced objects keep their name across saves, a different name or class is a different instance
+	if (!ObjectA || !ObjectB || ObjectA->GetClass() != ObjectB->GetClass() || ObjectA->GetFName() != ObjectB->GetFName())
+	{
+		return false;
+	}
+
+	static thread_local int32 InstanceDepth = 0;
+	if (InstanceDepth >= MaxInstanceDepth)
+	{
+		return false;
+	}
+	TGuardValue<int32> DepthGuard(InstanceDepth, InstanceDepth + 1);
+
+	for (TFieldIterator<FProperty> It(ObjectA->GetClass()); It; ++It)
+	{
+		if (!PropertyDiff::IsCompared(*It))
+		{
+			continue;
+		}
+		for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+		{
+			if (!AreEqual(*It, It->ContainerPtrToValuePtr<void>(ObjectA, Index), It->ContainerPtrToValuePtr<void>(ObjectB, Index), Tolerance))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool FPropertyComparators::AreStructsEqual(const UScriptStruct* Struct, const void* A, const void* B, double Tolerance) const
+{
+	// A native comparison knows about data the reflected members don't show
+	if (Struct->StructFlags & STRUCT_IdenticalNative)
+	{
+		return Struct->CompareScriptStruct(A, B, PPF_DeepComparison | PPF_DeepCompareInstances);
+	}
+
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		for (int32 Index = 0; Index < It->ArrayDim; ++Index)
+		{
+			if (!AreEqual(*It, It->ContainerPtrToValuePtr<void>(A, Index), It->ContainerPtrToValuePtr<void>(B, Index), Tolerance))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool FPropertyComparators::AreArraysEqual(const FArrayProperty* Property, const void* A, const void* B, double Tolerance) const
+{
+	FScriptArrayHelper HelperA(Property, A);
+	FScriptArrayHelper HelperB(Property, B);
+	const int32 Num = HelperA.Num();
+	if (Num != HelperB.Num())
+	{
+		return false;
+	}
+	if (Num == 0)
+	{
+		return true;
+	}
+
+	// Plain old data is equal when its bytes are. Only a mismatch, padding or a float within the tolerance, needs the elements compared
+	const FProperty* Inner = Property->Inner;
+	if (Inner->HasAnyPropertyFlags(CPF_IsPlainOldData) && FMemory::Memcmp(HelperA.GetRawPtr(0), HelperB.GetRawPtr(0), int64(Num) * Inner->ElementSize) == 0)
+	{
+		return true;
+	}
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (!AreEqual(Inner, HelperA.GetRawPtr(Index), HelperB.GetRawPtr(Index), Tolerance))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+namespace PropertyDiff
+{
+	struct FCompareContext
+	{
+		TArray<FSingleObjectDiffEntry>& OutDifferences;
+		FDiffProgress* Progress;
+		double Tolerance;
+
+		bool IsCancelled() const
+		{
+			return Progress && Progress->bCancelled;
+		}
+
+		void Visit()
+		{
+			if (Progress)
+			{
+				++Progress->PropertiesVisited;
+			}
+		}
+
+		void Add(const FPropertySoftPath& Path, EPropertyDiffType::Type DiffType)
+		{
+			OutDifferences.Add(FSingleObjectDiffEntry(Path, DiffType));
+			if (Progress)
+			{
+				++Progress->DifferencesFound;
+			}
+		}
+	};
+
+	bool IsCompared(const FProperty* Property)
+	{
+		return Property->HasAnyPropertyFlags(CPF_Edit) && !Property->HasAnyPropertyFlags(CPF_Deprecated);
+	}
+
+	static void CompareStructs(const UStruct* StructA, const void* A, const UStruct* StructB, const void* B, const FPropertySoftPath& Path, FCompareContext& Context);
+
+	static void CompareValues(const FProperty* Property, const void* A, const void* B, const FPropertySoftPath& Path, FCompareContext& Context)
+	{
+		Context.Visit();
+		if (FPropertyComparators::Get().AreEqual(Property, A, B, Context.Tolerance))
+		{
+			return;
+		}
+
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			// The difference may be in members the details don't show, the struct itself is reported then
+			const int32 NumBefore = Context.OutDifferences.Num();
+			CompareStructs(StructProperty->Struct, A, StructProperty->Struct, B, Path, Context);
+			if (Context.OutDifferences.Num() == NumBefore && !Context.IsCancelled())
+			{
+				Context.Add(Path, EPropertyDiffType::PropertyValueChanged);
+			}
+			return;
+		}
+
+		if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper HelperA(ArrayProperty, A);
+			FScriptArrayHelper HelperB(ArrayProperty, B);
+			const int32 NumCommon = FMath::Min(HelperA.Num(), HelperB.Num());
+			for (int32 Index = 0; Index < NumCommon && !Context.IsCancelled(); ++Index)
+			{
+				CompareValues(ArrayProperty->Inner, HelperA.GetRawPtr(Index), HelperB.GetRawPtr(Index), FPropertySoftPath(Path, Index), Context);
+			}
+			for (int32 Index = NumCommon; Index < HelperA.Num(); ++Index)
+			{
+				Context.Add(FPropertySoftPath(Path, Index), EPropertyDiffType::PropertyAddedToA);
+			}
+			for (int32 Index = NumCommon; Index < HelperB.Num(); ++Index)
+			{
+				Context.Add(FPropertySoftPath(Path, Index), EPropertyDiffType::PropertyAddedToB);
+			}
+			return;
+		}
+
+		Context.Add(Path, EPropertyDiffType::PropertyValueChanged);
+	}
+
+	static void CompareStructs(const UStruct* StructA, const void* A, const UStruct* StructB, const void* B, const FPropertySoftPath& Path, FCompareContext& Context)
+	{
+		for (TFieldIterator<FProperty> It(StructA); It && !Context.IsCancelled(); ++It)
+		{
+			const FProperty* PropertyA = *It;
+			if (!IsCompared(PropertyA))
+			{
+				continue;
+			}
+
+			const FPropertySoftPath PropertyPath(Path, PropertyA);
+			const FProperty* PropertyB = StructA == StructB ? PropertyA : FindFProperty<FProperty>(StructB, PropertyA->GetFName());
+			if (!PropertyB || !PropertyB->SameType(PropertyA) || PropertyB->ArrayDim != PropertyA->ArrayDim)
+			{
+				Context.Add(PropertyPath, EPropertyDiffType::PropertyAddedToA);
+				continue;
+			}
+
+			for (int32 Index = 0; Index < PropertyA->ArrayDim; ++Index)
+			{
+				CompareValues(PropertyA, PropertyA->ContainerPtrToValuePtr<void>(A, Index), PropertyB->ContainerPtrToValuePtr<void>(B, Index),
+					PropertyA->ArrayDim > 1 ? FPropertySoftPath(PropertyPath, Index) : PropertyPath, Context);
+			}
+		}
+
+		if (StructA != StructB)
+		{
+			for (TFieldIterator<FProperty> It(StructB); It && !Context.IsCancelled(); ++It)
+			{
+				if (IsCompared(*It) && !FindFProperty<FProperty>(StructA, It->GetFName()))
+				{
+					Context.Add(FPropertySoftPath(Path, *It), EPropertyDiffType::PropertyAddedToB);
+				}
+			}
+		}
+	}
+
+	bool CompareObjects(const UObject* A, const UObject* B, TArray<FSingleObjectDiffEntry>& OutDifferences, FDiffProgress* Progress)
+	{
+		check(A && B);
+		FCompareContext Context{ OutDifferences, Progress, GetDefault<UAssetHistorySettings>()->DiffTolerance };
+		CompareStructs(A->GetClass(), A, B->GetClass(), B, FPropertySoftPath(), Context);
+		return !Context.IsCancelled();
+	}
+
+	const UObject* MakeWorkerCopy(const UObject* Object)
+	{
+		check(IsInGameThread());
+		if (!Object || Object->GetOutermost()->HasAnyPackageFlags(PKG_ForDiffing))
+		{
+			return Object;
+		}
+
+		// Instanced sub-objects are duplicated along with it and keep their names, the compare matches them by name
+		UPackage* TransientPackage = GetTransientPackage();
+		return DuplicateObject<UObject>(Object, TransientPackage, MakeUniqueObjectName(TransientPackage, Object->GetClass(), Object->GetFName()));
+	}
+}
@@ -0,0 +1,637 @@
+
+#include "PropertyHistorySearch.h"
+#include "AssetHistoryMemory.h"
+#include "SourceControlScheduler.h"
+#include "RevisionStore.h"
+#include "CanonicalText.h"
+#include "TaggedPropertyReader.h"
+#include "DiffExport.h"
+#include "ChurnStatistics.h"
+#include "DesktopPlatformModule.h"
+#include "IDesktopPlatform.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/DataAsset.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Serialization/LargeMemoryWriter.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Views/STableRow.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+#include "Editor.h"
+#include "EditorStyleSet.h"
+
+#define LOCTEXT_NAMESPACE "SPropertyHistorySearch"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPropertyHistorySearch, Log, All);
+
+const FName SPropertyHistorySearch::TabName(TEXT("AssetHistoryPropertySearch"));
+
+namespace PropertyHistorySearchColumns
+{
+	static const FName Asset(TEXT("Asset"));
+	static const FName Revision(TEXT("Revision"));
+	static const FName User(TEXT("User"));
+	static const FName Date(TEXT("Date"));
+	static const FName Property(TEXT("Property"));
+	static const FName Change(TEXT("Change"));
+}
+
+FPropertyHistorySearch::~FPropertyHistorySearch()
+{
+	Cancel();
+}
+
+void FPropertyHistorySearch::Start(const FString& InPropertyName, FTimespan InWindow)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	check(IsInGameThread() && !bRunning);
+
+	PropertyName = InPropertyName;
+	Cutoff = FDateTime::Now() - InWindow;
+	bRunning = true;
+	bCancelled = false;
+	NumPairsDone = 0;
+	NumPairs = 0;
+	AssetRevisions.Reset();
+	AssetsByFilename.Reset();
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	if (!ISourceControlModule::Get().IsEnabled() || !SourceControlProvider.IsAvailable())
+	{
+		bRunning = false;
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	FARFilter Filter;
+	Filter.ClassNames.Add(UPrimaryDataAsset::StaticClass()->GetFName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(TEXT("/Game"));
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// Only ask the server for the histories it hasn't given us yet
+	TArray<FString> MissingHistories;
+	for (const FAssetData& Asset : Assets)
+	{
+		const FString Filename = SourceControlHelpers::PackageFilename(Asset.PackageName.ToString());
+		AssetsByFilename.Add(Filename, TPair<FString, FString>(Asset.AssetName.ToString(), Asset.PackageName.ToString()));
+
+		FSourceControlStatePtr State = SourceControlProvider.GetState(Filename, EStateCacheUsage::Use);
+		if (!State.IsValid() || State->IsUnknown() || (State->IsSourceControlled() && State->GetHistorySize() == 0))
+		{
+			MissingHistories.Add(Filename);
+		}
+	}
+
+	if (MissingHistories.Num() == 0)
+	{
+		CollectRevisions();
+		return;
+	}
+
+	bQueryingHistory = true;
+	TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+	UpdateStatusOp->SetUpdateHistory(true);
+	HistoryQueryJob = FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, MissingHistories, ESourceControlJobPriority::Normal,
+		FSourceControlOperationComplete::CreateSP(this, &FPropertyHistorySearch::OnHistoryUpdated));
+}
+
+void FPropertyHistorySearch::Cancel()
+{
+	bCancelled = true;
+	if (bQueryingHistory)
+	{
+		FSourceControlScheduler::Get().Cancel(HistoryQueryJob);
+	}
+}
+
+void FPropertyHistorySearch::OnHistoryUpdated(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
+{
+	bQueryingHistory = false;
+	HistoryQueryJob = 0;
+	if (bCancelled || InResult == ECommandResult::Cancelled)
+	{
+		bRunning = false;
+		return;
+	}
+
+	// A failed query still leaves the histories that were cached, search those
+	CollectRevisions();
+}
+
+void FPropertyHistorySearch::CollectRevisions()
+{
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	for (const TPair<FString, TPair<FString, FString>>& Asset : AssetsByFilename)
+	{
+		FSourceControlStatePtr State = SourceControlProvider.GetState(Asset.Key, EStateCacheUsage::Use);
+		if (!State.IsValid())
+		{
+			continue;
+		}
+
+		// Histories are newest first, stop at the first revision before the window but keep it as the base of the oldest pair
+		FAssetRevisions Revisions;
+		for (int32 HistoryIndex = 0; HistoryIndex < State->GetHistorySize(); ++HistoryIndex)
+		{
+			TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = State->GetHistoryItem(HistoryIndex);
+			if (!Revision.IsValid())
+			{
+				break;
+			}
+			Revisions.Revisions.Add(Revision);
+			if (Revision->GetDate() < Cutoff)
+			{
+				break;
+			}
+		}
+
+		if (Revisions.Revisions.Num() >= 2)
+		{
+			Revisions.PackageFilename = Asset.Key;
+			Revisions.AssetName = Asset.Value.Key;
+			Revisions.PackageName = Asset.Value.Value;
+			NumPairs += Revisions.Revisions.Num() - 1;
+			AssetRevisions.Add(MoveTemp(Revisions));
+		}
+	}
+
+	if (AssetRevisions.Num() == 0)
+	{
+		bRunning = false;
+		return;
+	}
+
+	DiffRevisions();
+}
+
+void FPropertyHistorySearch::DiffRevisions()
+{
+	TSharedRef<FPropertyHistorySearch> This = AsShared();
+	Async(EAsyncExecution::ThreadPool, [This]()
+		{
+			// One asset per task: consecutive pairs share a revision, so each revision is fetched and parsed once
+			ParallelFor(This->AssetRevisions.Num(), [&This](int32 AssetIndex)
+				{
+					This->DiffAsset(This->AssetRevisions[AssetIndex]);
+				}, EParallelForFlags::BackgroundPriority | EParallelForFlags::Unbalanced);
+			This->bRunning = false;
+		});
+}
+
+void FPropertyHistorySearch::DiffAsset(const FAssetRevisions& Asset)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	// Texts are cached next to the stored revisions, a repeated search diffs lines instead of parsing packages again
+	auto ReadText = [&Asset](int32 RevisionIndex, TArray64<uint8>& OutText)
+	{
+		const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision = Asset.Revisions[RevisionIndex];
+		if (FRevisionStore::Get().ReadRevisionText(Revision->GetFilename(), Revision->GetRevision(), OutText))
+		{
+			return true;
+		}
+
+		TArray64<uint8> Data;
+		if (!FSourceControlScheduler::Get().FetchRevisionData(Revision, ESourceControlJobPriority::Normal, Data))
+		{
+			return false;
+		}
+		if (FRevisionStore::Get().ReadRevisionText(Revision->GetFilename(), Revision->GetRevision(), OutText))
+		{
+			return true;
+		}
+
+		// The store didn't keep it, build the text in memory this time
+		FLargeMemoryWriter Writer;
+		if (!CanonicalText::WritePackageData(Revision->GetFilename(), MoveTemp(Data), Writer))
+		{
+			return false;
+		}
+		OutText = TArray64<uint8>(Writer.GetData(), Writer.TotalSize());
+		return true;
+	};
+
+	TArray64<uint8> NewText;
+	bool bHasNewText = ReadText(0, NewText);
+	for (int32 RevisionIndex = 0; RevisionIndex + 1 < Asset.Revisions.Num(); ++RevisionIndex)
+	{
+		if (bCancelled)
+		{
+			return;
+		}
+
+		TArray64<uint8> OldText;
+		const bool bHasOldText = ReadText(RevisionIndex + 1, OldText);
+		if (bHasNewText && bHasOldText)
+		{
+			TArray<FTaggedPropertyDifference> Differences;
+			CanonicalText::Diff(OldText, NewText, Differences);
+
+			const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision = Asset.Revisions[RevisionIndex];
+			TArray<FString> ChangedPaths;
+			ChangedPaths.Reserve(Differences.Num());
+			for (const FTaggedPropertyDifference& Difference : Differences)
+			{
+				ChangedPaths.Add(Difference.Path);
+			}
+			FChurnStatistics::Get().AddDifferences(Asset.PackageFilename, Revision->GetRevision(), ChangedPaths);
+
+			for (FTaggedPropertyDifference& Difference : Differences)
+			{
+				if (!MatchesProperty(Difference.Path, PropertyName))
+				{
+					continue;
+				}
+
+				TSharedPtr<FPropertyChangeResult> Result = MakeShared<FPropertyChangeResult>();
+				Result->AssetName = Asset.AssetName;
+				Result->PackageName = Asset.PackageName;
+				Result->OldRevision = Asset.Revisions[RevisionIndex + 1]->GetRevision();
+				Result->Revision = Revision->GetRevision();
+				Result->UserName = Revision->GetUserName();
+				Result->Date = Revision->GetDate();
+				Result->PropertyPath = MoveTemp(Difference.Path);
+				Result->OldValue = MoveTemp(Difference.OldValue);
+				Result->NewValue = MoveTemp(Difference.NewValue);
+				PendingResults.Enqueue(Result);
+			}
+		}
+		else
+		{
+			UE_LOG(LogPropertyHistorySearch, Verbose, TEXT("Skipped %s revision %s, it could not be fetched or read"), *Asset.PackageName, *Asset.Revisions[RevisionIndex]->GetRevision());
+		}
+
+		NewText = MoveTemp(OldText);
+		bHasNewText = bHasOldText;
+		++NumPairsDone;
+	}
+}
+
+void FPropertyHistorySearch::DequeueResults(TArray<TSharedPtr<FPropertyChangeResult>>& OutResults)
+{
+	TSharedPtr<FPropertyChangeResult> Result;
+	while (PendingResults.Dequeue(Result))
+	{
+		OutResults.Add(Result);
+	}
+}
+
+FText FPropertyHistorySearch::GetStatusText() const
+{
+	if (bQueryingHistory)
+	{
+		return FText::Format(LOCTEXT("QueryingHistory", "Fetching the history of {0} assets..."), FText::AsNumber(AssetsByFilename.Num()));
+	}
+	if (bRunning)
+	{
+		return FText::Format(LOCTEXT("DiffingRevisions", "Diffing revisions {0} / {1}"), FText::AsNumber(NumPairsDone.Load()), FText::AsNumber(NumPairs));
+	}
+	if (bCancelled)
+	{
+		return LOCTEXT("SearchCancelled", "Cancelled");
+	}
+	return FText::Format(LOCTEXT("SearchDone", "Searched {0} revisions of {1} assets"), FText::AsNumber(NumPairsDone.Load()), FText::AsNumber(AssetRevisions.Num()));
+}
+
+bool FPropertyHistorySearch::MatchesProperty(const FString& PropertyPath, const FString& InPropertyName)
+{
+	if (InPropertyName.IsEmpty())
+	{
+		return true;
+	}
+
+	FString Path;
+	Path.Reserve(PropertyPath.Len());
+	int32 BracketDepth = 0;
+	for (TCHAR Char : PropertyPath)
+	{
+		if (Char == TEXT('['))
+		{
+			++BracketDepth;
+		}
+		else if (Char == TEXT(']'))
+		{
+			BracketDepth = FMath::Max(BracketDepth - 1, 0);
+		}
+		else if (BracketDepth == 0)
+		{
+			Path.AppendChar(Char == TEXT(':') ? TEXT('.') : Char);
+		}
+	}
+
+	if (InPropertyName.Contains(TEXT(".")))
+	{
+		return Path.Contains(InPropertyName);
+	}
+
+	TArray<FString> Segments;
+	Path.ParseIntoArray(Segments, TEXT("."));
+	return Segments.ContainsByPredicate([&InPropertyName](const FString& Segment) { return Segment.Equals(InPropertyName, ESearchCase::IgnoreCase); });
+}
+
+class SPropertyChangeRow : public SMultiColumnTableRow<TSharedPtr<FPropertyChangeResult>>
+{
+public:
+	SLATE_BEGIN_ARGS(SPropertyChangeRow){}
+		SLATE_ARGUMENT(TSharedPtr<FPropertyChangeResult>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FPropertyChangeResult>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		FText Text;
+		if (ColumnName == PropertyHistorySearchColumns::Asset)
+		{
+			Text = FText::FromString(Item->AssetName);
+		}
+		else if (ColumnName == PropertyHistorySearchColumns::Revision)
+		{
+			Text = FText::FromString(Item->Revision);
+		}
+		else if (ColumnName == PropertyHistorySearchColumns::User)
+		{
+			Text = FText::FromString(Item->UserName);
+		}
+		else if (ColumnName == PropertyHistorySearchColumns::Date)
+		{
+			Text = FText::AsDateTime(Item->Date);
+		}
+		else if (ColumnName == PropertyHistorySearchColumns::Property)
+		{
+			Text = FText::FromString(Item->PropertyPath);
+		}
+		else
+		{
+			Text = FText::Format(LOCTEXT("PropertyChange", "{0} -> {1}"), FText::FromString(Item->OldValue), FText::FromString(Item->NewValue));
+		}
+
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+			];
+	}
+
+private:
+	TSharedPtr<FPropertyChangeResult> Item;
+};
+
+void SPropertyHistorySearch::Construct(const FArguments& InArgs)
+{
+	this->ChildSlot
+		[
+			SNew(SBorder)
+			.BorderImage(FEditorStyle::GetBrush("Docking.Tab", ".ContentAreaBrush"))
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SAssignNew(PropertyNameBox, SEditableTextBox)
+						.HintText(LOCTEXT("PropertyNameHint", "Property name, e.g. BaseHealth or Stats.BaseHealth"))
+						.OnTextCommitted_Lambda([this](const FText&, ETextCommit::Type CommitType)
+							{
+								if (CommitType == ETextCommit::OnEnter && !(Search.IsValid() && Search->IsRunning()))
+								{
+									OnSearchClicked();
+								}
+							})
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					.Padding(4.0f, 0.0f)
+					[
+						SNew(STextBlock)
+						.Text(LOCTEXT("WindowLabel", "Last days"))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SNew(SBox)
+						.WidthOverride(60.0f)
+						[
+							SNew(SSpinBox<int32>)
+							.MinValue(1)
+							.MaxValue(3650)
+							.Value_Lambda([this]() { return WindowDays; })
+							.OnValueChanged_Lambda([this](int32 InValue) { WindowDays = InValue; })
+						]
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(this, &SPropertyHistorySearch::GetSearchButtonText)
+						.OnClicked(this, &SPropertyHistorySearch::OnSearchClicked)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(4.0f, 0.0f, 0.0f, 0.0f)
+					[
+						SNew(SButton)
+						.Text(LOCTEXT("ExportResults", "Export"))
+						.ToolTipText(LOCTEXT("ExportResultsTooltip", "Save the changes found as CSV, JSON or Markdown"))
+						.IsEnabled_Lambda([this]() { return Results.Num() > 0; })
+						.OnClicked(this, &SPropertyHistorySearch::OnExportClicked)
+					]
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f, 0.0f, 4.0f, 4.0f)
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]()
+						{
+							if (!Search.IsValid())
+							{
+								return LOCTEXT("SearchIdle", "Finds which data assets had a property changed, and by whom");
+							}
+							return FText::Format(LOCTEXT("SearchStatus", "{0}, {1} changes found"), Search->GetStatusText(), FText::AsNumber(Results.Num()));
+						})
+				]
+				+ SVerticalBox::Slot()
+				[
+					SNew(SBorder)
+					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+					[
+						SAssignNew(ResultListView, SListView<TSharedPtr<FPropertyChangeResult>>)
+						.ListItemsSource(&Results)
+						.OnGenerateRow(this, &SPropertyHistorySearch::OnGenerateRow)
+						.OnMouseButtonDoubleClick(this, &SPropertyHistorySearch::OnResultDoubleClicked)
+						.SelectionMode(ESelectionMode::Single)
+						.HeaderRow
+						(
+							SNew(SHeaderRow)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::Asset)
+							.DefaultLabel(LOCTEXT("AssetColumn", "Asset"))
+							.ManualWidth(180.0f)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::Revision)
+							.DefaultLabel(LOCTEXT("RevisionColumn", "Revision"))
+							.ManualWidth(90.0f)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::User)
+							.DefaultLabel(LOCTEXT("UserColumn", "User"))
+							.ManualWidth(120.0f)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::Date)
+							.DefaultLabel(LOCTEXT("DateColumn", "Date"))
+							.ManualWidth(140.0f)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::Property)
+							.DefaultLabel(LOCTEXT("PropertyColumn", "Property"))
+							.ManualWidth(200.0f)
+							+ SHeaderRow::Column(PropertyHistorySearchColumns::Change)
+							.DefaultLabel(LOCTEXT("ChangeColumn", "Change"))
+						)
+					]
+				]
+			]
+		];
+}
+
+SPropertyHistorySearch::~SPropertyHistorySearch()
+{
+	if (Search.IsValid())
+	{
+		Search->Cancel();
+	}
+}
+
+TSharedRef<SDockTab> SPropertyHistorySearch::SpawnTab(const FSpawnTabArgs& Args)
+{
+	return SNew(SDockTab)
+		.TabRole(ETabRole::NomadTab)
+		[
+			SNew(SPropertyHistorySearch)
+		];
+}
+
+FReply SPropertyHistorySearch::OnSearchClicked()
+{
+	if (Search.IsValid() && Search->IsRunning())
+	{
+		Search->Cancel();
+		return FReply::Handled();
+	}
+
+	Results.Reset();
+	ResultListView->RequestListRefresh();
+
+	// A fresh search each time, a cancelled one may still be unwinding on the worker threads
+	Search = MakeShared<FPropertyHistorySearch>();
+	Search->Start(PropertyNameBox->GetText().ToString().TrimStartAndEnd(), FTimespan::FromDays(WindowDays));
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SPropertyHistorySearch::PollResults));
+	return FReply::Handled();
+}
+
+FReply SPropertyHistorySearch::OnExportClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	TArray<FString> Filenames;
+	if (!DesktopPlatform || !DesktopPlatform->SaveFileDialog(FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+		LOCTEXT("ExportResultsTitle", "Export Property Changes").ToString(), FPaths::ProjectSavedDir(), TEXT("PropertyChanges.csv"),
+		FDiffExportWriter::GetFileTypes(), EFileDialogFlags::None, Filenames) || Filenames.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	EDiffExportFormat Format = EDiffExportFormat::Csv;
+	FDiffExportWriter::FormatFromFilename(Filenames[0], Format);
+	TUniquePtr<FDiffExportWriter> Writer = FDiffExportWriter::Create(Filenames[0], Format);
+	bool bSuccess = false;
+	if (Writer.IsValid())
+	{
+		FDiffExportEntry Entry;
+		for (const TSharedPtr<FPropertyChangeResult>& Result : Results)
+		{
+			Entry.AssetName = Result->AssetName;
+			Entry.PropertyPath = Result->PropertyPath;
+			Entry.OldValue = Result->OldValue;
+			Entry.NewValue = Result->NewValue;
+			Entry.OldRevision = Result->OldRevision;
+			Entry.NewRevision = Result->Revision;
+			Entry.Author = Result->UserName;
+			Writer->Write(Entry);
+		}
+		bSuccess = Writer->Close();
+	}
+
+	FNotificationInfo Info(bSuccess
+		? FText::Format(LOCTEXT("ExportResultsDone", "Exported {0} changes to {1}"), FText::AsNumber(Writer->GetNumEntries()), FText::FromString(Filenames[0]))
+		: FText::Format(LOCTEXT("ExportResultsFailed", "Failed to write {0}"), FText::FromString(Filenames[0])));
+	Info.ExpireDuration = 4.0f;
+	FSlateNotificationManager::Get().AddNotification(Info);
+	return FReply::Handled();
+}
+
+FText SPropertyHistorySearch::GetSearchButtonText() const
+{
+	return Search.IsValid() && Search->IsRunning() ? LOCTEXT("CancelSearch", "Cancel") : LOCTEXT("StartSearch", "Search");
+}
+
+EActiveTimerReturnType SPropertyHistorySearch::PollResults(double InCurrentTime, float InDeltaTime)
+{
+	if (!Search.IsValid())
+	{
+		return EActiveTimerReturnType::Stop;
+	}
+
+	const bool bStillRunning = Search->IsRunning();
+	const int32 NumResults = Results.Num();
+	Search->DequeueResults(Results);
+	if (Results.Num() != NumResults)
+	{
+		ResultListView->RequestListRefresh();
+	}
+	return bStillRunning ? EActiveTimerReturnType::Continue : EActiveTimerReturnType::Stop;
+}
+
+TSharedRef<ITableRow> SPropertyHistorySearch::OnGenerateRow(TSharedPtr<FPropertyChangeResult> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SPropertyChangeRow, OwnerTable)
+		.Item(Item);
+}
+
+void SPropertyHistorySearch::OnResultDoubleClicked(TSharedPtr<FPropertyChangeResult> Item)
+{
+	if (!Item.IsValid())
+	{
+		return;
+	}
+
+	const FSoftObjectPath AssetPath(FString::Printf(TEXT("%s.%s"), *Item->PackageName, *Item->AssetName));
+	if (UObject* Asset = AssetPath.TryLoad())
+	{
+		GEditor->GetEditorSubsystem<UAssetEditorSubsystem>()->OpenEditorForAsset(Asset);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
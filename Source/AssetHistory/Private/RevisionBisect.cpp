@@ -0,0 +1,706 @@
+
+#include "RevisionBisect.h"
+#include "AssetHistoryMemory.h"
+#include "PackageFileReader.h"
+#include "TaggedPropertyReader.h"
+#include "DiffExport.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "SourceControlOperations.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "Async/Async.h"
+#include "Widgets/Input/SEditableTextBox.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Views/STableRow.h"
+#include "EditorStyleSet.h"
+
+#define LOCTEXT_NAMESPACE "SRevisionBisect"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRevisionBisect, Log, All);
+
+namespace RevisionBisectColumns
+{
+	static const FName Revision(TEXT("Revision"));
+	static const FName User(TEXT("User"));
+	static const FName Date(TEXT("Date"));
+	static const FName Value(TEXT("Value"));
+	static const FName Holds(TEXT("Holds"));
+}
+
+/** Same rendering as FTaggedPropertyTree, so values compare the same whether the revision stored them or not */
+static FString RenderDefaultValue(const FProperty* Property, const void* Value)
+{
+	if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		return BoolProperty->GetPropertyValue(Value) ? TEXT("True") : TEXT("False");
+	}
+	if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		return EnumProperty->GetEnum()->GetNameByValue(EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value)).ToString();
+	}
+	const FByteProperty* ByteProperty = CastField<FByteProperty>(Property);
+	if (ByteProperty && ByteProperty->Enum)
+	{
+		return ByteProperty->Enum->GetNameByValue(*static_cast<const uint8*>(Value)).ToString();
+	}
+	if (const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property))
+	{
+		return NumericProperty->IsFloatingPoint() ? FString::SanitizeFloat(NumericProperty->GetFloatingPointPropertyValue(Value)) : NumericProperty->GetNumericPropertyValueToString(Value);
+	}
+
+	FString Text;
+	Property->ExportText_Direct(Text, Value, nullptr, nullptr, PPF_None);
+	return Text;
+}
+
+/** Value at a tagged property path in the class defaults. Sub-object paths and elements past the default array aren't resolved */
+static bool ExportDefaultValue(const UClass* Class, const FString& Path, FString& OutValue)
+{
+	if (!Class || Path.Contains(TEXT(":")))
+	{
+		return false;
+	}
+
+	TArray<FString> Segments;
+	Path.ParseIntoArray(Segments, TEXT("."));
+	const UStruct* Struct = Class;
+	const void* Container = Class->GetDefaultObject();
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+	{
+		FString Name = Segments[SegmentIndex];
+		int32 Index = INDEX_NONE;
+		int32 BracketIndex = INDEX_NONE;
+		if (Name.FindChar(TEXT('['), BracketIndex))
+		{
+			LexFromString(Index, *Name.Mid(BracketIndex + 1));
+			Name.LeftInline(BracketIndex);
+		}
+
+		const FProperty* Property = FindFProperty<FProperty>(Struct, *Name);
+		if (!Property)
+		{
+			return false;
+		}
+
+		const void* Value = nullptr;
+		if (Index == INDEX_NONE)
+		{
+			Value = Property->ContainerPtrToValuePtr<void>(Container);
+		}
+		else if (Property->ArrayDim > 1)
+		{
+			if (Index >= Property->ArrayDim)
+			{
+				return false;
+			}
+			Value = Property->ContainerPtrToValuePtr<void>(Container, Index);
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper Helper(ArrayProperty, ArrayProperty->ContainerPtrToValuePtr<void>(Container));
+			if (!Helper.IsValidIndex(Index))
+			{
+				return false;
+			}
+			Property = ArrayProperty->Inner;
+			Value = Helper.GetRawPtr(Index);
+		}
+		else
+		{
+			return false;
+		}
+
+		if (SegmentIndex + 1 == Segments.Num())
+		{
+			OutValue = RenderDefaultValue(Property, Value);
+			return true;
+		}
+
+		const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+		if (!StructProperty)
+		{
+			return false;
+		}
+		Struct = StructProperty->Struct;
+		Container = Value;
+	}
+	return false;
+}
+
+FRevisionBisect::~FRevisionBisect()
+{
+	Cancel();
+}
+
+void FRevisionBisect::Start(const FString& InPackageFilename, const UClass* AssetClass, const FString& InPropertyPath, EBisectPredicate InPredicate, const FString& InOperand)
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	check(IsInGameThread() && !IsRunning());
+
+	PackageFilename = InPackageFilename;
+	PropertyPath = InPropertyPath;
+	Predicate = InPredicate;
+	Operand = InOperand;
+	Revisions.Reset();
+	NumRead = 0;
+	Low = INDEX_NONE;
+	High = INDEX_NONE;
+	bSkippedRevisions = false;
+	bCancelled = false;
+	Outcome = EOutcome::Running;
+
+	FString Default;
+	DefaultValue.Reset();
+	if (ExportDefaultValue(AssetClass, PropertyPath, Default))
+	{
+		DefaultValue = MoveTemp(Default);
+	}
+
+	ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+	if (PackageFilename.IsEmpty() || !ISourceControlModule::Get().IsEnabled() || !SourceControlProvider.IsAvailable())
+	{
+		FailureText = LOCTEXT("NoSourceControl", "Source control is not available for this asset");
+		Outcome = EOutcome::Failed;
+		return;
+	}
+
+	FSourceControlStatePtr State = SourceControlProvider.GetState(PackageFilename, EStateCacheUsage::Use);
+	if (State.IsValid() && State->GetHistorySize() > 0)
+	{
+		CollectRevisions();
+		return;
+	}
+
+	bQueryingHistory = true;
+	TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatusOp = ISourceControlOperation::Create<FUpdateStatus>();
+	UpdateStatusOp->SetUpdateHistory(true);
+	HistoryQueryJob = FSourceControlScheduler::Get().QueueOperation(UpdateStatusOp, { PackageFilename }, ESourceControlJobPriority::Interactive,
+		FSourceControlOperationComplete::CreateSP(this, &FRevisionBisect::OnHistoryUpdated));
+}
+
+void FRevisionBisect::Cancel()
+{
+	bCancelled = true;
+	if (bQueryingHistory)
+	{
+		FSourceControlScheduler::Get().Cancel(HistoryQueryJob);
+	}
+}
+
+void FRevisionBisect::OnHistoryUpdated(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult)
+{
+	bQueryingHistory = false;
+	HistoryQueryJob = 0;
+	if (bCancelled || InResult == ECommandResult::Cancelled)
+	{
+		Outcome = EOutcome::Cancelled;
+		return;
+	}
+
+	CollectRevisions();
+}
+
+void FRevisionBisect::CollectRevisions()
+{
+	FSourceControlStatePtr State = ISourceControlModule::Get().GetProvider().GetState(PackageFilename, EStateCacheUsage::Use);
+	if (State.IsValid())
+	{
+		// Histories are newest first
+		for (int32 HistoryIndex = State->GetHistorySize() - 1; HistoryIndex >= 0; --HistoryIndex)
+		{
+			TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision = State->GetHistoryItem(HistoryIndex);
+			if (Revision.IsValid())
+			{
+				Revisions.Add(Revision);
+			}
+		}
+	}
+
+	if (Revisions.Num() == 0)
+	{
+		FailureText = LOCTEXT("NoHistory", "The asset has no revision history");
+		Outcome = EOutcome::Failed;
+		return;
+	}
+
+	TSharedRef<FRevisionBisect> This = AsShared();
+	Async(EAsyncExecution::ThreadPool, [This]()
+		{
+			This->Run();
+		});
+}
+
+void FRevisionBisect::Run()
+{
+	LLM_SCOPE_BYTAG(AssetHistory);
+
+	// The predicate has to hold at the end of the history, the search narrows down to where it started to
+	const int32 Latest = Revisions.Num() - 1;
+	const TSharedPtr<FBisectStep> LatestStep = ReadStep(Latest);
+	if (bCancelled)
+	{
+		Outcome = EOutcome::Cancelled;
+		return;
+	}
+	if (!LatestStep->bRead)
+	{
+		FailureText = FText::Format(LOCTEXT("LatestUnreadable", "The latest revision {0} could not be fetched or read"), FText::FromString(LatestStep->Revision));
+		Outcome = EOutcome::Failed;
+		return;
+	}
+	if (!LatestStep->bHolds)
+	{
+		Outcome = EOutcome::NeverHolds;
+		return;
+	}
+
+	// Low stays before the history until a revision is found not to hold, so the oldest revision can be the answer
+	int32 LowIndex = INDEX_NONE;
+	int32 HighIndex = Latest;
+	High = HighIndex;
+	TSet<int32> Unreadable;
+	while (HighIndex - LowIndex > 1 && !bCancelled)
+	{
+		// Revisions that can't be read are stepped over, the probe moves to the closest readable one
+		const int32 Middle = LowIndex + (HighIndex - LowIndex) / 2;
+		int32 Probe = INDEX_NONE;
+		for (int32 Offset = 0; Probe == INDEX_NONE && Offset < HighIndex - LowIndex; ++Offset)
+		{
+			for (const int32 Candidate : { Middle + Offset, Middle - Offset })
+			{
+				if (Candidate > LowIndex && Candidate < HighIndex && !Unreadable.Contains(Candidate))
+				{
+					Probe = Candidate;
+					break;
+				}
+			}
+		}
+		if (Probe == INDEX_NONE)
+		{
+			bSkippedRevisions = true;
+			break;
+		}
+
+		const TSharedPtr<FBisectStep> Step = ReadStep(Probe);
+		if (!Step->bRead)
+		{
+			Unreadable.Add(Probe);
+		}
+		else if (Step->bHolds)
+		{
+			HighIndex = Probe;
+		}
+		else
+		{
+			LowIndex = Probe;
+		}
+		Low = LowIndex;
+		High = HighIndex;
+	}
+
+	Outcome = bCancelled ? EOutcome::Cancelled : EOutcome::Found;
+}
+
+TSharedPtr<FBisectStep> FRevisionBisect::ReadStep(int32 Index)
+{
+	const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision = Revisions[Index];
+	TSharedPtr<FBisectStep> Step = MakeShared<FBisectStep>();
+	Step->Revision = Revision->GetRevision();
+	Step->UserName = Revision->GetUserName();
+	Step->Date = Revision->GetDate();
+
+	// One revision at a time and the user waits on each
+	TArray64<uint8> Data;
+	FPackageFileReader Package;
+	FTaggedPropertyTree Tree;
+	Step->bRead = FSourceControlScheduler::Get().FetchRevisionData(Revision, ESourceControlJobPriority::Interactive, Data)
+		&& Package.OpenData(Revision->GetFilename(), MoveTemp(Data))
+		&& Tree.Read(Package);
+
+	if (Step->bRead)
+	{
+		// Tagged serialization skips values equal to the defaults
+		if (const FTaggedPropertyValue* Value = Tree.Find(PropertyPath))
+		{
+			Step->Value = Value->Value;
+		}
+		else
+		{
+			Step->Value = DefaultValue.Get(FString());
+			Step->bDefaultValue = true;
+		}
+		Step->bHolds = Evaluate(Predicate, Step->Value, Operand);
+	}
+	else
+	{
+		UE_LOG(LogRevisionBisect, Warning, TEXT("Skipped %s revision %s, it could not be fetched or read"), *PackageFilename, *Step->Revision);
+	}
+
+	++NumRead;
+	PendingSteps.Enqueue(Step);
+	return Step;
+}
+
+void FRevisionBisect::DequeueSteps(TArray<TSharedPtr<FBisectStep>>& OutSteps)
+{
+	TSharedPtr<FBisectStep> Step;
+	while (PendingSteps.Dequeue(Step))
+	{
+		OutSteps.Add(Step);
+	}
+}
+
+FText FRevisionBisect::GetStatusText() const
+{
+	switch (Outcome.Load())
+	{
+	case EOutcome::NotStarted:
+		return LOCTEXT("BisectIdle", "Finds the first revision where the property satisfies the condition, and keeps satisfying it after");
+	case EOutcome::Running:
+	{
+		if (bQueryingHistory)
+		{
+			return LOCTEXT("QueryingHistory", "Fetching the history...");
+		}
+		const int32 HighIndex = High.Load();
+		const int32 Remaining = HighIndex == INDEX_NONE ? Revisions.Num() : HighIndex - Low.Load() - 1;
+		return FText::Format(LOCTEXT("BisectRunning", "{0} of {1} revisions read, {2} left to search"),
+			FText::AsNumber(NumRead.Load()), FText::AsNumber(Revisions.Num()), FText::AsNumber(Remaining));
+	}
+	case EOutcome::Found:
+	{
+		const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision = Revisions[High.Load()];
+		const FText Found = FText::Format(LOCTEXT("BisectFound", "First satisfied at {0} by {1} on {2}, {3} of {4} revisions read"),
+			FText::FromString(Revision->GetRevision()), FText::FromString(Revision->GetUserName()), FText::AsDateTime(Revision->GetDate()),
+			FText::AsNumber(NumRead.Load()), FText::AsNumber(Revisions.Num()));
+		if (bSkippedRevisions)
+		{
+			return FText::Format(LOCTEXT("BisectFoundSkipped", "{0}. Revisions before it could not be read, it may have started earlier"), Found);
+		}
+		return Found;
+	}
+	case EOutcome::NeverHolds:
+		return FText::Format(LOCTEXT("BisectNeverHolds", "The latest revision {0} doesn't satisfy the condition"), FText::FromString(Revisions.Last()->GetRevision()));
+	case EOutcome::Failed:
+		return FailureText;
+	default:
+		return LOCTEXT("BisectCancelled", "Cancelled");
+	}
+}
+
+static bool ParseNumber(const FString& Text, double& OutNumber)
+{
+	return !Text.IsEmpty() && LexTryParseString(OutNumber, *Text);
+}
+
+/** Tagged trees name enum values with their type, EMyEnum::Value, the defaults and the user may not */
+static FString WithoutEnumType(const FString& Value)
+{
+	const int32 Index = Value.Find(TEXT("::"));
+	return Index == INDEX_NONE ? Value : Value.Mid(Index + 2);
+}
+
+bool FRevisionBisect::Evaluate(EBisectPredicate InPredicate, const FString& Value, const FString& InOperand)
+{
+	double Number = 0.0;
+	double OperandNumber = 0.0;
+	const bool bNumbers = ParseNumber(Value, Number) && ParseNumber(InOperand, OperandNumber);
+	switch (InPredicate)
+	{
+	case EBisectPredicate::Equals:
+		return bNumbers ? Number == OperandNumber : WithoutEnumType(Value).Equals(WithoutEnumType(InOperand), ESearchCase::IgnoreCase);
+	case EBisectPredicate::NotEquals:
+		return !Evaluate(EBisectPredicate::Equals, Value, InOperand);
+	case EBisectPredicate::Less:
+		return bNumbers && Number < OperandNumber;
+	case EBisectPredicate::Greater:
+		return bNumbers && Number > OperandNumber;
+	case EBisectPredicate::Contains:
+		return Value.Contains(InOperand);
+	}
+	return false;
+}
+
+FText FRevisionBisect::GetPredicateText(EBisectPredicate InPredicate)
+{
+	switch (InPredicate)
+	{
+	case EBisectPredicate::Equals: return LOCTEXT("PredicateEquals", "is");
+	case EBisectPredicate::NotEquals: return LOCTEXT("PredicateNotEquals", "is not");
+	case EBisectPredicate::Less: return LOCTEXT("PredicateLess", "is less than");
+	case EBisectPredicate::Greater: return LOCTEXT("PredicateGreater", "is greater than");
+	case EBisectPredicate::Contains: return LOCTEXT("PredicateContains", "contains");
+	}
+	return FText();
+}
+
+FString FRevisionBisect::FindPackageFilename(const UObject* Asset, const FString& Revision)
+{
+	if (!Asset->GetOutermost()->HasAnyPackageFlags(PKG_ForDiffing))
+	{
+		return SourceControlHelpers::PackageFilename(Asset->GetOutermost()->GetName());
+	}
+
+	FSourceControlStatePtr State = DiffExport::FindStateWithRevision(Asset->GetName(), Revision);
+	return State.IsValid() ? State->GetFilename() : FString();
+}
+
+class SBisectStepRow : public SMultiColumnTableRow<TSharedPtr<FBisectStep>>
+{
+public:
+	SLATE_BEGIN_ARGS(SBisectStepRow){}
+		SLATE_ARGUMENT(TSharedPtr<FBisectStep>, Item)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		SMultiColumnTableRow<TSharedPtr<FBisectStep>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		FText Text;
+		if (ColumnName == RevisionBisectColumns::Revision)
+		{
+			Text = FText::FromString(Item->Revision);
+		}
+		else if (ColumnName == RevisionBisectColumns::User)
+		{
+			Text = FText::FromString(Item->UserName);
+		}
+		else if (ColumnName == RevisionBisectColumns::Date)
+		{
+			Text = FText::AsDateTime(Item->Date);
+		}
+		else if (ColumnName == RevisionBisectColumns::Value)
+		{
+			Text = !Item->bRead ? FText()
+				: Item->bDefaultValue ? FText::Format(LOCTEXT("DefaultValue", "{0} (default)"), FText::FromString(Item->Value))
+				: FText::FromString(Item->Value);
+		}
+		else
+		{
+			Text = !Item->bRead ? LOCTEXT("StepUnreadable", "Could not be read") : Item->bHolds ? LOCTEXT("StepHolds", "Yes") : LOCTEXT("StepDoesNotHold", "No");
+		}
+
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+			];
+	}
+
+private:
+	TSharedPtr<FBisectStep> Item;
+};
+
+void SRevisionBisect::Construct(const FArguments& InArgs)
+{
+	PackageFilename = InArgs._PackageFilename;
+	AssetClass = InArgs._AssetClass;
+
+	this->ChildSlot
+		[
+			SNew(SBorder)
+			.BorderImage(FEditorStyle::GetBrush("Docking.Tab", ".ContentAreaBrush"))
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.FillWidth(1.0f)
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SAssignNew(PropertyPathBox, SEditableTextBox)
+						.Text(FText::FromString(InArgs._PropertyPath))
+						.HintText(LOCTEXT("PropertyPathHint", "Property path, e.g. Cooldown or Stats.Items[2].Name"))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SNew(SComboButton)
+						.OnGetMenuContent(this, &SRevisionBisect::MakePredicateMenu)
+						.ButtonContent()
+						[
+							SNew(STextBlock)
+							.Text_Lambda([this]() { return FRevisionBisect::GetPredicateText(Predicate); })
+						]
+					]
+					+ SHorizontalBox::Slot()
+					.FillWidth(0.5f)
+					.Padding(0.0f, 0.0f, 4.0f, 0.0f)
+					[
+						SAssignNew(OperandBox, SEditableTextBox)
+						.HintText(LOCTEXT("OperandHint", "Value, e.g. 0"))
+						.OnTextCommitted_Lambda([this](const FText&, ETextCommit::Type CommitType)
+							{
+								if (CommitType == ETextCommit::OnEnter && !(Bisect.IsValid() && Bisect->IsRunning()))
+								{
+									OnStartClicked();
+								}
+							})
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(this, &SRevisionBisect::GetStartButtonText)
+						.IsEnabled_Lambda([this]() { return (Bisect.IsValid() && Bisect->IsRunning()) || !PropertyPathBox->GetText().IsEmpty(); })
+						.OnClicked(this, &SRevisionBisect::OnStartClicked)
+					]
+				]
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f, 0.0f, 4.0f, 4.0f)
+				[
+					SNew(STextBlock)
+					.AutoWrapText(true)
+					.Text_Lambda([this]()
+						{
+							return Bisect.IsValid() ? Bisect->GetStatusText()
+								: LOCTEXT("BisectHelp", "Finds the first revision where the property satisfies the condition, reading about log2 of the history's revisions");
+						})
+				]
+				+ SVerticalBox::Slot()
+				[
+					SNew(SBorder)
+					.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+					[
+						SAssignNew(StepListView, SListView<TSharedPtr<FBisectStep>>)
+						.ListItemsSource(&Steps)
+						.OnGenerateRow(this, &SRevisionBisect::OnGenerateRow)
+						.SelectionMode(ESelectionMode::Single)
+						.HeaderRow
+						(
+							SNew(SHeaderRow)
+							+ SHeaderRow::Column(RevisionBisectColumns::Revision)
+							.DefaultLabel(LOCTEXT("RevisionColumn", "Revision"))
+							.ManualWidth(90.0f)
+							+ SHeaderRow::Column(RevisionBisectColumns::User)
+							.DefaultLabel(LOCTEXT("UserColumn", "User"))
+							.ManualWidth(120.0f)
+							+ SHeaderRow::Column(RevisionBisectColumns::Date)
+							.DefaultLabel(LOCTEXT("DateColumn", "Date"))
+							.ManualWidth(140.0f)
+							+ SHeaderRow::Column(RevisionBisectColumns::Value)
+							.DefaultLabel(LOCTEXT("ValueColumn", "Value"))
+							+ SHeaderRow::Column(RevisionBisectColumns::Holds)
+							.DefaultLabel(LOCTEXT("HoldsColumn", "Satisfied"))
+							.ManualWidth(100.0f)
+						)
+					]
+				]
+			]
+		];
+}
+
+SRevisionBisect::~SRevisionBisect()
+{
+	if (Bisect.IsValid())
+	{
+		Bisect->Cancel();
+	}
+}
+
+TSharedPtr<SWindow> SRevisionBisect::CreateBisectWindow(const FString& PackageFilename, const UClass* AssetClass, const FString& PropertyPath)
+{
+	TSharedPtr<SWindow> Window = SNew(SWindow)
+		.Title(FText::Format(LOCTEXT("BisectWindowTitle", "Bisect {0}"), FText::FromString(FPaths::GetBaseFilename(PackageFilename))))
+		.ClientSize(FVector2D(800, 400));
+
+	Window->SetContent(SNew(SRevisionBisect)
+		.PackageFilename(PackageFilename)
+		.AssetClass(AssetClass)
+		.PropertyPath(PropertyPath));
+
+	TSharedPtr<SWindow> ActiveModal = FSlateApplication::Get().GetActiveModalWindow();
+	if (ActiveModal.IsValid())
+	{
+		FSlateApplication::Get().AddWindowAsNativeChild(Window.ToSharedRef(), ActiveModal.ToSharedRef());
+	}
+	else
+	{
+		FSlateApplication::Get().AddWindow(Window.ToSharedRef());
+	}
+
+	return Window;
+}
+
+FReply SRevisionBisect::OnStartClicked()
+{
+	if (Bisect.IsValid() && Bisect->IsRunning())
+	{
+		Bisect->Cancel();
+		return FReply::Handled();
+	}
+
+	const FString PropertyPath = PropertyPathBox->GetText().ToString().TrimStartAndEnd();
+	if (PropertyPath.IsEmpty())
+	{
+		return FReply::Handled();
+	}
+
+	Steps.Reset();
+	StepListView->RequestListRefresh();
+
+	// A fresh bisect each time, a cancelled one may still be waiting on its fetch
+	Bisect = MakeShared<FRevisionBisect>();
+	Bisect->Start(PackageFilename, AssetClass.Get(), PropertyPath, Predicate, OperandBox->GetText().ToString().TrimStartAndEnd());
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SRevisionBisect::PollSteps));
+	return FReply::Handled();
+}
+
+FText SRevisionBisect::GetStartButtonText() const
+{
+	return Bisect.IsValid() && Bisect->IsRunning() ? LOCTEXT("CancelBisect", "Cancel") : LOCTEXT("StartBisect", "Bisect");
+}
+
+TSharedRef<SWidget> SRevisionBisect::MakePredicateMenu()
+{
+	FMenuBuilder MenuBuilder(true, nullptr);
+	for (const EBisectPredicate Candidate : { EBisectPredicate::Equals, EBisectPredicate::NotEquals, EBisectPredicate::Less, EBisectPredicate::Greater, EBisectPredicate::Contains })
+	{
+		MenuBuilder.AddMenuEntry(FRevisionBisect::GetPredicateText(Candidate), FText(), FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this, Candidate]() { Predicate = Candidate; })));
+	}
+	return MenuBuilder.MakeWidget();
+}
+
+EActiveTimerReturnType SRevisionBisect::PollSteps(double InCurrentTime, float InDeltaTime)
+{
+	if (!Bisect.IsValid())
+	{
+		return EActiveTimerReturnType::Stop;
+	}
+
+	const bool bStillRunning = Bisect->IsRunning();
+	const int32 NumSteps = Steps.Num();
+	Bisect->DequeueSteps(Steps);
+	if (Steps.Num() != NumSteps)
+	{
+		StepListView->RequestListRefresh();
+	}
+	return bStillRunning ? EActiveTimerReturnType::Continue : EActiveTimerReturnType::Stop;
+}
+
+TSharedRef<ITableRow> SRevisionBisect::OnGenerateRow(TSharedPtr<FBisectStep> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SBisectStepRow, OwnerTable)
+		.Item(Item);
+}
+
+#undef LOCTEXT_NAMESPACE
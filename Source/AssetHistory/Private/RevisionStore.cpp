@@ -0,0 +1,649 @@
+
+#include "RevisionStore.h"
+#include "AssetHistoryMemory.h"
+#include "GitBatchFetcher.h"
+#include "CanonicalText.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Compression.h"
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/LargeMemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRevisionStore, Log, All);
+
+static const uint32 RevisionStoreMagic = 0x52485341;
+static const int32 RevisionStoreVersion = 1;
+/** Past this many deltas a new snapshot is taken, even if the deltas stay small */
+static constexpr int32 MaxDeltasPerSnapshot = 16;
+static constexpr int32 MaxCachedSnapshots = 4;
+/** Smaller finds more matches in shuffled exports, larger keeps the base table small */
+static constexpr int32 DeltaBlockSize = 32;
+static constexpr uint32 RollingHashPrime = 16777619u;
+
+static void WriteVarint(TArray64<uint8>& Out, uint64 Value)
+{
+	do
+	{
+		uint8 Byte = Value & 0x7f;
+		Value >>= 7;
+		Out.Add(Byte | (Value ? 0x80 : 0));
+	} while (Value);
+}
+
+static bool ReadVarint(TArrayView64<const uint8> Data, int64& Pos, uint64& OutValue)
+{
+	OutValue = 0;
+	for (int32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		if (Pos >= Data.Num())
+		{
+			return false;
+		}
+		const uint8 Byte = Data[Pos++];
+		OutValue |= uint64(Byte & 0x7f) << Shift;
+		if (!(Byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static uint32 HashBlock(const uint8* Data)
+{
+	uint32 Hash = 0;
+	for (int32 Index = 0; Index < DeltaBlockSize; ++Index)
+	{
+		Hash = Hash * RollingHashPrime + Data[Index];
+	}
+	return Hash;
+}
+
+void RevisionDelta::Encode(TArrayView64<const uint8> Base, TArrayView64<const uint8> Target, TArray64<uint8>& OutDelta)
+{
+	OutDelta.Reset();
+	WriteVarint(OutDelta, Target.Num());
+
+	const uint8* BaseData = Base.GetData();
+	const uint8* TargetData = Target.GetData();
+	const int64 BaseNum = Base.Num();
+	const int64 TargetNum = Target.Num();
+
+	// Ops are (Length << 1 | bIsCopy), followed by the base offset for copies or the literal bytes for inserts
+	auto EmitInsert = [&OutDelta, TargetData](int64 Start, int64 End)
+	{
+		if (End > Start)
+		{
+			WriteVarint(OutDelta, uint64(End - Start) << 1);
+			OutDelta.Append(TargetData + Start, End - Start);
+		}
+	};
+
+	if (BaseNum < DeltaBlockSize || TargetNum < DeltaBlockSize)
+	{
+		EmitInsert(0, TargetNum);
+		return;
+	}
+
+	// Aligned blocks of the base, keeping the first occurrence of each hash
+	TMap<uint32, int64> BaseBlocks;
+	BaseBlocks.Reserve(BaseNum / DeltaBlockSize);
+	for (int64 Offset = 0; Offset + DeltaBlockSize <= BaseNum; Offset += DeltaBlockSize)
+	{
+		const uint32 Hash = HashBlock(BaseData + Offset);
+		if (!BaseBlocks.Contains(Hash))
+		{
+			BaseBlocks.Add(Hash, Offset);
+		}
+	}
+
+	uint32 OutgoingFactor = 1;
+	for (int32 Index = 1; Index < DeltaBlockSize; ++Index)
+	{
+		OutgoingFactor *= RollingHashPrime;
+	}
+
+	int64 LiteralStart = 0;
+	int64 Pos = 0;
+	uint32 Hash = HashBlock(TargetData);
+	while (Pos + DeltaBlockSize <= TargetNum)
+	{
+		const int64* BaseOffset = BaseBlocks.Find(Hash);
+		if (BaseOffset && FMemory::Memcmp(BaseData + *BaseOffset, TargetData + Pos, DeltaBlockSize) == 0)
+		{
+			// Grow the match both ways, backwards only into bytes not yet emitted
+			int64 CopyBase = *BaseOffset;
+			int64 CopyTarget = Pos;
+			while (CopyTarget > LiteralStart && CopyBase > 0 && BaseData[CopyBase - 1] == TargetData[CopyTarget - 1])
+			{
+				--CopyBase;
+				--CopyTarget;
+			}
+			int64 Length = Pos + DeltaBlockSize - CopyTarget;
+			while (CopyTarget + Length < TargetNum && CopyBase + Length < BaseNum && BaseData[CopyBase + Length] == TargetData[CopyTarget + Length])
+			{
+				++Length;
+			}
+
+			EmitInsert(LiteralStart, CopyTarget);
+			WriteVarint(OutDelta, (uint64(Length) << 1) | 1);
+			WriteVarint(OutDelta, CopyBase);
+
+			Pos = CopyTarget + Length;
+			LiteralStart = Pos;
+			if (Pos + DeltaBlockSize <= TargetNum)
+			{
+				Hash = HashBlock(TargetData + Pos);
+			}
+			continue;
+		}
+
+		if (Pos + DeltaBlockSize < TargetNum)
+		{
+			Hash = (Hash - TargetData[Pos] * OutgoingFactor) * RollingHashPrime + TargetData[Pos + DeltaBlockSize];
+		}
+		++Pos;
+	}
+	EmitInsert(LiteralStart, TargetNum);
+}
+
+bool RevisionDelta::Apply(TArrayView64<const uint8> Base, TArrayView64<const uint8> Delta, TArray64<uint8>& OutTarget)
+{
+	int64 Pos = 0;
+	uint64 TargetNum = 0;
+	// Same limit as ReadCompressed, a damaged file mustn't ask for an allocation that aborts the editor
+	if (!ReadVarint(Delta, Pos, TargetNum) || TargetNum > MAX_int32)
+	{
+		return false;
+	}
+
+	OutTarget.Reset(TargetNum);
+	while (Pos < Delta.Num())
+	{
+		uint64 Op = 0;
+		if (!ReadVarint(Delta, Pos, Op))
+		{
+			return false;
+		}
+
+		const uint64 Length = Op >> 1;
+		if (Op & 1)
+		{
+			uint64 Offset = 0;
+			if (!ReadVarint(Delta, Pos, Offset) || Length > uint64(Base.Num()) || Offset > uint64(Base.Num()) - Length)
+			{
+				return false;
+			}
+			OutTarget.Append(Base.GetData() + Offset, Length);
+		}
+		else
+		{
+			if (Length > uint64(Delta.Num() - Pos))
+			{
+				return false;
+			}
+			OutTarget.Append(Delta.GetData() + Pos, Length);
+			Pos += Length;
+		}
+	}
+	return uint64(OutTarget.Num()) == TargetNum;
+}
+
+static FString SanitizeRevision(const FString& Revision)
+{
+	FString Result = Revision;
+	for (TCHAR& Char : Result)
+	{
+		if (!FChar::IsAlnum(Char) && Char != TEXT('-') && Char != TEXT('_'))
+		{
+			Char = TEXT('_');
+		}
+	}
+	return Result;
+}
+
+bool RevisionStoreFile::WriteCompressed(const FString& Filename, TArrayView64<const uint8> Payload, int64& OutStoredSize)
+{
+	if (Payload.Num() > MAX_int32)
+	{
+		return false;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, (int32)Payload.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Payload.GetData(), (int32)Payload.Num()))
+	{
+		return false;
+	}
+
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	uint32 Magic = RevisionStoreMagic;
+	int64 PayloadSize = Payload.Num();
+	Writer << Magic << PayloadSize << CompressedSize;
+	FileData.Append(Compressed.GetData(), CompressedSize);
+
+	OutStoredSize = FileData.Num();
+	return SaveAtomically(FileData, Filename);
+}
+
+bool RevisionStoreFile::ReadCompressed(const FString& Filename, TArray64<uint8>& OutPayload)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(FileData);
+	uint32 Magic = 0;
+	int64 PayloadSize = 0;
+	int32 CompressedSize = 0;
+	Reader << Magic << PayloadSize << CompressedSize;
+	if (Reader.IsError() || Magic != RevisionStoreMagic || PayloadSize < 0 || PayloadSize > MAX_int32 || CompressedSize != FileData.Num() - Reader.Tell())
+	{
+		UE_LOG(LogRevisionStore, Warning, TEXT("%s is not a valid revision store file"), *Filename);
+		return false;
+	}
+
+	OutPayload.SetNumUninitialized(PayloadSize);
+	return FCompression::UncompressMemory(NAME_Zlib, OutPayload.GetData(), (int32)PayloadSize, FileData.GetData() + Reader.Tell(), CompressedSize);
+}
+
+uint64 RevisionStoreFile::HashPackagePath(const FString& PackageFilename)
+{
+	const FString LowerPath = FPaths::ConvertRelativePathToFull(PackageFilename).ToLower();
+	return CityHash64(reinterpret_cast<const char*>(*LowerPath), LowerPath.Len() * sizeof(TCHAR));
+}
+
+bool RevisionStoreFile::SaveAtomically(TArrayView64<const uint8> Data, const FString& Filename)
+{
+	const FString TempFilename = FString::Printf(TEXT("%s.%s.tmp"), *Filename, *FGuid::NewGuid().ToString());
+	if (!FFileHelper::SaveArrayToFile(Data, *TempFilename))
+	{
+		return false;
+	}
+	if (!IFileManager::Get().Move(*Filename, *TempFilename, true, false, false, true))
+	{
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+		return false;
+	}
+	return true;
+}
+
+bool RevisionStoreFile::WriteTempPackage(const FString& PackageFilename, const FString& Suffix, TArrayView64<const uint8> Data, FString& OutFilename)
+{
+	// Named like the files the providers write, so LoadPackage and the readers treat it the same way
+	OutFilename = FPaths::DiffDir() / TEXT("AssetHistory") / FString::Printf(TEXT("%s_%016llx-%s%s"),
+		*FPaths::GetBaseFilename(PackageFilename), HashPackagePath(PackageFilename), *Suffix, *FPaths::GetExtension(PackageFilename, true));
+
+	auto HoldsData = [&OutFilename, Data]()
+	{
+		TArray64<uint8> Existing;
+		return IFileManager::Get().FileSize(*OutFilename) == Data.Num()
+			&& FFileHelper::LoadFileToArray(Existing, *OutFilename, FILEREAD_Silent)
+			&& FMemory::Memcmp(Existing.GetData(), Data.GetData(), Data.Num()) == 0;
+	};
+	// When the rename fails the file is likely open in a loaded package, which is fine if another writer got the same bytes there first
+	return HoldsData() || SaveAtomically(Data, OutFilename) || HoldsData();
+}
+
+template<typename EntryType>
+static bool LoadIndexFile(const FString& Filename, TArray<EntryType>& OutEntries)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(FileData);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != RevisionStoreMagic || Version != RevisionStoreVersion)
+	{
+		return false;
+	}
+
+	Reader << OutEntries;
+	if (Reader.IsError())
+	{
+		OutEntries.Reset();
+		return false;
+	}
+	return true;
+}
+
+static FString GetStoreRoot()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AssetHistory") / TEXT("Revisions");
+}
+
+FRevisionStore& FRevisionStore::Get()
+{
+	static FRevisionStore Store;
+	return Store;
+}
+
+bool FRevisionStore::GetRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, FString& OutFilename)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	TArray64<uint8> Data;
+	return GetRevisionData(Revision, Data) && WriteRevisionFile(Revision, Data, OutFilename);
+}
+
+bool FRevisionStore::WriteRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArrayView64<const uint8> Data, FString& OutFilename)
+{
+	return RevisionStoreFile::WriteTempPackage(Revision->GetFilename(), SanitizeRevision(Revision->GetRevision()), Data, OutFilename);
+}
+
+bool FRevisionStore::GetRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArray64<uint8>& OutData, bool bAllowProviderDownload)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	if (!Revision.IsValid())
+	{
+		return false;
+	}
+
+	const FString PackageFilename = Revision->GetFilename();
+	const FString RevisionName = Revision->GetRevision();
+	if (ReadRevision(PackageFilename, RevisionName, OutData))
+	{
+		return true;
+	}
+
+	// Git streams blobs through a long lived cat-file, the provider would spawn git and write a temp file per revision
+	if (!GitBatchFetcher::FetchRevision(*Revision, OutData) && (!bAllowProviderDownload || !DownloadRevisionData(Revision, OutData)))
+	{
+		return false;
+	}
+
+	AddRevision(PackageFilename, RevisionName, OutData);
+	return true;
+}
+
+bool FRevisionStore::DownloadRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArray64<uint8>& OutData)
+{
+	check(IsInGameThread());
+
+	FString DownloadedFilename;
+	return Revision->Get(DownloadedFilename) && FFileHelper::LoadFileToArray(OutData, *DownloadedFilename, FILEREAD_Silent);
+}
+
+bool FRevisionStore::Contains(const FString& PackageFilename, const FString& Revision)
+{
+	FScopeLock ScopeLock(&Lock);
+	return FindOrLoadIndex(PackageFilename).Entries.ContainsByPredicate([&Revision](const FEntry& Entry) { return Entry.Revision == Revision; });
+}
+
+bool FRevisionStore::ReadRevision(const FString& PackageFilename, const FString& Revision, TArray64<uint8>& OutData)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	FString SnapshotFilename;
+	FString DeltaFilename;
+	{
+		FScopeLock ScopeLock(&Lock);
+		const FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+		const int32 EntryIndex = Index.Entries.IndexOfByPredicate([&Revision](const FEntry& Entry) { return Entry.Revision == Revision; });
+		if (EntryIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FEntry& Entry = Index.Entries[EntryIndex];
+		if (Entry.SnapshotIndex == INDEX_NONE)
+		{
+			SnapshotFilename = GetEntryFilename(Index, EntryIndex);
+		}
+		else
+		{
+			SnapshotFilename = GetEntryFilename(Index, Entry.SnapshotIndex);
+			DeltaFilename = GetEntryFilename(Index, EntryIndex);
+		}
+	}
+
+	TSharedPtr<const TArray64<uint8>> Snapshot = ReadSnapshot(SnapshotFilename);
+	if (!Snapshot.IsValid())
+	{
+		return false;
+	}
+
+	if (DeltaFilename.IsEmpty())
+	{
+		OutData = *Snapshot;
+		return true;
+	}
+
+	TArray64<uint8> Delta;
+	if (!RevisionStoreFile::ReadCompressed(DeltaFilename, Delta) || !RevisionDelta::Apply(*Snapshot, Delta, OutData))
+	{
+		UE_LOG(LogRevisionStore, Warning, TEXT("Failed to rebuild revision %s of %s"), *Revision, *PackageFilename);
+		return false;
+	}
+	return true;
+}
+
+bool FRevisionStore::AddRevision(const FString& PackageFilename, const FString& Revision, TArrayView64<const uint8> Data)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	auto FindEntry = [&Revision](const FEntry& Entry) { return Entry.Revision == Revision; };
+
+	int32 SnapshotIndex = INDEX_NONE;
+	FString SnapshotFilename;
+	{
+		FScopeLock ScopeLock(&Lock);
+		const FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+		if (Index.Entries.ContainsByPredicate(FindEntry))
+		{
+			return true;
+		}
+
+		SnapshotIndex = Index.Entries.FindLastByPredicate([](const FEntry& Entry) { return Entry.SnapshotIndex == INDEX_NONE; });
+		if (SnapshotIndex != INDEX_NONE)
+		{
+			const int32 NumDeltas = Index.Entries.FilterByPredicate([SnapshotIndex](const FEntry& Entry) { return Entry.SnapshotIndex == SnapshotIndex; }).Num();
+			if (NumDeltas < MaxDeltasPerSnapshot)
+			{
+				SnapshotFilename = GetEntryFilename(Index, SnapshotIndex);
+			}
+		}
+	}
+
+	// Encoding runs outside the lock, other files and readers don't wait on it
+	TArray64<uint8> Delta;
+	bool bIsSnapshot = true;
+	if (!SnapshotFilename.IsEmpty())
+	{
+		if (TSharedPtr<const TArray64<uint8>> Snapshot = ReadSnapshot(SnapshotFilename))
+		{
+			RevisionDelta::Encode(*Snapshot, Data, Delta);
+			// A delta this large means the file drifted away from its snapshot, start a new one
+			bIsSnapshot = Delta.Num() > Data.Num() / 4;
+		}
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+	if (Index.Entries.ContainsByPredicate(FindEntry))
+	{
+		return true;
+	}
+
+	FEntry Entry;
+	Entry.Revision = Revision;
+	Entry.SnapshotIndex = bIsSnapshot ? INDEX_NONE : SnapshotIndex;
+	Entry.RawSize = Data.Num();
+
+	const int32 EntryIndex = Index.Entries.Add(Entry);
+	const FString EntryFilename = GetEntryFilename(Index, EntryIndex);
+	// Texts are found by entry number only: one left over from a lost index belongs to another revision
+	IFileManager::Get().Delete(*FPaths::ChangeExtension(EntryFilename, TEXT("txt")), false, false, true);
+	if (!RevisionStoreFile::WriteCompressed(EntryFilename, bIsSnapshot ? Data : TArrayView64<const uint8>(Delta), Index.Entries[EntryIndex].StoredSize))
+	{
+		UE_LOG(LogRevisionStore, Warning, TEXT("Failed to store revision %s of %s"), *Revision, *PackageFilename);
+		Index.Entries.RemoveAt(EntryIndex);
+		return false;
+	}
+	SaveIndex(Index);
+
+	if (bIsSnapshot)
+	{
+		// Warm-up usually stores consecutive revisions next, which will be deltas against this one
+		SnapshotCache.Insert(TPair<FString, TSharedPtr<const TArray64<uint8>>>(EntryFilename, MakeShared<TArray64<uint8>>(Data)), 0);
+		SnapshotCache.SetNum(FMath::Min(SnapshotCache.Num(), MaxCachedSnapshots));
+	}
+	return true;
+}
+
+bool FRevisionStore::ReadRevisionText(const FString& PackageFilename, const FString& Revision, TArray64<uint8>& OutText)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_Caches);
+
+	FString TextFilename;
+	{
+		FScopeLock ScopeLock(&Lock);
+		const FFileIndex& Index = FindOrLoadIndex(PackageFilename);
+		const int32 EntryIndex = Index.Entries.IndexOfByPredicate([&Revision](const FEntry& Entry) { return Entry.Revision == Revision; });
+		if (EntryIndex == INDEX_NONE)
+		{
+			return false;
+		}
+		TextFilename = FPaths::ChangeExtension(GetEntryFilename(Index, EntryIndex), TEXT("txt"));
+	}
+
+	// A text from before a format change is rebuilt, like one that went missing
+	if (RevisionStoreFile::ReadCompressed(TextFilename, OutText) && CanonicalText::HasCurrentHeader(OutText))
+	{
+		return true;
+	}
+
+	TArray64<uint8> Data;
+	if (!ReadRevision(PackageFilename, Revision, Data))
+	{
+		return false;
+	}
+
+	FLargeMemoryWriter Writer;
+	if (!CanonicalText::WritePackageData(PackageFilename, MoveTemp(Data), Writer))
+	{
+		return false;
+	}
+	OutText = TArray64<uint8>(Writer.GetData(), Writer.TotalSize());
+
+	// Not in the index or the stats, it is rebuilt from the revision whenever it goes missing.
+	// Written outside the lock, two threads may build the same one: the atomic write keeps either whole
+	int64 StoredSize = 0;
+	RevisionStoreFile::WriteCompressed(TextFilename, OutText, StoredSize);
+	return true;
+}
+
+void FRevisionStore::GetStats(int64& OutStoredBytes, int64& OutRawBytes)
+{
+	OutStoredBytes = 0;
+	OutRawBytes = 0;
+
+	TArray<FString> IndexFilenames;
+	IFileManager::Get().FindFilesRecursive(IndexFilenames, *GetStoreRoot(), TEXT("Index.bin"), true, false);
+	for (const FString& IndexFilename : IndexFilenames)
+	{
+		TArray<FEntry> Entries;
+		LoadIndexFile(IndexFilename, Entries);
+		for (const FEntry& Entry : Entries)
+		{
+			OutStoredBytes += Entry.StoredSize;
+			OutRawBytes += Entry.RawSize;
+		}
+	}
+}
+
+SIZE_T FRevisionStore::GetAllocatedSize()
+{
+	FScopeLock ScopeLock(&Lock);
+	SIZE_T Size = Indices.GetAllocatedSize() + SnapshotCache.GetAllocatedSize();
+	for (const TPair<FString, FFileIndex>& Index : Indices)
+	{
+		Size += Index.Key.GetAllocatedSize() + Index.Value.Directory.GetAllocatedSize() + Index.Value.Entries.GetAllocatedSize();
+		for (const FEntry& Entry : Index.Value.Entries)
+		{
+			Size += Entry.Revision.GetAllocatedSize();
+		}
+	}
+	for (const TPair<FString, TSharedPtr<const TArray64<uint8>>>& Cached : SnapshotCache)
+	{
+		Size += Cached.Key.GetAllocatedSize() + Cached.Value->GetAllocatedSize();
+	}
+	return Size;
+}
+
+FRevisionStore::FFileIndex& FRevisionStore::FindOrLoadIndex(const FString& PackageFilename)
+{
+	const FString Key = FPaths::ConvertRelativePathToFull(PackageFilename);
+	if (FFileIndex* Index = Indices.Find(Key))
+	{
+		return *Index;
+	}
+
+	// One directory per file, the hash keeps same named assets in different folders apart
+	FFileIndex& Index = Indices.Add(Key);
+	Index.Directory = GetStoreRoot() / FString::Printf(TEXT("%s_%016llx"), *FPaths::GetBaseFilename(Key), RevisionStoreFile::HashPackagePath(Key));
+	LoadIndexFile(Index.Directory / TEXT("Index.bin"), Index.Entries);
+	return Index;
+}
+
+void FRevisionStore::SaveIndex(const FFileIndex& Index)
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	uint32 Magic = RevisionStoreMagic;
+	int32 Version = RevisionStoreVersion;
+	Writer << Magic << Version;
+	Writer << const_cast<TArray<FEntry>&>(Index.Entries);
+
+	// A truncated index would hand out entry numbers that existing files already use
+	if (!RevisionStoreFile::SaveAtomically(FileData, Index.Directory / TEXT("Index.bin")))
+	{
+		UE_LOG(LogRevisionStore, Warning, TEXT("Failed to save the revision index in %s"), *Index.Directory);
+	}
+}
+
+TSharedPtr<const TArray64<uint8>> FRevisionStore::ReadSnapshot(const FString& Filename)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		const int32 CacheIndex = SnapshotCache.IndexOfByPredicate([&Filename](const TPair<FString, TSharedPtr<const TArray64<uint8>>>& Cached) { return Cached.Key == Filename; });
+		if (CacheIndex != INDEX_NONE)
+		{
+			TPair<FString, TSharedPtr<const TArray64<uint8>>> Cached = SnapshotCache[CacheIndex];
+			SnapshotCache.RemoveAt(CacheIndex);
+			SnapshotCache.Insert(Cached, 0);
+			return Cached.Value;
+		}
+	}
+
+	TSharedPtr<TArray64<uint8>> Snapshot = MakeShared<TArray64<uint8>>();
+	if (!RevisionStoreFile::ReadCompressed(Filename, *Snapshot))
+	{
+		return nullptr;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	SnapshotCache.Insert(TPair<FString, TSharedPtr<const TArray64<uint8>>>(Filename, Snapshot), 0);
+	SnapshotCache.SetNum(FMath::Min(SnapshotCache.Num(), MaxCachedSnapshots));
+	return Snapshot;
+}
+
+FString FRevisionStore::GetEntryFilename(const FFileIndex& Index, int32 EntryIndex) const
+{
+	const FEntry& Entry = Index.Entries[EntryIndex];
+	return Index.Directory / FString::Printf(TEXT("%d_%s.%s"), EntryIndex, *SanitizeRevision(Entry.Revision), Entry.SnapshotIndex == INDEX_NONE ? TEXT("snap") : TEXT("delta"));
+}
@@ -0,0 +1,372 @@
+
+#include "SourceControlScheduler.h"
+#include "AssetHistoryMemory.h"
+#include "AssetHistorySettings.h"
+#include "RevisionStore.h"
+#include "ChurnStatistics.h"
+#include "ISourceControlModule.h"
+#include "SourceControlOperations.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/Event.h"
+#include "Async/Async.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSourceControlScheduler, Log, All);
+
+/** Only read-only queries are merged, two checkouts of the same file are still two requests */
+static FString MakeOperationKey(const FSourceControlOperationRef& Operation, const TArray<FString>& Files)
+{
+	if (Operation->GetName() != TEXT("UpdateStatus"))
+	{
+		return FString();
+	}
+
+	TArray<FString> SortedFiles = Files;
+	SortedFiles.Sort();
+	const TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatus = StaticCastSharedRef<FUpdateStatus>(Operation);
+	return FString::Printf(TEXT("UpdateStatus%s|%s"), UpdateStatus->ShouldUpdateHistory() ? TEXT("+History") : TEXT(""), *FString::Join(SortedFiles, TEXT("|")));
+}
+
+FSourceControlScheduler& FSourceControlScheduler::Get()
+{
+	static FSourceControlScheduler Scheduler;
+	return Scheduler;
+}
+
+FSourceControlJobId FSourceControlScheduler::QueueOperation(const FSourceControlOperationRef& Operation, const TArray<FString>& Files, ESourceControlJobPriority::Type Priority, const FSourceControlOperationComplete& OnComplete)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_SourceControl);
+
+	check(IsInGameThread());
+
+	TSharedRef<FJob> Job = MakeShared<FJob>();
+	Job->Priority = Priority;
+	Job->DedupeKey = MakeOperationKey(Operation, Files);
+	Job->Operation = Operation;
+	Job->Files = Files;
+
+	FRequest Request;
+	Request.OnOperationComplete = OnComplete;
+	return AddRequest(Job, MoveTemp(Request));
+}
+
+FSourceControlJobId FSourceControlScheduler::QueueRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, const FOnRevisionDataReady& OnReady)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_SourceControl);
+
+	check(Revision.IsValid());
+
+	TSharedRef<FJob> Job = MakeShared<FJob>();
+	Job->Priority = Priority;
+	Job->DedupeKey = FString::Printf(TEXT("Revision|%s|%s"), *Revision->GetFilename(), *Revision->GetRevision());
+	Job->Revision = Revision;
+
+	FRequest Request;
+	Request.OnRevisionDataReady = OnReady;
+	return AddRequest(Job, MoveTemp(Request));
+}
+
+bool FSourceControlScheduler::FetchRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, TArray64<uint8>& OutData)
+{
+	if (!Revision.IsValid())
+	{
+		return false;
+	}
+
+	// Jobs download through the provider on the game thread and operations hold the concurrency slots until the game thread
+	// completes them: a blocked game thread would wait forever, so it fetches right here
+	if (IsInGameThread())
+	{
+		return FRevisionStore::Get().GetRevisionData(Revision, OutData);
+	}
+
+	// The callback runs on a pool worker, never on this thread, so waiting here can't deadlock
+	struct FFetchState
+	{
+		FEvent* Done = FPlatformProcess::GetSynchEventFromPool(true);
+		bool bSuccess = false;
+		TArray64<uint8> Data;
+		~FFetchState() { FPlatformProcess::ReturnSynchEventToPool(Done); }
+	};
+	TSharedRef<FFetchState, ESPMode::ThreadSafe> State = MakeShared<FFetchState, ESPMode::ThreadSafe>();
+
+	QueueRevisionData(Revision, Priority, FOnRevisionDataReady::CreateLambda([State](bool bSuccess, const TArray64<uint8>& Data)
+		{
+			State->bSuccess = bSuccess;
+			State->Data = Data;
+			State->Done->Trigger();
+		}));
+	State->Done->Wait();
+
+	OutData = MoveTemp(State->Data);
+	return State->bSuccess;
+}
+
+bool FSourceControlScheduler::FetchRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, FString& OutFilename)
+{
+	TArray64<uint8> Data;
+	return FetchRevisionData(Revision, Priority, Data) && FRevisionStore::WriteRevisionFile(Revision, Data, OutFilename);
+}
+
+FSourceControlJobId FSourceControlScheduler::AddRequest(TSharedRef<FJob> NewJob, FRequest&& Request)
+{
+	FSourceControlJobId JobId = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		JobId = Request.Id = ++LastJobId;
+
+		if (!NewJob->DedupeKey.IsEmpty())
+		{
+			if (TSharedRef<FJob>* ExistingJob = JobsByKey.Find(NewJob->DedupeKey))
+			{
+				// A queued job takes the priority of its most urgent request, a running one is already as early as it gets
+				(*ExistingJob)->Requests.Add(MoveTemp(Request));
+				(*ExistingJob)->Priority = FMath::Max((*ExistingJob)->Priority, NewJob->Priority);
+				UE_LOG(LogSourceControlScheduler, Verbose, TEXT("Merged request %llu into %s"), JobId, *NewJob->DedupeKey);
+				return JobId;
+			}
+			JobsByKey.Add(NewJob->DedupeKey, NewJob);
+		}
+
+		NewJob->Sequence = ++LastSequence;
+		NewJob->Requests.Add(MoveTemp(Request));
+		PendingJobs.Add(NewJob);
+	}
+
+	// Interactive requests start right here rather than on the next tick
+	StartJobs();
+	return JobId;
+}
+
+void FSourceControlScheduler::StartJobs()
+{
+	const bool bIsGameThread = IsInGameThread();
+	const int32 MaxConcurrentJobs = GetDefault<UAssetHistorySettings>()->MaxConcurrentJobs;
+
+	for (;;)
+	{
+		TSharedPtr<FJob> JobToStart;
+		{
+			FScopeLock ScopeLock(&Lock);
+			int32 BestIndex = INDEX_NONE;
+			for (int32 JobIndex = 0; JobIndex < PendingJobs.Num(); ++JobIndex)
+			{
+				const TSharedRef<FJob>& Job = PendingJobs[JobIndex];
+				if ((Job->Operation.IsValid() && !bIsGameThread)
+					|| (Job->Priority != ESourceControlJobPriority::Interactive && RunningJobs.Num() >= MaxConcurrentJobs))
+				{
+					continue;
+				}
+
+				if (BestIndex == INDEX_NONE || Job->Priority > PendingJobs[BestIndex]->Priority
+					|| (Job->Priority == PendingJobs[BestIndex]->Priority && Job->Sequence < PendingJobs[BestIndex]->Sequence))
+				{
+					BestIndex = JobIndex;
+				}
+			}
+
+			if (BestIndex == INDEX_NONE)
+			{
+				return;
+			}
+
+			JobToStart = PendingJobs[BestIndex];
+			PendingJobs.RemoveAt(BestIndex);
+			RunningJobs.Add(JobToStart.ToSharedRef());
+			JobToStart->bRunning = true;
+		}
+
+		StartJob(JobToStart.ToSharedRef());
+	}
+}
+
+void FSourceControlScheduler::StartJob(const TSharedRef<FJob>& Job)
+{
+	if (Job->Operation.IsValid())
+	{
+		ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+		const ECommandResult::Type Result = SourceControlProvider.Execute(Job->Operation.ToSharedRef(), Job->Files, EConcurrency::Asynchronous,
+			FSourceControlOperationComplete::CreateRaw(this, &FSourceControlScheduler::OnOperationComplete, Job));
+
+		// Providers that refuse an operation up front don't always call back
+		if (Result != ECommandResult::Succeeded && !Job->bFinished)
+		{
+			OnOperationComplete(Job->Operation.ToSharedRef(), Result, Job);
+		}
+		return;
+	}
+
+	// Workers only read the store and git's batch fetcher. Providers run their commands from the game thread and
+	// ISourceControlRevision::Get isn't safe anywhere else, so a download is marshalled there and the result stored back on a worker
+	Async(EAsyncExecution::ThreadPool, [this, Job]()
+		{
+			TArray64<uint8> Data;
+			if (Job->bCancelled || FRevisionStore::Get().GetRevisionData(Job->Revision, Data, false))
+			{
+				OnRevisionDataComplete(Job, !Job->bCancelled, Data);
+				return;
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [this, Job]()
+				{
+					TArray64<uint8> DownloadedData;
+					const bool bDownloaded = !Job->bCancelled && FRevisionStore::DownloadRevisionData(Job->Revision, DownloadedData);
+					Async(EAsyncExecution::ThreadPool, [this, Job, bDownloaded, Data = MoveTemp(DownloadedData)]()
+						{
+							if (bDownloaded)
+							{
+								FRevisionStore::Get().AddRevision(Job->Revision->GetFilename(), Job->Revision->GetRevision(), Data);
+							}
+							OnRevisionDataComplete(Job, bDownloaded, Data);
+						});
+				});
+		});
+}
+
+void FSourceControlScheduler::OnOperationComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult, TSharedRef<FJob> Job)
+{
+	// Every history fetched, whoever asked for it, feeds the churn statistics
+	if (InResult == ECommandResult::Succeeded && InOperation->GetName() == TEXT("UpdateStatus") && StaticCastSharedRef<FUpdateStatus>(InOperation)->ShouldUpdateHistory())
+	{
+		FChurnStatistics::Get().AddHistories(Job->Files);
+	}
+
+	for (FRequest& Request : FinishJob(Job))
+	{
+		Request.OnOperationComplete.ExecuteIfBound(InOperation, InResult);
+	}
+	StartJobs();
+}
+
+void FSourceControlScheduler::OnRevisionDataComplete(const TSharedRef<FJob>& Job, bool bSuccess, const TArray64<uint8>& Data)
+{
+	for (FRequest& Request : FinishJob(Job))
+	{
+		Request.OnRevisionDataReady.ExecuteIfBound(bSuccess, Data);
+	}
+	StartJobs();
+}
+
+TArray<FSourceControlScheduler::FRequest> FSourceControlScheduler::FinishJob(const TSharedRef<FJob>& Job)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (Job->bFinished)
+	{
+		return TArray<FRequest>();
+	}
+
+	Job->bFinished = true;
+	RunningJobs.Remove(Job);
+	if (!Job->DedupeKey.IsEmpty())
+	{
+		const TSharedRef<FJob>* KeyedJob = JobsByKey.Find(Job->DedupeKey);
+		if (KeyedJob && *KeyedJob == Job)
+		{
+			JobsByKey.Remove(Job->DedupeKey);
+		}
+	}
+	return MoveTemp(Job->Requests);
+}
+
+void FSourceControlScheduler::Cancel(FSourceControlJobId JobId)
+{
+	FRequest CancelledRequest;
+	FSourceControlOperationPtr Operation;
+	FSourceControlOperationPtr OperationToCancel;
+	{
+		FScopeLock ScopeLock(&Lock);
+		auto FindJob = [JobId](const TArray<TSharedRef<FJob>>& Jobs) -> TSharedPtr<FJob>
+		{
+			for (const TSharedRef<FJob>& Job : Jobs)
+			{
+				if (Job->Requests.ContainsByPredicate([JobId](const FRequest& Request) { return Request.Id == JobId; }))
+				{
+					return Job;
+				}
+			}
+			return nullptr;
+		};
+
+		TSharedPtr<FJob> Job = FindJob(PendingJobs);
+		if (!Job.IsValid())
+		{
+			Job = FindJob(RunningJobs);
+		}
+		if (!Job.IsValid())
+		{
+			return;
+		}
+
+		Operation = Job->Operation;
+		const int32 RequestIndex = Job->Requests.IndexOfByPredicate([JobId](const FRequest& Request) { return Request.Id == JobId; });
+		CancelledRequest = MoveTemp(Job->Requests[RequestIndex]);
+		Job->Requests.RemoveAt(RequestIndex);
+
+		if (Job->Requests.Num() == 0)
+		{
+			// Nobody else waits on it: drop it from the queue, or stop it if the provider can
+			Job->bCancelled = true;
+			if (!Job->DedupeKey.IsEmpty())
+			{
+				JobsByKey.Remove(Job->DedupeKey);
+			}
+			if (Job->bRunning)
+			{
+				OperationToCancel = Job->Operation;
+			}
+			else
+			{
+				Job->bFinished = true;
+				PendingJobs.Remove(Job.ToSharedRef());
+			}
+		}
+	}
+
+	if (OperationToCancel.IsValid())
+	{
+		ISourceControlProvider& SourceControlProvider = ISourceControlModule::Get().GetProvider();
+		if (SourceControlProvider.CanCancelOperation(OperationToCancel.ToSharedRef()))
+		{
+			SourceControlProvider.CancelOperation(OperationToCancel.ToSharedRef());
+		}
+	}
+
+	if (Operation.IsValid())
+	{
+		CancelledRequest.OnOperationComplete.ExecuteIfBound(Operation.ToSharedRef(), ECommandResult::Cancelled);
+	}
+	CancelledRequest.OnRevisionDataReady.ExecuteIfBound(false, TArray64<uint8>());
+}
+
+bool FSourceControlScheduler::IsActive(FSourceControlJobId JobId) const
+{
+	FScopeLock ScopeLock(&Lock);
+	auto HasRequest = [JobId](const TSharedRef<FJob>& Job)
+	{
+		return Job->Requests.ContainsByPredicate([JobId](const FRequest& Request) { return Request.Id == JobId; });
+	};
+	return PendingJobs.ContainsByPredicate(HasRequest) || RunningJobs.ContainsByPredicate(HasRequest);
+}
+
+int32 FSourceControlScheduler::GetNumPendingJobs() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return PendingJobs.Num();
+}
+
+int32 FSourceControlScheduler::GetNumRunningJobs() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return RunningJobs.Num();
+}
+
+void FSourceControlScheduler::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(AssetHistory_SourceControl);
+
+	StartJobs();
+}
+
+TStatId FSourceControlScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSourceControlScheduler, STATGROUP_Tickables);
+}
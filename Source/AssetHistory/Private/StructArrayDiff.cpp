@@ -0,0 +1,548 @@
+
+#include "StructArrayDiff.h"
+#include "AssetHistoryMemory.h"
+#include "DiffUtils.h"
+#include "PropertyDiff.h"
+#include "DataTableDiff.h"
+#include "AssetHistorySettings.h"
+#include "DataTableUtils.h"
+#include "Async/ParallelFor.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Layout/SSpacer.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "EditorStyleSet.h"
+
+#define LOCTEXT_NAMESPACE "SStructArrayDiff"
+
+static const FName IndexColumnId(TEXT("Index"));
+static const FName StatusColumnId(TEXT("Status"));
+/** Field columns use this name with the field index as number, like the data table diff */
+static const FName FieldColumnId(TEXT("DiffField"));
+
+/** Past this many cells the middle of two arrays isn't searched for common elements, it is paired in order */
+static constexpr int64 MaxAlignmentCells = 4 * 1024 * 1024;
+
+const uint8* FStructArrayDiff::GetOldElement(const FStructArrayRowDiff& Row) const
+{
+	if (Row.OldIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	FScriptArrayHelper Helper(Property, OldArray);
+	return Helper.GetRawPtr(Row.OldIndex);
+}
+
+const uint8* FStructArrayDiff::GetNewElement(const FStructArrayRowDiff& Row) const
+{
+	if (Row.NewIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	FScriptArrayHelper Helper(Property, NewArray);
+	return Helper.GetRawPtr(Row.NewIndex);
+}
+
+void StructArrayDiff::AlignElements(TArrayView<const uint64> OldHashes, TArrayView<const uint64> NewHashes, TArray<TSharedPtr<FStructArrayRowDiff>>& OutRows)
+{
+	auto AddRow = [&OutRows](int32 OldIndex, int32 NewIndex, EStructArrayRowDiffType::Type DiffType)
+	{
+		TSharedPtr<FStructArrayRowDiff> Row = MakeShared<FStructArrayRowDiff>();
+		Row->OldIndex = OldIndex;
+		Row->NewIndex = NewIndex;
+		Row->DiffType = DiffType;
+		OutRows.Add(Row);
+	};
+
+	// Elements between two aligned ones: paired in order, whatever is left on one side was added or removed
+	auto AddGap = [&AddRow](int32 OldBegin, int32 OldEnd, int32 NewBegin, int32 NewEnd)
+	{
+		const int32 NumPaired = FMath::Min(OldEnd - OldBegin, NewEnd - NewBegin);
+		for (int32 Offset = 0; Offset < NumPaired; ++Offset)
+		{
+			AddRow(OldBegin + Offset, NewBegin + Offset, EStructArrayRowDiffType::Modified);
+		}
+		for (int32 Index = OldBegin + NumPaired; Index < OldEnd; ++Index)
+		{
+			AddRow(Index, INDEX_NONE, EStructArrayRowDiffType::Removed);
+		}
+		for (int32 Index = NewBegin + NumPaired; Index < NewEnd; ++Index)
+		{
+			AddRow(INDEX_NONE, Index, EStructArrayRowDiffType::Added);
+		}
+	};
+
+	const int32 NumOld = OldHashes.Num();
+	const int32 NumNew = NewHashes.Num();
+	OutRows.Reserve(OutRows.Num() + FMath::Max(NumOld, NumNew));
+
+	// Edits are usually local, the common prefix and suffix keep the search below small
+	int32 NumPrefix = 0;
+	while (NumPrefix < NumOld && NumPrefix < NumNew && OldHashes[NumPrefix] == NewHashes[NumPrefix])
+	{
+		AddRow(NumPrefix, NumPrefix, EStructArrayRowDiffType::Unchanged);
+		++NumPrefix;
+	}
+	int32 NumSuffix = 0;
+	while (NumSuffix < NumOld - NumPrefix && NumSuffix < NumNew - NumPrefix && OldHashes[NumOld - 1 - NumSuffix] == NewHashes[NumNew - 1 - NumSuffix])
+	{
+		++NumSuffix;
+	}
+
+	const int32 OldBegin = NumPrefix;
+	const int32 OldEnd = NumOld - NumSuffix;
+	const int32 NewBegin = NumPrefix;
+	const int32 NewEnd = NumNew - NumSuffix;
+	const int32 NumOldMiddle = OldEnd - OldBegin;
+	const int32 NumNewMiddle = NewEnd - NewBegin;
+	if (NumOldMiddle > 0 && NumNewMiddle > 0 && (int64)NumOldMiddle * NumNewMiddle <= MaxAlignmentCells)
+	{
+		// Lengths[Old * Stride + New]: longest common subsequence of the middles from Old and New on
+		const int32 Stride = NumNewMiddle + 1;
+		TArray<uint16> Lengths;
+		Lengths.SetNumZeroed((NumOldMiddle + 1) * Stride);
+		for (int32 Old = NumOldMiddle - 1; Old >= 0; --Old)
+		{
+			for (int32 New = NumNewMiddle - 1; New >= 0; --New)
+			{
+				Lengths[Old * Stride + New] = OldHashes[OldBegin + Old] == NewHashes[NewBegin + New]
+					? Lengths[(Old + 1) * Stride + New + 1] + 1
+					: FMath::Max(Lengths[(Old + 1) * Stride + New], Lengths[Old * Stride + New + 1]);
+			}
+		}
+
+		int32 Old = 0;
+		int32 New = 0;
+		int32 GapOld = 0;
+		int32 GapNew = 0;
+		while (Old < NumOldMiddle && New < NumNewMiddle)
+		{
+			if (OldHashes[OldBegin + Old] == NewHashes[NewBegin + New])
+			{
+				AddGap(OldBegin + GapOld, OldBegin + Old, NewBegin + GapNew, NewBegin + New);
+				AddRow(OldBegin + Old, NewBegin + New, EStructArrayRowDiffType::Unchanged);
+				GapOld = ++Old;
+				GapNew = ++New;
+			}
+			else if (Lengths[(Old + 1) * Stride + New] >= Lengths[Old * Stride + New + 1])
+			{
+				++Old;
+			}
+			else
+			{
+				++New;
+			}
+		}
+		AddGap(OldBegin + GapOld, OldEnd, NewBegin + GapNew, NewEnd);
+	}
+	else
+	{
+		AddGap(OldBegin, OldEnd, NewBegin, NewEnd);
+	}
+
+	for (int32 Offset = 0; Offset < NumSuffix; ++Offset)
+	{
+		AddRow(OldEnd + Offset, NewEnd + Offset, EStructArrayRowDiffType::Unchanged);
+	}
+}
+
+static bool AreFieldsEqual(const FProperty* Field, const uint8* OldElement, const uint8* NewElement, double Tolerance)
+{
+	for (int32 Index = 0; Index < Field->ArrayDim; ++Index)
+	{
+		if (!FPropertyComparators::Get().AreEqual(Field, Field->ContainerPtrToValuePtr<void>(OldElement, Index), Field->ContainerPtrToValuePtr<void>(NewElement, Index), Tolerance))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool StructArrayDiff::DiffArrays(const UObject* OldObject, const UObject* NewObject, int32 MinElements, TArray<TSharedPtr<FStructArrayDiff>>& OutArrays, FDiffProgress* Progress)
+{
+	check(OldObject && NewObject);
+
+	const double Tolerance = GetDefault<UAssetHistorySettings>()->DiffTolerance;
+	for (TFieldIterator<FArrayProperty> It(NewObject->GetClass()); It; ++It)
+	{
+		if (Progress && Progress->bCancelled)
+		{
+			return false;
+		}
+
+		const FArrayProperty* NewProperty = *It;
+		const FStructProperty* Inner = CastField<FStructProperty>(NewProperty->Inner);
+		if (!Inner || NewProperty->ArrayDim != 1 || !PropertyDiff::IsCompared(NewProperty))
+		{
+			continue;
+		}
+
+		// Same struct on both sides, the rows are read with one layout
+		const FArrayProperty* OldProperty = FindFProperty<FArrayProperty>(OldObject->GetClass(), NewProperty->GetFName());
+		if (!OldProperty || !OldProperty->SameType(NewProperty))
+		{
+			continue;
+		}
+
+		const void* OldArray = OldProperty->ContainerPtrToValuePtr<void>(OldObject);
+		const void* NewArray = NewProperty->ContainerPtrToValuePtr<void>(NewObject);
+		FScriptArrayHelper OldHelper(OldProperty, OldArray);
+		FScriptArrayHelper NewHelper(NewProperty, NewArray);
+		if (FMath::Max(OldHelper.Num(), NewHelper.Num()) < MinElements || FPropertyComparators::Get().AreEqual(NewProperty, OldArray, NewArray, Tolerance))
+		{
+			continue;
+		}
+
+		TSharedPtr<FStructArrayDiff> Diff = MakeShared<FStructArrayDiff>();
+		Diff->Property = NewProperty;
+		Diff->Struct = Inner->Struct;
+		Diff->OldArray = OldArray;
+		Diff->NewArray = NewArray;
+		for (TFieldIterator<const FProperty> FieldIt(Inner->Struct); FieldIt; ++FieldIt)
+		{
+			if (PropertyDiff::IsCompared(*FieldIt))
+			{
+				Diff->Fields.Add(*FieldIt);
+			}
+		}
+
+		TArray<uint64> OldHashes;
+		TArray<uint64> NewHashes;
+		OldHashes.SetNumUninitialized(OldHelper.Num());
+		NewHashes.SetNumUninitialized(NewHelper.Num());
+		ParallelFor(OldHashes.Num() + NewHashes.Num(), [&](int32 Index)
+			{
+				if (Index < OldHashes.Num())
+				{
+					OldHashes[Index] = DataTableDiff::HashRow(Inner->Struct, OldHelper.GetRawPtr(Index));
+				}
+				else
+				{
+					NewHashes[Index - OldHashes.Num()] = DataTableDiff::HashRow(Inner->Struct, NewHelper.GetRawPtr(Index - OldHashes.Num()));
+				}
+			});
+		AlignElements(OldHashes, NewHashes, Diff->Rows);
+
+		for (const TSharedPtr<FStructArrayRowDiff>& Row : Diff->Rows)
+		{
+			if (Row->DiffType == EStructArrayRowDiffType::Modified)
+			{
+				const uint8* OldElement = Diff->GetOldElement(*Row);
+				const uint8* NewElement = Diff->GetNewElement(*Row);
+				Row->ChangedFields.Init(false, Diff->Fields.Num());
+				bool bAnyChanged = false;
+				for (int32 FieldIndex = 0; FieldIndex < Diff->Fields.Num(); ++FieldIndex)
+				{
+					if (!AreFieldsEqual(Diff->Fields[FieldIndex], OldElement, NewElement, Tolerance))
+					{
+						Row->ChangedFields[FieldIndex] = true;
+						bAnyChanged = true;
+					}
+				}
+
+				// The hashes saw hidden fields or differences within the tolerance
+				if (!bAnyChanged)
+				{
+					Row->DiffType = EStructArrayRowDiffType::Unchanged;
+					Row->ChangedFields.Empty();
+				}
+			}
+
+			if (Row->DiffType != EStructArrayRowDiffType::Unchanged)
+			{
+				++Diff->NumChangedRows;
+				if (Progress)
+				{
+					++Progress->DifferencesFound;
+				}
+			}
+			if (Progress)
+			{
+				++Progress->PropertiesVisited;
+			}
+		}
+
+		if (Diff->NumChangedRows > 0)
+		{
+			OutArrays.Add(Diff);
+		}
+	}
+	return !(Progress && Progress->bCancelled);
+}
+
+/** Row of the table, its cells are exported to text when the list view generates it */
+class SStructArrayDiffRow : public SMultiColumnTableRow<TSharedPtr<FStructArrayRowDiff>>
+{
+public:
+	SLATE_BEGIN_ARGS(SStructArrayDiffRow){}
+		SLATE_ARGUMENT(TSharedPtr<FStructArrayRowDiff>, Item)
+		SLATE_ARGUMENT(TSharedPtr<FStructArrayDiff>, ArrayDiff)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		ArrayDiff = InArgs._ArrayDiff;
+		SMultiColumnTableRow<TSharedPtr<FStructArrayRowDiff>>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		const bool bChanged = Item->DiffType != EStructArrayRowDiffType::Unchanged;
+		if (ColumnName == IndexColumnId)
+		{
+			const FText IndexText = Item->OldIndex == INDEX_NONE || Item->NewIndex == INDEX_NONE || Item->OldIndex == Item->NewIndex
+				? FText::AsNumber(Item->NewIndex != INDEX_NONE ? Item->NewIndex : Item->OldIndex)
+				: FText::Format(LOCTEXT("MovedIndex", "{0} -> {1}"), FText::AsNumber(Item->OldIndex), FText::AsNumber(Item->NewIndex));
+			return MakeCell(IndexText, bChanged ? DiffViewUtils::Differs() : DiffViewUtils::Identical());
+		}
+
+		if (ColumnName == StatusColumnId)
+		{
+			switch (Item->DiffType)
+			{
+			case EStructArrayRowDiffType::Added:
+				return MakeCell(LOCTEXT("RowAdded", "Added"), DiffViewUtils::Differs());
+			case EStructArrayRowDiffType::Removed:
+				return MakeCell(LOCTEXT("RowRemoved", "Removed"), DiffViewUtils::Differs());
+			case EStructArrayRowDiffType::Modified:
+				return MakeCell(FText::Format(LOCTEXT("RowModified", "Modified ({0})"), FText::AsNumber(Item->ChangedFields.CountSetBits())), DiffViewUtils::Differs());
+			default:
+				return MakeCell(FText::GetEmpty(), DiffViewUtils::Identical());
+			}
+		}
+
+		if (!ColumnName.IsEqual(FieldColumnId, ENameCase::IgnoreCase, false))
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		const int32 FieldIndex = NAME_INTERNAL_TO_EXTERNAL(ColumnName.GetNumber());
+		if (!ArrayDiff->Fields.IsValidIndex(FieldIndex))
+		{
+			return SNullWidget::NullWidget;
+		}
+
+		const FProperty* Field = ArrayDiff->Fields[FieldIndex];
+		const uint8* OldElement = ArrayDiff->GetOldElement(*Item);
+		const uint8* NewElement = ArrayDiff->GetNewElement(*Item);
+		if (Item->DiffType == EStructArrayRowDiffType::Modified && Item->ChangedFields[FieldIndex])
+		{
+			const FText CellText = FText::Format(LOCTEXT("CellDiff", "{0} -> {1}"),
+				FText::FromString(DataTableUtils::GetPropertyValueAsString(Field, OldElement, EDataTableExportFlags::None)),
+				FText::FromString(DataTableUtils::GetPropertyValueAsString(Field, NewElement, EDataTableExportFlags::None)));
+			return MakeCell(CellText, DiffViewUtils::Differs());
+		}
+
+		const uint8* Element = NewElement ? NewElement : OldElement;
+		const bool bOneSided = Item->DiffType == EStructArrayRowDiffType::Added || Item->DiffType == EStructArrayRowDiffType::Removed;
+		return MakeCell(FText::FromString(DataTableUtils::GetPropertyValueAsString(Field, Element, EDataTableExportFlags::None)),
+			bOneSided ? DiffViewUtils::Differs() : DiffViewUtils::Identical());
+	}
+
+private:
+	static TSharedRef<SWidget> MakeCell(const FText& Text, const FLinearColor& Color)
+	{
+		return SNew(SBox)
+			.Padding(FMargin(4.0f, 2.0f))
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(Text)
+				.ToolTipText(Text)
+				.ColorAndOpacity(Color)
+			];
+	}
+
+	TSharedPtr<FStructArrayRowDiff> Item;
+	TSharedPtr<FStructArrayDiff> ArrayDiff;
+};
+
+void SStructArrayDiff::Construct(const FArguments& InArgs)
+{
+	Arrays = InArgs._Arrays;
+
+	this->ChildSlot
+		[
+			SNew(SSplitter)
+			+ SSplitter::Slot()
+			.Value(0.2f)
+			[
+				SNew(SBorder)
+				.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+				[
+					SAssignNew(ArrayListView, SListView<TSharedPtr<FStructArrayDiff>>)
+					.ListItemsSource(&Arrays)
+					.OnGenerateRow(this, &SStructArrayDiff::OnGenerateArrayRow)
+					.OnSelectionChanged(this, &SStructArrayDiff::OnArraySelectionChanged)
+					.SelectionMode(ESelectionMode::Single)
+				]
+			]
+			+ SSplitter::Slot()
+			.Value(0.8f)
+			[
+				SNew(SVerticalBox)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(4.0f)
+				[
+					SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.VAlign(VAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text_Lambda([this]()
+							{
+								if (!Arrays.IsValidIndex(CurrentArray))
+								{
+									return FText::GetEmpty();
+								}
+								const FStructArrayDiff& Diff = *Arrays[CurrentArray];
+								return FText::Format(LOCTEXT("ArraySummary", "{0}: {1} of {2} rows changed"),
+									Diff.Property->GetDisplayNameText(), FText::AsNumber(Diff.NumChangedRows), FText::AsNumber(Diff.Rows.Num()));
+							})
+					]
+					+ SHorizontalBox::Slot()
+					[
+						SNew(SSpacer)
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SCheckBox)
+						.IsChecked_Lambda([this]() { return bChangedRowsOnly ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+						.OnCheckStateChanged_Lambda([this](ECheckBoxState State)
+							{
+								bChangedRowsOnly = State == ECheckBoxState::Checked;
+								RefreshVisibleRows();
+							})
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("ChangedRowsOnly", "Changed rows only"))
+						]
+					]
+				]
+				+ SVerticalBox::Slot()
+				[
+					SAssignNew(TableContents, SBox)
+				]
+			]
+		];
+
+	if (Arrays.Num() > 0)
+	{
+		ArrayListView->SetSelection(Arrays[0]);
+	}
+}
+
+void SStructArrayDiff::SelectRow(int32 ArrayIndex, TSharedPtr<FStructArrayRowDiff> Row)
+{
+	if (!Arrays.IsValidIndex(ArrayIndex))
+	{
+		return;
+	}
+
+	if (ArrayIndex != CurrentArray)
+	{
+		ArrayListView->SetSelection(Arrays[ArrayIndex]);
+	}
+	if (Row.IsValid() && RowListView.IsValid() && VisibleRows.Contains(Row))
+	{
+		RowListView->SetSelection(Row);
+		RowListView->RequestScrollIntoView(Row);
+	}
+}
+
+void SStructArrayDiff::ShowArray(int32 ArrayIndex)
+{
+	CurrentArray = ArrayIndex;
+	if (!Arrays.IsValidIndex(ArrayIndex))
+	{
+		RowListView.Reset();
+		TableContents->SetContent(SNullWidget::NullWidget);
+		return;
+	}
+
+	// Columns depend on the struct, the table is rebuilt for each array
+	const FStructArrayDiff& Diff = *Arrays[ArrayIndex];
+	TSharedRef<SHeaderRow> HeaderRow = SNew(SHeaderRow)
+		+ SHeaderRow::Column(IndexColumnId)
+		.DefaultLabel(LOCTEXT("IndexColumn", "Index"))
+		.ManualWidth(80.0f)
+		+ SHeaderRow::Column(StatusColumnId)
+		.DefaultLabel(LOCTEXT("StatusColumn", "Status"))
+		.ManualWidth(100.0f);
+
+	for (int32 FieldIndex = 0; FieldIndex < Diff.Fields.Num(); ++FieldIndex)
+	{
+		HeaderRow->AddColumn(SHeaderRow::Column(FName(FieldColumnId, NAME_EXTERNAL_TO_INTERNAL(FieldIndex)))
+			.DefaultLabel(Diff.Fields[FieldIndex]->GetDisplayNameText())
+			.ManualWidth(160.0f));
+	}
+
+	TableContents->SetContent(
+		SNew(SBorder)
+		.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
+		[
+			SNew(SScrollBox)
+			.Orientation(Orient_Horizontal)
+			+ SScrollBox::Slot()
+			[
+				SAssignNew(RowListView, SListView<TSharedPtr<FStructArrayRowDiff>>)
+				.ListItemsSource(&VisibleRows)
+				.OnGenerateRow(this, &SStructArrayDiff::OnGenerateRow)
+				.SelectionMode(ESelectionMode::Single)
+				.HeaderRow(HeaderRow)
+			]
+		]);
+	RefreshVisibleRows();
+}
+
+void SStructArrayDiff::RefreshVisibleRows()
+{
+	VisibleRows.Reset();
+	if (Arrays.IsValidIndex(CurrentArray))
+	{
+		for (const TSharedPtr<FStructArrayRowDiff>& Row : Arrays[CurrentArray]->Rows)
+		{
+			if (!bChangedRowsOnly || Row->DiffType != EStructArrayRowDiffType::Unchanged)
+			{
+				VisibleRows.Add(Row);
+			}
+		}
+	}
+
+	if (RowListView.IsValid())
+	{
+		RowListView->RequestListRefresh();
+	}
+}
+
+TSharedRef<ITableRow> SStructArrayDiff::OnGenerateArrayRow(TSharedPtr<FStructArrayDiff> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<TSharedPtr<FStructArrayDiff>>, OwnerTable)
+		[
+			SNew(STextBlock)
+			.Text(FText::Format(LOCTEXT("ArrayEntry", "{0} ({1})"), Item->Property->GetDisplayNameText(), FText::AsNumber(Item->NumChangedRows)))
+		];
+}
+
+void SStructArrayDiff::OnArraySelectionChanged(TSharedPtr<FStructArrayDiff> Item, ESelectInfo::Type SelectInfo)
+{
+	if (Item.IsValid())
+	{
+		ShowArray(Arrays.IndexOfByKey(Item));
+	}
+}
+
+TSharedRef<ITableRow> SStructArrayDiff::OnGenerateRow(TSharedPtr<FStructArrayRowDiff> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SStructArrayDiffRow, OwnerTable)
+		.Item(Item)
+		.ArrayDiff(Arrays[CurrentArray]);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,656 @@
+
+#include "TaggedPropertyReader.h"
+#include "PackageFileReader.h"
+#include "Hash/CityHash.h"
+#include "Algo/BinarySearch.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTaggedPropertyReader, Log, All);
+
+namespace TaggedPropertyNames
+{
+	static const FName BoolProperty(TEXT("BoolProperty"));
+	static const FName ByteProperty(TEXT("ByteProperty"));
+	static const FName Int8Property(TEXT("Int8Property"));
+	static const FName Int16Property(TEXT("Int16Property"));
+	static const FName IntProperty(TEXT("IntProperty"));
+	static const FName Int64Property(TEXT("Int64Property"));
+	static const FName UInt16Property(TEXT("UInt16Property"));
+	static const FName UInt32Property(TEXT("UInt32Property"));
+	static const FName UInt64Property(TEXT("UInt64Property"));
+	static const FName FloatProperty(TEXT("FloatProperty"));
+	static const FName DoubleProperty(TEXT("DoubleProperty"));
+	static const FName EnumProperty(TEXT("EnumProperty"));
+	static const FName NameProperty(TEXT("NameProperty"));
+	static const FName StrProperty(TEXT("StrProperty"));
+	static const FName ObjectProperty(TEXT("ObjectProperty"));
+	static const FName ClassProperty(TEXT("ClassProperty"));
+	static const FName WeakObjectProperty(TEXT("WeakObjectProperty"));
+	static const FName InterfaceProperty(TEXT("InterfaceProperty"));
+	static const FName StructProperty(TEXT("StructProperty"));
+	static const FName ArrayProperty(TEXT("ArrayProperty"));
+	static const FName SetProperty(TEXT("SetProperty"));
+	static const FName MapProperty(TEXT("MapProperty"));
+
+	static const FName Vector(TEXT("Vector"));
+	static const FName Vector2D(TEXT("Vector2D"));
+	static const FName Vector4(TEXT("Vector4"));
+	static const FName Quat(TEXT("Quat"));
+	static const FName Rotator(TEXT("Rotator"));
+	static const FName LinearColor(TEXT("LinearColor"));
+	static const FName Color(TEXT("Color"));
+	static const FName Guid(TEXT("Guid"));
+	static const FName IntPoint(TEXT("IntPoint"));
+	static const FName IntVector(TEXT("IntVector"));
+}
+
+/** Short form when it reads back to the same value, all the digits otherwise, so values differing past the sixth decimal don't render equal */
+static FString FormatReal(double Value, bool bIsDouble)
+{
+	FString Text = FString::SanitizeFloat(Value);
+	const bool bRoundTrips = bIsDouble ? FCString::Atod(*Text) == Value : FCString::Atof(*Text) == (float)Value;
+	return bRoundTrips ? Text : FString::Printf(bIsDouble ? TEXT("%.17g") : TEXT("%.9g"), Value);
+}
+
+/**
+ * Header of one tagged property as written by the UE4.12+ savers. Read by hand so we only rely on
+ * the on-disk format, not on the linker. FPackageFileReader rejects the file versions with another layout.
+ */
+struct FSerializedPropertyTag
+{
+	FName Name;
+	FName Type;
+	int32 Size = 0;
+	int32 ArrayIndex = 0;
+	FName StructName;
+	FName EnumName;
+	FName InnerType;
+	FName ValueType;
+	uint8 BoolVal = 0;
+
+	/** Returns false at the terminating None tag */
+	bool Serialize(FArchive& Ar)
+	{
+		Ar << Name;
+		if (Name.IsNone() || Ar.IsError())
+		{
+			return false;
+		}
+
+		Ar << Type << Size << ArrayIndex;
+		if (Type == TaggedPropertyNames::StructProperty)
+		{
+			FGuid StructGuid;
+			Ar << StructName << StructGuid;
+		}
+		else if (Type == TaggedPropertyNames::BoolProperty)
+		{
+			Ar << BoolVal;
+		}
+		else if (Type == TaggedPropertyNames::ByteProperty || Type == TaggedPropertyNames::EnumProperty)
+		{
+			Ar << EnumName;
+		}
+		else if (Type == TaggedPropertyNames::ArrayProperty || Type == TaggedPropertyNames::SetProperty)
+		{
+			Ar << InnerType;
+		}
+		else if (Type == TaggedPropertyNames::MapProperty)
+		{
+			Ar << InnerType << ValueType;
+		}
+
+		uint8 HasPropertyGuid = 0;
+		Ar << HasPropertyGuid;
+		if (HasPropertyGuid)
+		{
+			FGuid PropertyGuid;
+			Ar << PropertyGuid;
+		}
+		return !Ar.IsError() && Size >= 0;
+	}
+};
+
+/** Walks the tagged property stream of one export and appends its leaves */
+class FTaggedPropertyParser
+{
+public:
+	FTaggedPropertyParser(const FPackageFileReader& InPackage, TArrayView<const uint8> InExportData, TArray<FTaggedPropertyValue>& InValues, uint64 InTablesHash)
+		: Package(InPackage)
+		, ExportData(InExportData)
+		, Values(InValues)
+		, TablesHash(InTablesHash)
+	{
+	}
+
+	/** Reads tags until the None tag. Fails without side effects on the archive error state being cleared by the caller */
+	bool ParseTaggedStream(FArchive& Ar, const FString& Prefix, int64 End, int32 Depth)
+	{
+		if (Depth > MaxDepth)
+		{
+			return false;
+		}
+
+		FSerializedPropertyTag Tag;
+		while (Tag.Serialize(Ar))
+		{
+			const int64 ValueStart = Ar.Tell();
+			const int64 ValueEnd = ValueStart + Tag.Size;
+			if (ValueEnd > End)
+			{
+				Ar.SetError();
+				return false;
+			}
+
+			FString Path = Prefix + Tag.Name.ToString();
+			if (Tag.ArrayIndex > 0)
+			{
+				Path += FString::Printf(TEXT("[%d]"), Tag.ArrayIndex);
+			}
+
+			ParseTagValue(Ar, Tag, Path, ValueStart, ValueEnd, Depth);
+
+			// Always resync on the tag size, whatever the value parser did
+			Ar.Seek(ValueEnd);
+			Tag = FSerializedPropertyTag();
+		}
+		return !Ar.IsError();
+	}
+
+	/**
+	 * Whatever a native Serialize wrote after the None tag (data table rows, curve keys...) as one blob leaf, so a change there isn't
+	 * mistaken for no change. Skipped when it is only the empty object guid flag every UObject::Serialize ends with.
+	 */
+	void AddNativeData(const FString& Prefix, int64 Start)
+	{
+		const int64 End = ExportData.Num();
+		if (Start >= End || (End - Start == sizeof(int32) && FMemory::Memcmp(ExportData.GetData() + Start, "\0\0\0\0", sizeof(int32)) == 0))
+		{
+			return;
+		}
+		AddRawLeaf(Prefix + TEXT("<NativeData>"), NAME_None, Start, End);
+	}
+
+private:
+	static constexpr int32 MaxDepth = 32;
+
+	void ParseTagValue(FArchive& Ar, const FSerializedPropertyTag& Tag, const FString& Path, int64 Start, int64 End, int32 Depth)
+	{
+		using namespace TaggedPropertyNames;
+
+		if (Tag.Type == BoolProperty)
+		{
+			AddLeaf(Path, Tag.Type, Tag.BoolVal ? TEXT("True") : TEXT("False"));
+		}
+		else if (Tag.Type == StructProperty)
+		{
+			ParseStruct(Ar, Tag.StructName, Path, End, true, Depth);
+		}
+		else if (Tag.Type == ArrayProperty)
+		{
+			ParseArray(Ar, Tag, Path, End, Depth);
+		}
+		else if (Tag.Type == SetProperty || Tag.Type == MapProperty)
+		{
+			ParseSetOrMap(Ar, Tag, Path, End, Depth);
+		}
+		else
+		{
+			const bool bEnumAsName = Tag.Type == EnumProperty || (Tag.Type == ByteProperty && !Tag.EnumName.IsNone());
+			FString Value;
+			if (ReadSimpleValue(Ar, Tag.Type, bEnumAsName, Value) && Ar.Tell() == End)
+			{
+				AddLeaf(Path, Tag.Type, MoveTemp(Value));
+			}
+			else
+			{
+				Ar.ClearError();
+				AddRawLeaf(Path, Tag.Type, Start, End);
+			}
+		}
+	}
+
+	/** With bExactEnd the struct spans [Tell, End), otherwise End only bounds a tagged struct of unknown size */
+	bool ParseStruct(FArchive& Ar, FName StructName, const FString& Path, int64 End, bool bExactEnd, int32 Depth)
+	{
+		const int64 Start = Ar.Tell();
+		if (bExactEnd)
+		{
+			FString Value;
+			if (DecodeBinaryStruct(StructName, Start, End - Start, Value))
+			{
+				AddLeaf(Path, StructName, MoveTemp(Value));
+				Ar.Seek(End);
+				return true;
+			}
+		}
+
+		const int32 NumValues = Values.Num();
+		if (ParseTaggedStream(Ar, Path + TEXT("."), End, Depth + 1) && (!bExactEnd || Ar.Tell() == End))
+		{
+			return true;
+		}
+
+		// Natively serialized struct we don't know about, compare it as a blob
+		Values.SetNum(NumValues, false);
+		Ar.ClearError();
+		Ar.Seek(Start);
+		if (bExactEnd)
+		{
+			AddRawLeaf(Path, StructName, Start, End);
+			Ar.Seek(End);
+			return true;
+		}
+		return false;
+	}
+
+	void ParseArray(FArchive& Ar, const FSerializedPropertyTag& Tag, const FString& Path, int64 End, int32 Depth)
+	{
+		using namespace TaggedPropertyNames;
+
+		const int64 Start = Ar.Tell();
+		int32 Count = 0;
+		Ar << Count;
+		if (Ar.IsError() || Count < 0 || Count > End - Ar.Tell())
+		{
+			Ar.ClearError();
+			AddRawLeaf(Path, Tag.Type, Start, End);
+			return;
+		}
+
+		AddLeaf(Path + TEXT(".Num"), Tag.Type, LexToString(Count));
+		if (Count == 0)
+		{
+			return;
+		}
+
+		if (Tag.InnerType == StructProperty)
+		{
+			FSerializedPropertyTag InnerTag;
+			InnerTag.Serialize(Ar);
+			const int64 DataStart = Ar.Tell();
+			const int64 DataSize = End - DataStart;
+			if (Ar.IsError() || DataSize < 0)
+			{
+				Ar.ClearError();
+				AddRawLeaf(Path, Tag.Type, Start, End);
+				return;
+			}
+
+			FString Probe;
+			const bool bBinary = DataSize % Count == 0 && DecodeBinaryStruct(InnerTag.StructName, DataStart, DataSize / Count, Probe);
+			int32 Index = 0;
+			if (!bBinary)
+			{
+				for (; Index < Count; ++Index)
+				{
+					if (!ParseStruct(Ar, InnerTag.StructName, FString::Printf(TEXT("%s[%d]"), *Path, Index), End, false, Depth))
+					{
+						break;
+					}
+				}
+			}
+
+			if (Index < Count)
+			{
+				// Fixed size elements: either a known binary struct or one we can only compare as blobs
+				const int64 Remaining = End - Ar.Tell();
+				const int32 RemainingCount = Count - Index;
+				if (Remaining % RemainingCount != 0)
+				{
+					AddRawLeaf(FString::Printf(TEXT("%s[%d..]"), *Path, Index), InnerTag.StructName, Ar.Tell(), End);
+					return;
+				}
+
+				const int64 ElementSize = Remaining / RemainingCount;
+				for (; Index < Count; ++Index)
+				{
+					const int64 ElementStart = Ar.Tell();
+					ParseStruct(Ar, InnerTag.StructName, FString::Printf(TEXT("%s[%d]"), *Path, Index), ElementStart + ElementSize, true, Depth);
+				}
+			}
+			return;
+		}
+
+		// Enum bytes are written by name, plain bytes as bytes, the element size tells them apart
+		const int64 DataSize = End - Ar.Tell();
+		const bool bEnumAsName = Tag.InnerType == EnumProperty || (Tag.InnerType == ByteProperty && DataSize != Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const int64 ElementStart = Ar.Tell();
+			FString Value;
+			if (!ReadSimpleValue(Ar, Tag.InnerType, bEnumAsName, Value) || Ar.Tell() > End)
+			{
+				Ar.ClearError();
+				AddRawLeaf(FString::Printf(TEXT("%s[%d..]"), *Path, Index), Tag.InnerType, ElementStart, End);
+				return;
+			}
+			AddLeaf(FString::Printf(TEXT("%s[%d]"), *Path, Index), Tag.InnerType, MoveTemp(Value));
+		}
+	}
+
+	void ParseSetOrMap(FArchive& Ar, const FSerializedPropertyTag& Tag, const FString& Path, int64 End, int32 Depth)
+	{
+		using namespace TaggedPropertyNames;
+
+		const int64 Start = Ar.Tell();
+		const int32 NumValues = Values.Num();
+		const bool bIsMap = Tag.Type == MapProperty;
+		auto Fail = [&]()
+		{
+			Values.SetNum(NumValues, false);
+			Ar.ClearError();
+			AddRawLeaf(Path, Tag.Type, Start, End);
+		};
+
+		// Struct keys are tagged streams like map struct values, natively serialized ones fail to parse and end up as one blob
+		const bool bStructKeys = Tag.InnerType == StructProperty;
+
+		int32 NumToRemove = 0;
+		Ar << NumToRemove;
+		for (int32 Index = 0; Index < NumToRemove; ++Index)
+		{
+			const int32 NumKept = Values.Num();
+			FString Ignored;
+			const bool bRead = bStructKeys
+				? ParseStruct(Ar, NAME_None, Path, End, false, Depth)
+				: ReadSimpleValue(Ar, Tag.InnerType, Tag.InnerType == EnumProperty, Ignored);
+			Values.SetNum(NumKept, false);
+			if (!bRead)
+			{
+				Fail();
+				return;
+			}
+		}
+
+		int32 Count = 0;
+		Ar << Count;
+		if (Ar.IsError() || Count < 0 || Count > End - Ar.Tell())
+		{
+			Fail();
+			return;
+		}
+
+		AddLeaf(Path + TEXT(".Num"), Tag.Type, LexToString(Count));
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			FString ElementPath;
+			if (bStructKeys)
+			{
+				// No short form to name the element with, so elements are numbered and the key is a sub-tree
+				ElementPath = FString::Printf(TEXT("%s[%d]"), *Path, Index);
+				if (!ParseStruct(Ar, NAME_None, bIsMap ? ElementPath + TEXT(".Key") : ElementPath, End, false, Depth))
+				{
+					Fail();
+					return;
+				}
+				if (!bIsMap)
+				{
+					continue;
+				}
+				ElementPath += TEXT(".Value");
+			}
+			else
+			{
+				FString Key;
+				if (!ReadSimpleValue(Ar, Tag.InnerType, Tag.InnerType == EnumProperty, Key) || Ar.Tell() > End)
+				{
+					Fail();
+					return;
+				}
+
+				ElementPath = FString::Printf(TEXT("%s[%s]"), *Path, *Key);
+				if (!bIsMap)
+				{
+					AddLeaf(ElementPath, Tag.InnerType, MoveTemp(Key));
+					continue;
+				}
+			}
+
+			if (Tag.ValueType == StructProperty)
+			{
+				if (!ParseStruct(Ar, NAME_None, ElementPath, End, false, Depth))
+				{
+					Fail();
+					return;
+				}
+				continue;
+			}
+
+			FString Value;
+			if (!ReadSimpleValue(Ar, Tag.ValueType, Tag.ValueType == EnumProperty, Value) || Ar.Tell() > End)
+			{
+				Fail();
+				return;
+			}
+			AddLeaf(ElementPath, Tag.ValueType, MoveTemp(Value));
+		}
+	}
+
+	bool ReadSimpleValue(FArchive& Ar, FName Type, bool bEnumAsName, FString& OutValue)
+	{
+		using namespace TaggedPropertyNames;
+
+		if (Type == IntProperty) { int32 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == FloatProperty) { float Value = 0; Ar << Value; OutValue = FormatReal(Value, false); }
+		else if (Type == DoubleProperty) { double Value = 0; Ar << Value; OutValue = FormatReal(Value, true); }
+		else if (Type == Int8Property) { int8 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == Int16Property) { int16 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == Int64Property) { int64 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == UInt16Property) { uint16 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == UInt32Property) { uint32 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == UInt64Property) { uint64 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == BoolProperty) { uint8 Value = 0; Ar << Value; OutValue = Value ? TEXT("True") : TEXT("False"); }
+		else if (Type == NameProperty || (bEnumAsName && (Type == ByteProperty || Type == EnumProperty))) { FName Value; Ar << Value; OutValue = Value.ToString(); }
+		else if (Type == ByteProperty) { uint8 Value = 0; Ar << Value; OutValue = LexToString(Value); }
+		else if (Type == StrProperty) { FString Value; Ar << Value; OutValue = MoveTemp(Value); }
+		else if (Type == ObjectProperty || Type == ClassProperty || Type == WeakObjectProperty || Type == InterfaceProperty)
+		{
+			FPackageIndex Value;
+			Ar << Value;
+			OutValue = Value.IsNull() ? TEXT("None") : Package.GetObjectPath(Value);
+		}
+		else
+		{
+			return false;
+		}
+		return !Ar.IsError();
+	}
+
+	/** Natively serialized math types, whose layout depends on whether the package was saved with doubles */
+	bool DecodeBinaryStruct(FName StructName, int64 Start, int64 Size, FString& OutValue) const
+	{
+		using namespace TaggedPropertyNames;
+
+		if (Size <= 0 || Start + Size > ExportData.Num())
+		{
+			return false;
+		}
+
+		const uint8* Bytes = ExportData.GetData() + Start;
+		auto ReadReal = [Bytes, Size](int32 Index, int32 Count) -> FString
+		{
+			if (Size == Count * (int64)sizeof(double))
+			{
+				double Value;
+				FMemory::Memcpy(&Value, Bytes + Index * sizeof(double), sizeof(double));
+				return FormatReal(Value, true);
+			}
+			float Value;
+			FMemory::Memcpy(&Value, Bytes + Index * sizeof(float), sizeof(float));
+			return FormatReal(Value, false);
+		};
+		auto HasRealSize = [Size](int32 Count) { return Size == Count * (int64)sizeof(float) || Size == Count * (int64)sizeof(double); };
+
+		if ((StructName == Vector || StructName == Rotator) && HasRealSize(3))
+		{
+			const TCHAR* Format = StructName == Vector ? TEXT("X=%s Y=%s Z=%s") : TEXT("P=%s Y=%s R=%s");
+			OutValue = FString::Printf(Format, *ReadReal(0, 3), *ReadReal(1, 3), *ReadReal(2, 3));
+		}
+		else if (StructName == Vector2D && HasRealSize(2))
+		{
+			OutValue = FString::Printf(TEXT("X=%s Y=%s"), *ReadReal(0, 2), *ReadReal(1, 2));
+		}
+		else if ((StructName == Vector4 || StructName == Quat) && HasRealSize(4))
+		{
+			OutValue = FString::Printf(TEXT("X=%s Y=%s Z=%s W=%s"), *ReadReal(0, 4), *ReadReal(1, 4), *ReadReal(2, 4), *ReadReal(3, 4));
+		}
+		else if (StructName == LinearColor && Size == 4 * sizeof(float))
+		{
+			float Channels[4];
+			FMemory::Memcpy(Channels, Bytes, sizeof(Channels));
+			OutValue = FString::Printf(TEXT("R=%s G=%s B=%s A=%s"), *FormatReal(Channels[0], false), *FormatReal(Channels[1], false), *FormatReal(Channels[2], false), *FormatReal(Channels[3], false));
+		}
+		else if (StructName == Color && Size == 4)
+		{
+			// FColor is stored as its packed BGRA dword
+			OutValue = FString::Printf(TEXT("R=%d G=%d B=%d A=%d"), Bytes[2], Bytes[1], Bytes[0], Bytes[3]);
+		}
+		else if (StructName == Guid && Size == sizeof(FGuid))
+		{
+			FGuid Value;
+			FMemory::Memcpy(&Value, Bytes, sizeof(FGuid));
+			OutValue = Value.ToString();
+		}
+		else if ((StructName == IntPoint && Size == 2 * sizeof(int32)) || (StructName == IntVector && Size == 3 * sizeof(int32)))
+		{
+			int32 Components[3] = { 0, 0, 0 };
+			FMemory::Memcpy(Components, Bytes, Size);
+			OutValue = StructName == IntPoint
+				? FString::Printf(TEXT("X=%d Y=%d"), Components[0], Components[1])
+				: FString::Printf(TEXT("X=%d Y=%d Z=%d"), Components[0], Components[1], Components[2]);
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+
+	void AddLeaf(const FString& Path, FName Type, FString Value, uint64 Hash)
+	{
+		FTaggedPropertyValue& Leaf = Values.AddDefaulted_GetRef();
+		Leaf.Path = Path;
+		Leaf.Type = Type;
+		Leaf.Value = MoveTemp(Value);
+		Leaf.Hash = Hash;
+	}
+
+	/** Decoded values are compared by what they resolve to: the serialized name and import indices are local to the package and renumbered on save */
+	void AddLeaf(const FString& Path, FName Type, FString Value)
+	{
+		const uint64 Hash = CityHash64(reinterpret_cast<const char*>(*Value), Value.Len() * sizeof(TCHAR));
+		AddLeaf(Path, Type, MoveTemp(Value), Hash);
+	}
+
+	/** Indices inside a blob can't be located, so a blob only matches one from a package whose tables resolve them the same way */
+	void AddRawLeaf(const FString& Path, FName Type, int64 Start, int64 End)
+	{
+		const uint64 Hash = CityHash64WithSeed(reinterpret_cast<const char*>(ExportData.GetData() + Start), End - Start, TablesHash);
+		AddLeaf(Path, Type, FString::Printf(TEXT("<%lld bytes, %016llx>"), End - Start, Hash), Hash);
+	}
+
+	const FPackageFileReader& Package;
+	TArrayView<const uint8> ExportData;
+	TArray<FTaggedPropertyValue>& Values;
+	uint64 TablesHash;
+};
+
+bool FTaggedPropertyTree::Read(const FPackageFileReader& Package)
+{
+	Values.Reset();
+
+	const int32 AssetExportIndex = Package.FindAssetExportIndex();
+	if (AssetExportIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const TArray<FObjectExport>& ExportMap = Package.GetExportMap();
+	const uint64 TablesHash = Package.GetTablesHash();
+	const FPackageIndex AssetIndex = FPackageIndex::FromExport(AssetExportIndex);
+	for (int32 ExportIndex = 0; ExportIndex < ExportMap.Num(); ++ExportIndex)
+	{
+		const FObjectExport& Export = ExportMap[ExportIndex];
+		const bool bIsAsset = ExportIndex == AssetExportIndex;
+		if (!bIsAsset && Export.OuterIndex != AssetIndex)
+		{
+			continue;
+		}
+
+		TArrayView<const uint8> ExportData = Package.GetExportData(Export);
+		TUniquePtr<FPackageNameArchive> Ar = Package.CreateExportArchive(Export);
+		FTaggedPropertyParser Parser(Package, ExportData, Values, TablesHash);
+		const FString Prefix = bIsAsset ? FString() : Export.ObjectName.ToString() + TEXT(":");
+		if (Parser.ParseTaggedStream(*Ar, Prefix, ExportData.Num(), 0))
+		{
+			Parser.AddNativeData(Prefix, Ar->Tell());
+		}
+		else if (bIsAsset)
+		{
+			UE_LOG(LogTaggedPropertyReader, Verbose, TEXT("Tagged property stream of %s ended early"), *Export.ObjectName.ToString());
+			return false;
+		}
+	}
+
+	Values.Sort([](const FTaggedPropertyValue& A, const FTaggedPropertyValue& B) { return A.Path < B.Path; });
+	return true;
+}
+
+bool FTaggedPropertyTree::ReadFile(const FString& Filename)
+{
+	FPackageFileReader Package;
+	return Package.Open(Filename) && Read(Package);
+}
+
+const FTaggedPropertyValue* FTaggedPropertyTree::Find(const FString& Path) const
+{
+	const int32 Index = Algo::BinarySearchBy(Values, Path, &FTaggedPropertyValue::Path);
+	return Index != INDEX_NONE ? &Values[Index] : nullptr;
+}
+
+void TaggedPropertyDiff::Diff(const FTaggedPropertyTree& OldTree, const FTaggedPropertyTree& NewTree, TArray<FTaggedPropertyDifference>& OutDifferences)
+{
+	const TArray<FTaggedPropertyValue>& OldValues = OldTree.GetValues();
+	const TArray<FTaggedPropertyValue>& NewValues = NewTree.GetValues();
+
+	int32 OldIndex = 0;
+	int32 NewIndex = 0;
+	while (OldIndex < OldValues.Num() || NewIndex < NewValues.Num())
+	{
+		const FTaggedPropertyValue* Old = OldIndex < OldValues.Num() ? &OldValues[OldIndex] : nullptr;
+		const FTaggedPropertyValue* New = NewIndex < NewValues.Num() ? &NewValues[NewIndex] : nullptr;
+		if (Old && New && Old->Path == New->Path)
+		{
+			if (Old->Hash != New->Hash)
+			{
+				OutDifferences.Add({ New->Path, EPropertyDiffType::PropertyValueChanged, Old->Value, New->Value });
+			}
+			++OldIndex;
+			++NewIndex;
+		}
+		else if (Old && (!New || Old->Path < New->Path))
+		{
+			// Missing on the new side means it went back to the class default
+			OutDifferences.Add({ Old->Path, EPropertyDiffType::PropertyAddedToA, Old->Value, FString() });
+			++OldIndex;
+		}
+		else
+		{
+			OutDifferences.Add({ New->Path, EPropertyDiffType::PropertyAddedToB, FString(), New->Value });
+			++NewIndex;
+		}
+	}
+}
+
+bool TaggedPropertyDiff::DiffFiles(const FString& OldFilename, const FString& NewFilename, TArray<FTaggedPropertyDifference>& OutDifferences)
+{
+	FTaggedPropertyTree OldTree;
+	FTaggedPropertyTree NewTree;
+	if (!OldTree.ReadFile(OldFilename) || !NewTree.ReadFile(NewFilename))
+	{
+		return false;
+	}
+
+	Diff(OldTree, NewTree, OutDifferences);
+	return true;
+}
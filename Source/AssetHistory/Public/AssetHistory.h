@@ -15,4 +15,11 @@ public:
 
 private:
 	TSharedPtr<class FDataAssetTypeActions> DataAssetTypeActions;
+	TSharedPtr<class FDataTableTypeActions> DataTableTypeActions;
+
+	/** Handle of the History toolbar extender added to the stock DataTable and curve editors */
+	FDelegateHandle ToolbarExtenderHandle;
+
+	/** Idle time history fetching, editor only */
+	TSharedPtr<class FHistoryWarmUp> HistoryWarmUp;
 };
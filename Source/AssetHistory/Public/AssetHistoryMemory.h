@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/** LLM tags of the plugin, listed under AssetHistory by stat LLMFULL and in the LLM csv */
+LLM_DECLARE_TAG_API(AssetHistory, ASSETHISTORY_API);
+/** Revision store and local history */
+LLM_DECLARE_TAG_API(AssetHistory_Caches, ASSETHISTORY_API);
+/** Scheduler jobs, warm-up and git batch processes */
+LLM_DECLARE_TAG_API(AssetHistory_SourceControl, ASSETHISTORY_API);
+/** Revisions loaded with LOAD_ForDiff */
+LLM_DECLARE_TAG_API(AssetHistory_DiffPackages, ASSETHISTORY_API);
+LLM_DECLARE_TAG_API(AssetHistory_DiffWindows, ASSETHISTORY_API);
+LLM_DECLARE_TAG_API(AssetHistory_Menus, ASSETHISTORY_API);
+
+/**
+ * Breakdown printed by the AssetHistory.MemReport console command.
+ * Sizes are what the plugin's containers hold and what the diff packages serialize to; widget trees are only counted, their bytes are in the LLM tags.
+ */
+namespace AssetHistoryMemory
+{
+	enum class EWidget : uint8
+	{
+		DataAssetDiff,
+		DataTableDiff,
+		CurveDiff,
+		RevisionMenu,
+		DataAssetMerge,
+		Num
+	};
+
+	/** Widgets add one on construction and remove it in their destructor */
+	ASSETHISTORY_API void TrackWidget(EWidget Widget, int32 Delta);
+
+	ASSETHISTORY_API void PrintReport(FOutputDevice& Ar);
+}
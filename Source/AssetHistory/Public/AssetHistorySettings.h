@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "AssetHistorySettings.generated.h"
+
+/** Per user settings of the AssetHistory plugin, under Editor Preferences > Plugins > Asset History */
+UCLASS(config = EditorPerProjectUserSettings, meta = (DisplayName = "Asset History"))
+class ASSETHISTORY_API UAssetHistorySettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UAssetHistorySettings();
+
+	/** Source control requests the plugin runs at once, clicks in the editor are not bound by it */
+	UPROPERTY(config, EditAnywhere, Category = "Source Control", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 MaxConcurrentJobs = 2;
+
+	/** Start downloading the two revisions of a History menu entry while it is hovered or selected with the keyboard, so the click finds them local */
+	UPROPERTY(config, EditAnywhere, Category = "Source Control")
+	bool bPrefetchHoveredRevisions = true;
+
+	/** Fetch histories in the background for recently opened assets, checked out assets and the current Content Browser folder */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up")
+	bool bEnableWarmUp = true;
+
+	/** Also download the latest revisions of those assets into the local revision store */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp"))
+	bool bWarmUpRevisionFiles = false;
+
+	/** How many of the latest revisions of each asset to download when warming revision files */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp && bWarmUpRevisionFiles", ClampMin = "1", ClampMax = "32"))
+	int32 RevisionFilesPerAsset = 4;
+
+	/** Upper bound of background source control requests, a history query and a revision download count as one each */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp", ClampMin = "1", ClampMax = "600"))
+	int32 MaxRequestsPerMinute = 20;
+
+	/** Files per history query */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp", ClampMin = "1", ClampMax = "100"))
+	int32 HistoryBatchSize = 8;
+
+	/** Warm up only after this long without user input */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp", ClampMin = "0", Units = "s"))
+	float IdleSeconds = 5.0f;
+
+	/** Warm up pauses while the average frame takes longer than this */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp", ClampMin = "1", Units = "ms"))
+	float MaxFrameTimeMs = 50.0f;
+
+	/** Histories older than this are fetched again */
+	UPROPERTY(config, EditAnywhere, Category = "Warm Up", meta = (EditCondition = "bEnableWarmUp", ClampMin = "1", Units = "min"))
+	float RefreshMinutes = 60.0f;
+
+	/** Keep a local snapshot of data assets, data tables and curve tables on every save, listed in the History menu even without source control */
+	UPROPERTY(config, EditAnywhere, Category = "Local History")
+	bool bEnableLocalSnapshots = true;
+
+	/** Snapshots kept per asset, the oldest is dropped past this */
+	UPROPERTY(config, EditAnywhere, Category = "Local History", meta = (EditCondition = "bEnableLocalSnapshots", ClampMin = "1", ClampMax = "200"))
+	int32 MaxLocalSnapshots = 20;
+
+	/** Data asset diffs also compare the instanced sub-objects (EditInlineNew) of both sides */
+	UPROPERTY(config, EditAnywhere, Category = "Diff")
+	bool bDiffInstancedSubObjects = true;
+
+	/** Data asset diffs also compare the referenced data assets, each at the revision matching the diffed one */
+	UPROPERTY(config, EditAnywhere, Category = "Diff")
+	bool bDiffReferencedDataAssets = false;
+
+	/** Float, vector, rotator and color components closer than this are equal in diffs, 0 compares them exactly */
+	UPROPERTY(config, EditAnywhere, Category = "Diff", meta = (ClampMin = "0"))
+	float DiffTolerance = 0.0f;
+
+	/** How many sub-object or reference levels the deep diff follows */
+	UPROPERTY(config, EditAnywhere, Category = "Diff", meta = (EditCondition = "bDiffInstancedSubObjects || bDiffReferencedDataAssets", ClampMin = "1", ClampMax = "16"))
+	int32 DeepDiffMaxDepth = 4;
+
+	/** Arrays of structs with at least this many elements are diffed as a table, one row per element, instead of in the details panels. 0 keeps them all in the details panels */
+	UPROPERTY(config, EditAnywhere, Category = "Diff", meta = (ClampMin = "0"))
+	int32 StructArrayTableMinElements = 50;
+
+	/** Most recently opened assets, newest first, kept across sessions so the first History click of the day is warm */
+	UPROPERTY(config)
+	TArray<FString> RecentAssets;
+
+	static constexpr int32 MaxRecentAssets = 32;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetHistoryTextConvCommandlet.generated.h"
+
+/**
+ * Writes the canonical text of a package file (see CanonicalText), for tools outside the editor, e.g. a git textconv driver:
+ *   UnrealEditor-Cmd Project.uproject -run=AssetHistoryTextConv <Package.uasset> -Out=<File.txt> -unattended -nosplash
+ * git passes the package as a temp file and reads the text from stdout, so the driver is a script that runs the above and prints File.txt.
+ * The package isn't loaded and its name doesn't matter, the asset is its only public top level export.
+ */
+UCLASS()
+class UAssetHistoryTextConvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAssetHistoryTextConvCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
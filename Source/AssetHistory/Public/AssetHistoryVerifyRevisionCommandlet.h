@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetHistoryVerifyRevisionCommandlet.generated.h"
+
+/**
+ * Checks that every primary data asset at a past revision still loads and diffs against the current content, e.g. before branching:
+ *   UnrealEditor-Cmd Project.uproject -run=AssetHistoryVerifyRevision -Changelist=<N> [-Path=/Game/Data] [-Report=<File.csv>] -unattended -nosplash
+ * -Date=<yyyy.mm.dd-hh.mm.ss> picks the revisions by date instead, for providers without numbered changelists.
+ * Revisions are fetched on workers through FSourceControlScheduler while the game thread loads and diffs the ones that arrived.
+ * Returns 1 when any asset failed. The report has the result and the time of each step per asset.
+ */
+UCLASS()
+class UAssetHistoryVerifyRevisionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAssetHistoryVerifyRevisionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
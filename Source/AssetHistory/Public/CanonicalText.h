@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FTaggedPropertyTree;
+struct FTaggedPropertyDifference;
+
+/**
+ * Deterministic text form of an asset revision: a header line, then one "Path = Value" line per leaf of its tagged property tree,
+ * sorted by path, UTF-8. Values are rendered as FTaggedPropertyTree renders them and escaped onto their line, '=' is escaped in paths.
+ * Built without LoadPackage, so external tools (see UAssetHistoryTextConvCommandlet) can use it as well as the history operations.
+ */
+namespace CanonicalText
+{
+	/** False for a text written by another version of the format, cached texts are rebuilt then */
+	ASSETHISTORY_API bool HasCurrentHeader(TArrayView64<const uint8> Text);
+
+	/** Streams the lines of Tree to Ar, one line at a time */
+	ASSETHISTORY_API void Write(const FTaggedPropertyTree& Tree, FArchive& Ar);
+
+	/** Reads package content, Filename is what it was saved as and names the asset. False when it isn't a readable package */
+	ASSETHISTORY_API bool WritePackageData(const FString& Filename, TArray64<uint8>&& Data, FArchive& Ar);
+	ASSETHISTORY_API bool WritePackageFile(const FString& Filename, FArchive& Ar);
+
+	/**
+	 * Line diff of two texts. Both are sorted by path, so it is one merge pass: identical lines are skipped on a byte compare
+	 * and only the lines that differ are decoded.
+	 */
+	ASSETHISTORY_API void Diff(TArrayView64<const uint8> OldText, TArrayView64<const uint8> NewText, TArray<FTaggedPropertyDifference>& OutDifferences);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+/** Churn of one asset, or of every asset directly in a folder */
+struct FChurnSummary
+{
+	/** Package name, or the package path of a folder */
+	FString Name;
+	int32 NumAssets = 0;
+	int32 NumRevisions = 0;
+	/** Over the last weeks asked for, not the whole history */
+	float RevisionsPerWeek = 0.0f;
+	FDateTime LastChange;
+	int32 NumAuthors = 0;
+	/** Most active first, with their revision counts */
+	FString TopAuthors;
+	/** Most often changed first, array indices stripped, with the number of revisions that changed them */
+	FString TopProperties;
+	int32 NumDiffs = 0;
+	/** Changed properties per diffed revision */
+	float AverageDiffSize = 0.0f;
+};
+
+/**
+ * Per-asset churn, kept up to date from what the plugin already collects: every history the scheduler fetches
+ * and every revision pair a search or a diff window compares. Each revision and each pair is counted once,
+ * so nothing is recomputed when new revisions come in. Persisted under Saved/AssetHistory/Churn.bin, every few minutes
+ * when something changed, when the tab closes and at shutdown.
+ */
+class ASSETHISTORY_API FChurnStatistics
+{
+public:
+	static FChurnStatistics& Get();
+
+	void Initialize();
+	/** Saves what changed since the last save */
+	void Shutdown();
+
+	/** Saves when anything changed since the last save. Game thread */
+	void SaveIfChanged();
+
+	/** Counts the revisions of the cached histories of Files that weren't counted yet. Game thread, reads the provider cache */
+	void AddHistories(const TArray<FString>& Files);
+
+	/** Same, for every history in the provider cache */
+	void AddCachedHistories();
+
+	/** Properties Revision changed compared to the revision before it. A pair already counted is ignored. Any thread */
+	void AddDifferences(const FString& PackageFilename, const FString& Revision, const TArray<FString>& PropertyPaths);
+
+	/** One summary per asset with any churn, then one per folder. Rates are over the last NumWeeks */
+	void GetSummaries(int32 NumWeeks, TArray<TSharedPtr<FChurnSummary>>& OutAssets, TArray<TSharedPtr<FChurnSummary>>& OutFolders);
+
+	/** Bumped on every change, for views to know when to refresh */
+	uint32 GetVersion() const { return Version; }
+
+	SIZE_T GetAllocatedSize();
+
+	/** Items[3].Name and Items[7].Name both count as Items[].Name */
+	static FString StripArrayIndices(const FString& PropertyPath);
+
+private:
+	struct FFileChurn
+	{
+		/** Revisions counted from the histories and those whose diff was counted */
+		TSet<FString> Revisions;
+		TSet<FString> DiffedRevisions;
+		/** Revisions by week since the epoch */
+		TMap<int32, int32> Weeks;
+		TMap<FString, int32> Authors;
+		TMap<FString, int32> Properties;
+		int64 NumDifferences = 0;
+		FDateTime LastChange;
+
+		friend FArchive& operator<<(FArchive& Ar, FFileChurn& Churn)
+		{
+			return Ar << Churn.Revisions << Churn.DiffedRevisions << Churn.Weeks << Churn.Authors << Churn.Properties << Churn.NumDifferences << Churn.LastChange;
+		}
+	};
+
+	void Load();
+	void Save();
+
+	FCriticalSection Lock;
+	/** By full package filename */
+	TMap<FString, FFileChurn> Files;
+	TAtomic<uint32> Version { 0 };
+	uint32 SavedVersion = 0;
+	FTSTicker::FDelegateHandle SaveTickerHandle;
+};
+
+/* Tab content: the churn of every asset or folder, sortable and exportable */
+class SChurnStatistics : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SChurnStatistics){}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	static const FName TabName;
+	static TSharedRef<class SDockTab> SpawnTab(const class FSpawnTabArgs& Args);
+
+private:
+	void Refresh();
+	void SortItems();
+	EActiveTimerReturnType PollChanges(double InCurrentTime, float InDeltaTime);
+
+	FReply OnExportClicked();
+	void OnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type InSortMode);
+	EColumnSortMode::Type GetSortMode(FName ColumnId) const;
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FChurnSummary> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnItemDoubleClicked(TSharedPtr<FChurnSummary> Item);
+
+	bool bShowFolders = false;
+	int32 NumWeeks = 12;
+	uint32 ShownVersion = 0;
+
+	FName SortColumn;
+	EColumnSortMode::Type SortMode = EColumnSortMode::None;
+
+	TArray<TSharedPtr<FChurnSummary>> AssetItems;
+	TArray<TSharedPtr<FChurnSummary>> FolderItems;
+	TArray<TSharedPtr<FChurnSummary>> Items;
+	TSharedPtr<SListView<TSharedPtr<FChurnSummary>>> ListView;
+};
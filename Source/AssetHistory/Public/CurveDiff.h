@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Developer/AssetTools/Public/IAssetTypeActions.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+
+struct FRealCurve;
+struct FRichCurve;
+
+/** A curve found on an asset, RichCurve is set when the fast vectorized evaluator can be used */
+struct FCurveRef
+{
+	const FRealCurve* Curve = nullptr;
+	const FRichCurve* RichCurve = nullptr;
+
+	bool IsValid() const { return Curve != nullptr; }
+};
+
+struct FCurveDiffStats
+{
+	int32 NumKeysOld = 0;
+	int32 NumKeysNew = 0;
+	/** Keys at the same time whose value, tangents or interpolation changed */
+	int32 NumKeysChanged = 0;
+	/** Keys that only exist on one side */
+	int32 NumKeysAdded = 0;
+	int32 NumKeysRemoved = 0;
+
+	float SampleStart = 0.0f;
+	float SampleEnd = 0.0f;
+	float MaxDeviation = 0.0f;
+	float MaxDeviationTime = 0.0f;
+	float MeanDeviation = 0.0f;
+
+	bool HasKeyChanges() const { return NumKeysChanged + NumKeysAdded + NumKeysRemoved > 0; }
+};
+
+struct FCurveDiffEntry
+{
+	/** Property path for embedded curves, row name for curve tables */
+	FString Path;
+	FCurveRef OldCurve;
+	FCurveRef NewCurve;
+	FCurveDiffStats Stats;
+};
+
+namespace CurveDiff
+{
+	/** Number of samples used for the deviation statistics and the plot */
+	static constexpr int32 DefaultNumSamples = 1024;
+
+	/** True for assets that get the curve diff window instead of the details diff */
+	bool IsCurveAsset(const UObject* Object);
+
+	/** Gathers every curve of Object: the rows of a curve table, or FRichCurve and FSimpleCurve properties anywhere in its reflected data */
+	void CollectCurves(const UObject* Object, TArray<TPair<FString, FCurveRef>>& OutCurves);
+
+	/** Compares the key arrays directly, keys are joined by time */
+	void CompareKeys(const FCurveRef& Old, const FCurveRef& New, FCurveDiffStats& OutStats);
+
+	/** Evaluates Curve at NumSamples evenly spaced times; rich curves are evaluated segment by segment, four samples at a time */
+	void SampleCurve(const FCurveRef& Curve, float StartTime, float EndTime, TArrayView<float> OutValues);
+
+	/** Samples both curves over the union of their key ranges and fills the deviation statistics */
+	void ComputeDeviation(const FCurveRef& Old, const FCurveRef& New, int32 NumSamples, FCurveDiffStats& OutStats);
+
+	/** Pairs the curves of both objects by path and returns the ones that changed */
+	void DiffObjects(const UObject* OldObject, const UObject* NewObject, TArray<TSharedPtr<FCurveDiffEntry>>& OutEntries);
+}
+
+/* Numeric diff of every curve in two revisions of an asset, with overlaid plots */
+class SCurveDiff : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SCurveDiff){}
+		SLATE_ARGUMENT(const UObject*, AssetOld)
+		SLATE_ARGUMENT(const UObject*, AssetNew)
+		SLATE_ARGUMENT(struct FRevisionInfo, OldRevision)
+		SLATE_ARGUMENT(struct FRevisionInfo, NewRevision)
+		SLATE_ARGUMENT(TSharedPtr<SWindow>, ParentWindow)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SCurveDiff();
+
+	/** Helper function to create a window that holds a diff widget */
+	static TSharedPtr<SWindow> CreateDiffWindow(FText WindowTitle, const UObject* AssetOld, const UObject* AssetNew, const struct FRevisionInfo& OldRevision, const struct FRevisionInfo& NewRevision);
+
+	const TArray<TSharedPtr<FCurveDiffEntry>>& GetEntries() const { return Entries; }
+
+	/** Selects the curve at Path and shows its plot */
+	void SelectCurve(const FString& Path);
+
+protected:
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FCurveDiffEntry> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnSelectionChanged(TSharedPtr<FCurveDiffEntry> Item, ESelectInfo::Type SelectInfo);
+
+	/** Called when editor may need to be closed */
+	void OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason CloseReason);
+
+	TArray<TSharedPtr<FCurveDiffEntry>> Entries;
+
+	TSharedPtr<SListView<TSharedPtr<FCurveDiffEntry>>> CurveListView;
+	TSharedPtr<class SCurveDiffPlot> Plot;
+
+	/** A pointer to the window holding this */
+	TWeakPtr<SWindow> WeakParentWindow;
+
+	FDelegateHandle AssetEditorCloseDelegate;
+	const UObject* AssetOld;
+	const UObject* AssetNew;
+};
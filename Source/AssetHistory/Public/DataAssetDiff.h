@@ -4,6 +4,7 @@
 #include "Widgets/SCompoundWidget.h"
 #include "Developer/AssetTools/Public/IAssetTypeActions.h"
 #include "DiffUtils.h"
+#include "DifferenceTree.h"
 
 /* Visual Diff between two Blueprints*/
 class SDataAssetDiff: public SCompoundWidget
@@ -59,6 +60,16 @@ protected:
 	/** Function used to generate the list of differences and the widgets needed to calculate that list */
 	void GenerateDifferencesList();
 
+	/** Compares the assets on a worker, showing its progress until the panels can be generated */
+	void StartDiff();
+	void CancelDiff();
+	bool IsDiffComplete() const;
+	FText GetDiffProgressText() const;
+	EActiveTimerReturnType PollDiff(double InCurrentTime, float InDeltaTime);
+
+	/** Asks for a file and streams the differences of every panel to it */
+	void ExportDifferences();
+
 	/** Called when editor may need to be closed */
 	void OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason CloseReason);
 
@@ -76,6 +87,27 @@ protected:
 
 	FDiffControl GenerateDefaultsPanel();
 
+	/** Numeric diff of curves embedded in the asset, only added when some curve changed */
+	FDiffControl GenerateCurvesPanel();
+
+	/** Called when a curve entry of the differences tree is selected */
+	void OnCurveEntryFocused(FString CurvePath);
+
+	/** Large struct arrays that changed, as tables, see UAssetHistorySettings::StructArrayTableMinElements */
+	FDiffControl GenerateStructArraysPanel();
+
+	/** Called when a row of a struct array table is selected in the differences tree */
+	void OnStructArrayRowFocused(int32 ArrayIndex, TSharedPtr<struct FStructArrayRowDiff> Row);
+
+	/** Instanced sub-objects and referenced data assets that changed, see UAssetHistorySettings */
+	FDiffControl GenerateSubObjectsPanel();
+
+	/** Offers to bisect the history of the property a difference is about */
+	TSharedPtr<SWidget> OnDifferenceContextMenu(const FDifferenceTreeItem& Item);
+
+	/** Shows the details of a changed sub-object pair, its panels are created on first selection */
+	void OnSubObjectEntryFocused(int32 PairIndex, FPropertySoftPath Property);
+
 	TSharedRef<SBox> GenerateRevisionInfoWidgetForPanel(TSharedPtr<SWidget>& OutGeneratedWidget,const FText& InRevisionText) const;
 
 	/** Accessor and event handler for toggling between diff view modes (defaults, components, graph view, interface, macro): */
@@ -107,14 +139,11 @@ protected:
 	/** We can't use the global tab manager because we need to instance the diff control, so we have our own tab manager: */
 	TSharedPtr<FTabManager> TabManager;
 
-	/** Tree of differences collected across all panels: */
-	TArray< TSharedPtr<class FBlueprintDifferenceTreeEntry> > MasterDifferencesList;
-
-	/** List of all differences, cached so that we can iterate only the differences and not labels, etc: */
-	TArray< TSharedPtr<class FBlueprintDifferenceTreeEntry> > RealDifferences;
+	/** Differences collected across all panels, handed to the tree once all panels are generated */
+	TArray<FDifferenceTreeItem> TreeItems;
 
-	/** Tree view that displays the differences, cached for the buttons that iterate the differences: */
-	TSharedPtr< STreeView< TSharedPtr< FBlueprintDifferenceTreeEntry > > > DifferencesTreeView;
+	/** Tree that displays the differences, cached for the buttons that iterate the differences: */
+	TSharedPtr<SDifferenceTree> DifferenceTree;
 
 	/** Stored references to widgets used to display various parts of a blueprint, from the mode name */
 	TMap<FName, FDiffControl> ModePanels;
@@ -122,6 +151,24 @@ protected:
 	/** A pointer to the window holding this */
 	TWeakPtr<SWindow> WeakParentWindow;
 
+	/** Curve panel, kept so tree entries can select a curve */
+	TSharedPtr<class SCurveDiff> CurveDiffWidget;
+
+	/** Struct array tables, kept so tree entries can select a row */
+	TSharedPtr<class SStructArrayDiff> StructArrayDiffWidget;
+
+	TSharedPtr<class FDeepObjectDiff> DeepDiff;
+	TMap<int32, TSharedPtr<class FDetailsDiffControl>> SubObjectDiffControls;
+	TSharedPtr<SBox> SubObjectContents;
+
+	/** Defaults panel, kept for the property differences it found */
+	TSharedPtr<class FDetailsDiffControl> DefaultsDiffControl;
+
+	TSharedPtr<class FDataAssetDiffTask, ESPMode::ThreadSafe> DiffTask;
+
+	struct FRevisionInfo OldRevision;
+	struct FRevisionInfo NewRevision;
+
 	FDelegateHandle AssetEditorCloseDelegate;
 	const UPrimaryDataAsset* AssetOld;
 	const UPrimaryDataAsset* AssetNew;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "IAssetTypeActions.h"
+#include "PropertyDiff.h"
+
+enum class EMergeChange : uint8
+{
+	/** Only the local side changed it, it is already merged */
+	Local,
+	/** Only the remote side changed it, applied by the merge */
+	Remote,
+	/** Both sides made the same change */
+	Both,
+	/** Both sides changed it differently, someone has to pick */
+	Conflict,
+};
+
+/**
+ * A property path changed on one or both sides since the base. Entries never nest: a struct or array both sides changed
+ * is split into its members and elements, anything else is one entry, so each can be applied on its own.
+ * The value pointers are into the three objects and stay valid until the local one is applied to, the merge window is modal for that reason.
+ */
+struct FMergeEntry
+{
+	/** Display path, e.g. Stats.Cooldown or Items[2].Name */
+	FString Path;
+	const FProperty* Property = nullptr;
+	const void* BaseValue = nullptr;
+	void* LocalValue = nullptr;
+	const void* RemoteValue = nullptr;
+	EMergeChange Change = EMergeChange::Local;
+	/** Only conflicts are picked, the other kinds have one answer */
+	bool bTakeRemote = false;
+	/** Instanced sub-objects can't be copied across packages, such a conflict stays local */
+	bool bCanTakeRemote = true;
+};
+
+namespace DataAssetMerge
+{
+	/**
+	 * Both sides against the base, in one walk of the three objects, classified per property path.
+	 * Safe on a worker while the objects are kept alive. Returns false when Progress was cancelled.
+	 */
+	ASSETHISTORY_API bool Classify(const UObject* Base, UObject* Local, const UObject* Remote, TArray<FMergeEntry>& OutEntries, FDiffProgress* Progress = nullptr);
+
+	/** Copies the remote value of every Remote entry and of the conflicts picked remote into Local, as one undoable transaction. Game thread */
+	ASSETHISTORY_API int32 Apply(UObject* Local, TArrayView<const FMergeEntry> Entries);
+
+	/** Value as text, for display */
+	ASSETHISTORY_API FString ExportValue(const FProperty* Property, const void* Value);
+}
+
+/* Three-way merge window: every changed path with its base, local and remote values, conflicts picked one by one, everything else applied at once */
+class SDataAssetMerge : public SCompoundWidget, public FGCObject
+{
+public:
+	SLATE_BEGIN_ARGS(SDataAssetMerge){}
+		SLATE_ARGUMENT(const UObject*, BaseAsset)
+		SLATE_ARGUMENT(UObject*, LocalAsset)
+		SLATE_ARGUMENT(const UObject*, RemoteAsset)
+		SLATE_ARGUMENT(FOnMergeResolved, OnMergeResolved)
+		SLATE_ARGUMENT(TSharedPtr<SWindow>, ParentWindow)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SDataAssetMerge();
+
+	/** Base, local and remote already loaded, OnMergeResolved is told how the merge ended. Modal, returns once the window is closed */
+	static void CreateMergeWindow(const UObject* BaseAsset, UObject* LocalAsset, const UObject* RemoteAsset, const FOnMergeResolved& OnMergeResolved);
+
+	/** For an asset in conflict after a sync: fetches its base and the revision it was synced to, merges them and marks the file resolved */
+	static void MergeConflictedAsset(UObject* LocalAsset);
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("SDataAssetMerge"); }
+
+private:
+	EActiveTimerReturnType PollClassify(double InCurrentTime, float InDeltaTime);
+	void RefreshVisibleEntries();
+
+	FReply OnApplyClicked();
+	FReply OnCancelClicked();
+	void SetAllConflicts(bool bTakeRemote);
+	FText GetStatusText() const;
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FMergeEntry> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Ends the merge once, the window closing without Apply is a cancel */
+	void Resolve(EMergeResult::Type Result);
+
+	TObjectPtr<UObject> BaseAsset = nullptr;
+	TObjectPtr<UObject> LocalAsset = nullptr;
+	TObjectPtr<UObject> RemoteAsset = nullptr;
+	FOnMergeResolved OnMergeResolved;
+	TWeakPtr<SWindow> WeakParentWindow;
+	bool bResolved = false;
+
+	TSharedPtr<class FDataAssetMergeTask, ESPMode::ThreadSafe> Task;
+	TArray<TSharedPtr<FMergeEntry>> Entries;
+	TArray<TSharedPtr<FMergeEntry>> VisibleEntries;
+	bool bShowAutoMerged = false;
+	TSharedPtr<SListView<TSharedPtr<FMergeEntry>>> ListView;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Developer/AssetTools/Public/IAssetTypeActions.h"
+#include "Subsystems/AssetEditorSubsystem.h"
+
+class UDataTable;
+
+namespace EDataTableRowDiffType
+{
+	enum Type
+	{
+		Added,
+		Removed,
+		Modified,
+	};
+}
+
+/** One changed cell of a modified row, values are only exported to text once we know they differ */
+struct FDataTableCellDiff
+{
+	int32 ColumnIndex = INDEX_NONE;
+	FString OldValue;
+	FString NewValue;
+};
+
+struct FDataTableRowDiff
+{
+	FName RowName;
+	EDataTableRowDiffType::Type DiffType = EDataTableRowDiffType::Modified;
+	TArray<FDataTableCellDiff> Cells;
+};
+
+struct FDataTableDiffResult
+{
+	/** Only the columns that have at least one changed cell */
+	TArray<FName> Columns;
+	TArray<FText> ColumnDisplayNames;
+
+	TArray<TSharedPtr<FDataTableRowDiff>> Rows;
+
+	/** Rows by diff type, counted once while diffing */
+	int32 NumRowsAdded = 0;
+	int32 NumRowsRemoved = 0;
+	int32 NumRowsModified = 0;
+
+	int32 NumRowsCompared = 0;
+	int32 NumRowsHashMatched = 0;
+};
+
+namespace DataTableDiff
+{
+	/** Hashes the binary serialized form of one row, no text export involved */
+	uint64 HashRow(const UScriptStruct* RowStruct, const uint8* RowData);
+
+	/** Joins both tables by row name and only compares the columns of rows whose hash changed */
+	void DiffTables(const UDataTable* TableOld, const UDataTable* TableNew, FDataTableDiffResult& OutResult);
+}
+
+/* Row keyed diff between two revisions of a DataTable */
+class SDataTableDiff : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SDataTableDiff){}
+		SLATE_ARGUMENT(const UDataTable*, TableOld)
+		SLATE_ARGUMENT(const UDataTable*, TableNew)
+		SLATE_ARGUMENT(struct FRevisionInfo, OldRevision)
+		SLATE_ARGUMENT(struct FRevisionInfo, NewRevision)
+		SLATE_ARGUMENT(TSharedPtr<SWindow>, ParentWindow)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SDataTableDiff();
+
+	/** Helper function to create a window that holds a diff widget */
+	static TSharedPtr<SWindow> CreateDiffWindow(FText WindowTitle, const UDataTable* TableOld, const UDataTable* TableNew, const struct FRevisionInfo& OldRevision, const struct FRevisionInfo& NewRevision);
+
+protected:
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FDataTableRowDiff> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Called when editor may need to be closed */
+	void OnCloseAssetEditor(UObject* Asset, EAssetEditorCloseReason CloseReason);
+
+	FText GetSummaryText() const;
+
+	FDataTableDiffResult DiffResult;
+
+	TSharedPtr<SListView<TSharedPtr<FDataTableRowDiff>>> RowListView;
+
+	/** A pointer to the window holding this */
+	TWeakPtr<SWindow> WeakParentWindow;
+
+	FDelegateHandle AssetEditorCloseDelegate;
+	const UDataTable* TableOld;
+	const UDataTable* TableNew;
+};
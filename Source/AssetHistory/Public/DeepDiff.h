@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "DiffUtils.h"
+#include "PropertyDiff.h"
+
+/** Two versions of a sub-object or referenced asset that differ, or exist on one side only */
+struct FDeepDiffPair
+{
+	/** "Effects.Burn_0" for sub-objects, referenced assets start with "AssetName:" */
+	FString Path;
+	const UObject* OldObject = nullptr;
+	const UObject* NewObject = nullptr;
+	TArray<FSingleObjectDiffEntry> Differences;
+	bool bReferencedAsset = false;
+	/** A referenced asset whose history isn't cached yet, neither object is set */
+	bool bHistoryNotFetched = false;
+};
+
+/**
+ * Follows instanced sub-objects and, optionally, referenced data assets below the diffed objects.
+ * Every object pair is compared once: a pair reached again, through a shared sub-graph or a cycle, is skipped.
+ * Holds the objects it compared, the referenced revisions it loaded would be collected otherwise.
+ * Can run on a worker: referenced revisions are then loaded on the game thread while the worker waits.
+ */
+class ASSETHISTORY_API FDeepObjectDiff : public FGCObject
+{
+public:
+	struct FOptions
+	{
+		bool bFollowInstancedSubObjects = true;
+		bool bFollowReferencedDataAssets = false;
+		int32 MaxDepth = 4;
+
+		/** Dates of the two sides, referenced assets are loaded at the last revision up to them. HEAD is the current asset */
+		FRevisionInfo OldRevision;
+		FRevisionInfo NewRevision;
+
+		/** Counts what was compared, and stops the diff once cancelled */
+		FDiffProgress* Progress = nullptr;
+	};
+
+	explicit FDeepObjectDiff(const FOptions& InOptions);
+
+	/** The differences of OldRoot and NewRoot themselves are not reported, only those found below them. Construct on the game thread, diff on any */
+	void Diff(const UObject* OldRoot, const UObject* NewRoot);
+
+	const TArray<FDeepDiffPair>& GetPairs() const { return Pairs; }
+	int32 GetNumComparedPairs() const { return Visited.Num(); }
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override { return TEXT("FDeepObjectDiff"); }
+
+private:
+	void DiffPair(const UObject* OldObject, const UObject* NewObject, const FString& Path, int32 Depth, bool bReferencedAsset);
+	void DiffSubObjects(const UObject* OldObject, const UObject* NewObject, const FString& Path, int32 Depth);
+	void DiffReferencedAssets(const UObject* OldObject, const UObject* NewObject, int32 Depth);
+
+	/** Referenced asset as it was at Revision, null when it didn't exist yet or its history isn't known */
+	const UObject* LoadAtRevision(const UObject* Asset, const FRevisionInfo& Revision);
+
+	bool IsCancelled() const { return Options.Progress && Options.Progress->bCancelled; }
+	void KeepObject(const UObject* Object);
+
+	FOptions Options;
+	TArray<FDeepDiffPair> Pairs;
+	TSet<TPair<const UObject*, const UObject*>> Visited;
+	/** Referenced asset and revision name to the loaded version, null ones included, each is fetched once */
+	TMap<TPair<const UObject*, FString>, const UObject*> LoadedRevisions;
+	/** Referenced assets LoadAtRevision found no cached history for. Game thread, read by the worker once the load it waited for is done */
+	TSet<const UObject*> AssetsWithoutHistory;
+	/** Added to by the worker while the game thread collects garbage */
+	FCriticalSection KeptObjectsLock;
+	TArray<UObject*> KeptObjects;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ISourceControlState.h"
+
+struct FTaggedPropertyDifference;
+struct FSingleObjectDiffEntry;
+
+enum class EDiffExportFormat : uint8
+{
+	Json,
+	Csv,
+	Markdown,
+};
+
+/** One exported row */
+struct FDiffExportEntry
+{
+	FString AssetName;
+	FString PropertyPath;
+	FString OldValue;
+	FString NewValue;
+	FString OldRevision;
+	FString NewRevision;
+	FString Author;
+};
+
+/**
+ * Writes differences to a file one entry at a time, nothing but the current entry is held in memory,
+ * so one writer can take the differences of any number of assets.
+ */
+class ASSETHISTORY_API FDiffExportWriter
+{
+public:
+	/** Null when the file can't be created */
+	static TUniquePtr<FDiffExportWriter> Create(const FString& Filename, EDiffExportFormat Format);
+
+	/** From the extension, .json, .csv or .md */
+	static bool FormatFromFilename(const FString& Filename, EDiffExportFormat& OutFormat);
+
+	/** File dialog filter listing the three formats */
+	static const TCHAR* GetFileTypes();
+
+	~FDiffExportWriter();
+
+	void Write(const FDiffExportEntry& Entry);
+
+	/** Writes the footer and closes the file, false when any write failed. Called by the destructor otherwise */
+	bool Close();
+
+	int64 GetNumEntries() const { return NumEntries; }
+
+private:
+	FDiffExportWriter(TUniquePtr<FArchive>&& InArchive, EDiffExportFormat InFormat);
+
+	void WriteUtf8(const FString& Text);
+
+	TUniquePtr<FArchive> Archive;
+	EDiffExportFormat Format;
+	int64 NumEntries = 0;
+};
+
+namespace DiffExport
+{
+	/** Values are exported as text from the two objects */
+	void WriteObjectDifferences(FDiffExportWriter& Writer, const UObject* OldObject, const UObject* NewObject, TArrayView<const FSingleObjectDiffEntry> Differences, const FDiffExportEntry& Common);
+
+	/** Differences of the tagged property reader, for exports that never load the revisions */
+	void WriteTaggedDifferences(FDiffExportWriter& Writer, TArrayView<const FTaggedPropertyDifference> Differences, const FDiffExportEntry& Common);
+
+	/**
+	 * Cached state of the file named like AssetName whose history has Revision. Diffed revisions live in temp packages,
+	 * this finds the file they came from. Null when that history wasn't fetched
+	 */
+	FSourceControlStatePtr FindStateWithRevision(const FString& AssetName, const FString& Revision);
+
+	/** Author of Revision in the cached history of the asset named AssetName, empty when the history wasn't fetched */
+	FString FindRevisionAuthor(const FString& AssetName, const FString& Revision);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/STreeView.h"
+#include "DiffUtils.h"
+
+/** One difference: a category, then the segments of its property path */
+struct FDifferenceTreeItem
+{
+	TArray<FString> Segments;
+	FText Label;
+	FOnDiffEntryFocused OnFocused;
+	/** Tagged path of the property, see FTaggedPropertyValue::Path. Empty when the item isn't a property of the diffed asset */
+	FString PropertyPath;
+};
+
+DECLARE_DELEGATE_RetVal_OneParam(TSharedPtr<SWidget>, FOnDifferenceTreeContextMenu, const FDifferenceTreeItem& /*Item*/);
+
+/** Group of the items sharing a path prefix, or a single item. Children of a group are built on first expansion */
+struct FDifferenceTreeNode
+{
+	FString Name;
+	/** Number of path segments this node stands for */
+	int32 Depth = 0;
+	/** Range of the visible items below this node */
+	int32 Begin = 0;
+	int32 End = 0;
+	int32 ItemIndex = INDEX_NONE;
+
+	bool bChildrenBuilt = false;
+	TArray<TSharedPtr<FDifferenceTreeNode>> Children;
+
+	bool IsLeaf() const { return ItemIndex != INDEX_NONE; }
+	int32 Num() const { return End - Begin; }
+};
+
+/**
+ * Differences grouped by property path, with counts per group and a filter box.
+ * Items are kept sorted so every group is a contiguous range of them: grouping is a scan of the range when the group opens,
+ * and next/prev step through the range instead of searching the tree.
+ */
+class SDifferenceTree : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SDifferenceTree){}
+		/** Right click on a single difference */
+		SLATE_EVENT(FOnDifferenceTreeContextMenu, OnContextMenuOpening)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Replaces the items, categories keep the order they first appear in */
+	void SetItems(TArray<FDifferenceTreeItem>&& InItems);
+
+	int32 GetNumItems() const { return Items.Num(); }
+
+	void SelectNext();
+	void SelectPrev();
+	bool HasNext() const;
+	bool HasPrev() const;
+
+private:
+	void OnFilterTextChanged(const FText& InFilterText);
+	void RebuildVisibleItems();
+
+	/** Groups the visible items of a range by their segment at Depth */
+	void BuildChildren(FDifferenceTreeNode& Node);
+	void BuildNodes(int32 Depth, int32 Begin, int32 End, TArray<TSharedPtr<FDifferenceTreeNode>>& OutNodes);
+
+	/** Expands the groups down to the visible item at Position and selects it */
+	void SelectPosition(int32 Position);
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FDifferenceTreeNode> Node, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetChildren(TSharedPtr<FDifferenceTreeNode> Node, TArray<TSharedPtr<FDifferenceTreeNode>>& OutChildren);
+	void OnSelectionChanged(TSharedPtr<FDifferenceTreeNode> Node, ESelectInfo::Type SelectInfo);
+	TSharedPtr<SWidget> OnContextMenuOpening();
+
+	FOnDifferenceTreeContextMenu OnItemContextMenuOpening;
+
+	TArray<FDifferenceTreeItem> Items;
+	/** Indices of the items passing the filter, in tree order */
+	TArray<int32> VisibleItems;
+	TArray<TSharedPtr<FDifferenceTreeNode>> RootNodes;
+
+	/** Visible item selected last, next/prev move from it */
+	int32 CurrentPosition = INDEX_NONE;
+	FString FilterText;
+	bool bSelectingPosition = false;
+
+	TSharedPtr<STreeView<TSharedPtr<FDifferenceTreeNode>>> TreeView;
+};
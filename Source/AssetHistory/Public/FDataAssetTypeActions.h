@@ -13,4 +13,8 @@ public:
 	UClass* GetSupportedClass() const override;
 	void OpenAssetEditor(const TArray<UObject*>& InObjects, TSharedPtr<class IToolkitHost> EditWithinLevelEditor = TSharedPtr<IToolkitHost>()) override;
 	void PerformAssetDiff(UObject* OldAsset, UObject* NewAsset, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision) const override;
+	bool CanMerge() const override { return true; }
+	/** Asset in conflict after a sync, its base and remote revisions are fetched */
+	void Merge(UObject* InObject) override;
+	void Merge(UObject* BaseAsset, UObject* RemoteAsset, UObject* LocalAsset, const FOnMergeResolved& ResolutionCallback) override;
 };
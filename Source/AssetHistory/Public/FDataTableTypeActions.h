@@ -0,0 +1,14 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetTypeActions/AssetTypeActions_DataTable.h"
+
+
+/**
+* Keeps the stock DataTable actions but routes diffs to the row keyed SDataTableDiff
+*/
+class ASSETHISTORY_API FDataTableTypeActions : public FAssetTypeActions_DataTable
+{
+public:
+	void PerformAssetDiff(UObject* OldAsset, UObject* NewAsset, const FRevisionInfo& OldRevision, const FRevisionInfo& NewRevision) const override;
+};
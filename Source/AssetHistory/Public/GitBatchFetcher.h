@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+class ISourceControlRevision;
+
+/** One long lived `git cat-file --batch` process, requests from any thread are served one at a time */
+class FGitBatchProcess
+{
+public:
+	FGitBatchProcess(const FString& GitBinary, const FString& InRepositoryRoot);
+	~FGitBatchProcess();
+
+	bool IsRunning() const;
+
+	/** Object is "<commit>:<path>". False when git doesn't know it or the process died */
+	bool ReadObject(const FString& Object, TArray64<uint8>& OutData);
+
+	SIZE_T GetAllocatedSize();
+
+private:
+	bool ReadLine(FString& OutLine);
+	bool ReadBytes(int64 NumBytes, TArray64<uint8>& OutData);
+
+	/** Waits until Buffer holds NumBytes past BufferOffset */
+	bool FillBuffer(int64 NumBytes);
+
+	FString RepositoryRoot;
+	FProcHandle Process;
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	void* StdInRead = nullptr;
+	void* StdInWrite = nullptr;
+
+	TArray64<uint8> Buffer;
+	int64 BufferOffset = 0;
+
+	FCriticalSection Lock;
+};
+
+/**
+ * Revision content for the Git provider without spawning a process per revision.
+ * Keeps one batch process per repository, fed by the revision store on cache misses.
+ */
+namespace GitBatchFetcher
+{
+	/** True when the current provider is Git */
+	bool IsAvailable();
+
+	/** False for other providers, unknown objects and LFS pointers git could not smudge, the caller then falls back to ISourceControlRevision::Get */
+	bool FetchRevision(const ISourceControlRevision& Revision, TArray64<uint8>& OutData);
+
+	/** Read buffers of the processes */
+	SIZE_T GetAllocatedSize();
+
+	/** Closes the processes, on module shutdown */
+	void Shutdown();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickableEditorObject.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "SourceControlScheduler.h"
+
+class IAssetEditorInstance;
+
+/**
+ * Fetches, while the editor is idle, the histories of the assets likely to be opened next:
+ * recently opened assets, checked out or modified files, and the assets of the selected Content Browser folder.
+ * Requests are rate limited and at most one is in flight, see UAssetHistorySettings.
+ */
+class FHistoryWarmUp : public FTickableEditorObject, public TSharedFromThis<FHistoryWarmUp>
+{
+public:
+	virtual ~FHistoryWarmUp();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	void OnAssetOpened(UObject* Asset, IAssetEditorInstance* EditorInstance);
+
+	/** PIE, modal windows, slow frames or recent input */
+	bool IsEditorBusy() const;
+
+	/** Rebuilds the queue from the three sources, most likely first, skipping files warmed recently */
+	void RefillQueue();
+	void EnqueueFile(const FString& Filename, bool bInFront);
+
+	void StartHistoryQuery();
+	void OnHistoryQueryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult, TArray<FString> Files);
+	void StartRevisionDownload();
+
+	TArray<FString> PendingFiles;
+	TMap<FString, double> LastWarmedTimes;
+	TArray<TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>> PendingRevisions;
+
+	FSourceControlJobId InFlightQuery = 0;
+	TAtomic<bool> bRevisionDownloadInFlight { false };
+
+	/** Token bucket of the request rate limit */
+	double Tokens = 1.0;
+	double LastTokenTime = 0.0;
+	double NextRescanTime = 0.0;
+	float AverageFrameTime = 0.0f;
+
+	FDelegateHandle AssetOpenedHandle;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "UObject/ObjectSaveContext.h"
+
+/** One saved state of an asset in the local history */
+struct FLocalSnapshot
+{
+	int32 Id = INDEX_NONE;
+	FDateTime Date;
+	int64 Size = 0;
+};
+
+/**
+ * Local history of the assets the plugin diffs, taken on every save, under Saved/AssetHistory/Local.
+ * Each file keeps a ring of its last saves: a full snapshot every few saves and deltas against it in between.
+ * A snapshot that drops out of the ring stays on disk, unlisted, until no kept delta needs it.
+ */
+class ASSETHISTORY_API FLocalSnapshotStore
+{
+public:
+	static FLocalSnapshotStore& Get();
+
+	/** Hooks package saves, game thread */
+	void Initialize();
+	void Shutdown();
+
+	/** Saves identical to the last snapshot are skipped. Safe to call from any thread */
+	bool AddSnapshot(const FString& PackageFilename, TArrayView64<const uint8> Data, const FDateTime& Date);
+
+	/** Newest first */
+	void GetSnapshots(const FString& PackageFilename, TArray<FLocalSnapshot>& OutSnapshots);
+	bool ReadSnapshot(const FString& PackageFilename, int32 Id, TArray64<uint8>& OutData);
+
+	/** Writes a snapshot to a temp file under the diff directory, for LoadPackage */
+	bool GetSnapshotFile(const FString& PackageFilename, int32 Id, FString& OutFilename);
+
+	/** Memory held by the loaded indices and the cached snapshot */
+	SIZE_T GetAllocatedSize();
+
+	/** Revision name shown in the diff windows */
+	static FString GetRevisionName(int32 Id);
+
+private:
+	struct FEntry
+	{
+		int32 Id = INDEX_NONE;
+		/** Snapshot this delta applies to, INDEX_NONE for snapshots */
+		int32 BaseId = INDEX_NONE;
+		FDateTime Date;
+		uint64 Hash = 0;
+		int64 RawSize = 0;
+		int64 StoredSize = 0;
+		/** Out of the ring, kept as the base of later deltas */
+		bool bEvicted = false;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.Id << Entry.BaseId << Entry.Date << Entry.Hash << Entry.RawSize << Entry.StoredSize << Entry.bEvicted;
+		}
+	};
+
+	struct FFileIndex
+	{
+		FString Directory;
+		int32 NextId = 0;
+		/** Oldest first */
+		TArray<FEntry> Entries;
+	};
+
+	void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext);
+	/** Snapshots the package until no save of it is pending, on a worker */
+	void TakePendingSnapshots(const FString& PackageFilename);
+
+	FFileIndex& FindOrLoadIndex(const FString& PackageFilename);
+	void SaveIndex(const FFileIndex& Index);
+	FString GetEntryFilename(const FFileIndex& Index, const FEntry& Entry) const;
+	bool ReadEntry(const FFileIndex& Index, const FEntry& Entry, TArray64<uint8>& OutData);
+
+	/** Evicts past the ring size, deletes evicted snapshots no delta needs anymore */
+	void Trim(FFileIndex& Index);
+
+	FCriticalSection Lock;
+	TMap<FString, FFileIndex> Indices;
+	/** Packages a snapshot task runs for, with the date of the save it hasn't read yet */
+	TMap<FString, TOptional<FDateTime>> PendingSaves;
+
+	/** Latest snapshot written, the next save of the same file is usually a delta against it */
+	FString CachedSnapshotFilename;
+	TArray64<uint8> CachedSnapshot;
+
+	FDelegateHandle PackageSavedHandle;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/PackageFileSummary.h"
+#include "UObject/ObjectResource.h"
+#include "Serialization/LargeMemoryReader.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** Memory reader that resolves serialized name indices through a package's name map */
+class FPackageNameArchive : public FLargeMemoryReader
+{
+public:
+	FPackageNameArchive(TArrayView64<const uint8> InData, const TArray<FName>& InNameMap);
+
+	virtual FArchive& operator<<(FName& Name) override;
+	virtual FString GetArchiveName() const override { return TEXT("FPackageNameArchive"); }
+
+	/** Versions have to match the saver or tables with version dependent layouts are misread */
+	void ApplySummaryVersions(const FPackageFileSummary& Summary);
+
+private:
+	const TArray<FName>& NameMap;
+};
+
+/**
+ * Reads the header tables of a .uasset straight from disk, without a linker and without constructing any UObject.
+ * Used to decide whether two revisions differ before paying for LoadPackage.
+ */
+class FPackageFileReader
+{
+public:
+	FPackageFileReader();
+	~FPackageFileReader();
+
+	/** Maps the file (or reads it when the platform can't map) and parses the summary, name map, import map and export map. Returns false for anything that isn't a readable package */
+	bool Open(const FString& InFilename);
+
+	/** Same as Open on bytes already in memory, InFilename only names the package */
+	bool OpenData(const FString& InFilename, TArray64<uint8>&& InData);
+
+	const FPackageFileSummary& GetSummary() const { return Summary; }
+	const TArray<FName>& GetNameMap() const { return NameMap; }
+	const TArray<FObjectImport>& GetImportMap() const { return ImportMap; }
+	const TArray<FObjectExport>& GetExportMap() const { return ExportMap; }
+
+	/** Serialized bytes of one export, as written by the saver */
+	TArrayView<const uint8> GetExportData(const FObjectExport& Export) const;
+
+	/** Archive over one export's data, with the package versions applied */
+	TUniquePtr<FPackageNameArchive> CreateExportArchive(const FObjectExport& Export) const;
+
+	/** The top level export named like the package, INDEX_NONE if there isn't one */
+	int32 FindAssetExportIndex() const;
+
+	/** Full object path of an import or export, without constructing it */
+	FString GetObjectPath(FPackageIndex Index) const;
+
+	/** Hash of the whole file */
+	uint64 GetFileHash() const;
+
+	/** Hash of the name, import and export tables by value: two packages with the same one resolve the same serialized indices to the same names and objects */
+	uint64 GetTablesHash() const;
+
+	/**
+	 * Hash of what the package contains, ignoring the parts of the header a resave rewrites (guids, saved engine version, offsets).
+	 * A moved package doesn't match: its name map holds its own path, and so may the export data.
+	 */
+	uint64 GetContentHash() const;
+
+private:
+	bool ParseTables();
+
+	FString Filename;
+
+	/** Data points either into the mapped region or into FileData */
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray64<uint8> FileData;
+	TArrayView64<const uint8> Data;
+
+	FPackageFileSummary Summary;
+	TArray<FName> NameMap;
+	TArray<FObjectImport> ImportMap;
+	TArray<FObjectExport> ExportMap;
+};
+
+namespace PackageContent
+{
+	/** True when both downloaded revisions are byte-identical or only differ in their package header */
+	bool AreContentsIdentical(const FString& FilenameA, const FString& FilenameB);
+
+	/** Remembers, for the rest of the session, that a revision pair of a file has no content change */
+	void MarkIdentical(const FString& PackageFilename, const FString& RevisionA, const FString& RevisionB);
+	bool IsKnownIdentical(const FString& PackageFilename, const FString& RevisionA, const FString& RevisionB);
+}
@@ -7,6 +7,7 @@
 #include "ISourceControlProvider.h"
 #include "SourceControlOperations.h"
 #include "AssetTypeActions_Base.h"
+#include "SourceControlScheduler.h"
 
 
 struct FRevisionInfoExtended : public FRevisionInfo
@@ -31,7 +32,7 @@ public:
 
 	~SRevisionMenu();
 
-	void Construct(const FArguments& InArgs, UPrimaryDataAsset const* Blueprint);
+	void Construct(const FArguments& InArgs, UObject const* Blueprint);
 
 private: 
 	/** Delegate used to determine the visibility 'in progress' widgets */
@@ -45,18 +46,54 @@ private:
 	void OnSourceControlQueryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
 	void OnUpdateHistoryComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
 
+	/** Fetches the pair of the hovered or keyboard selected entry once it stays there for a moment, and drops the fetch when it moves away */
+	EActiveTimerReturnType UpdatePrefetch(double InCurrentTime, float InDeltaTime);
+	void CancelPrefetch();
+
+	struct FPrefetchEntry
+	{
+		/** Contents of the menu entry, the row around it is what gets hovered */
+		TWeakPtr<SWidget> Contents;
+		FRevisionInfoExtended Prev;
+		FRevisionInfoExtended Revision;
+	};
+
 	/**  */
 	FOnRevisionSelected OnRevisionSelected;
 	/** The name of the file we want revision info for */
 	FString Filename;
 	/** The box we are using to display our menu */
 	TSharedPtr<SVerticalBox> MenuBox;
-	/** The source control operation in progress */
-	TSharedPtr<FUpdateStatus, ESPMode::ThreadSafe> SourceControlQueryOp;
+	/** The scheduled source control query in progress */
+	FSourceControlJobId SourceControlQueryJob = 0;
 	/** The state of the SCC query */
 	uint32 SourceControlQueryState;
+	/** Revision entries of the list */
+	TArray<FPrefetchEntry> PrefetchEntries;
+	/** Entry hovered or selected on the last update, and since when */
+	int32 PrefetchCandidate = INDEX_NONE;
+	double PrefetchCandidateTime = 0.0;
+	/** Fetches started for the candidate */
+	TArray<FSourceControlJobId> PrefetchJobs;
+	bool bCandidatePrefetched = false;
 };
 
+/** Shared "History" toolbar entry, used by our own editor and by the stock editors we extend */
+namespace AssetHistoryToolbar
+{
+	/** Adds the History combo button to a toolbar section */
+	void AddHistoryButton(FToolBarBuilder& ToolbarBuilder, FOnGetContent OnGetMenuContent);
+
+	/** Builds the revision menu for Object, reusing InOutRevisionPicker when it is already valid. Local snapshots come first, they need no source control */
+	TSharedRef<SWidget> MakeHistoryMenu(UObject* Object, TSharedPtr<SRevisionMenu>& InOutRevisionPicker);
+
+	/** Saves kept by FLocalSnapshotStore, each diffable against the current state or another save */
+	TSharedRef<SWidget> MakeLocalHistoryMenu(UObject* Object);
+
+	/** Toolbar extender for stock asset editors (DataTable, ...) that adds the History button after the "Asset" section */
+	TSharedRef<FExtender> MakeToolbarExtender(const TSharedRef<FUICommandList> CommandList, const TArray<UObject*> EditingObjects);
+}
+
 /**
  * 
  */
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiffUtils.h"
+
+/** What a diff running on a worker has done so far, read by the window showing it */
+struct FDiffProgress
+{
+	TAtomic<int32> PropertiesVisited { 0 };
+	TAtomic<int32> DifferencesFound { 0 };
+	TAtomic<bool> bCancelled { false };
+};
+
+/** Equality of two values of a property, Tolerance applies to floating point components */
+typedef bool (*FPropertyValueComparator)(const FProperty* Property, const void* A, const void* B, double Tolerance);
+
+/**
+ * Type specialized equality used by the diffs, without text export or allocations.
+ * Numbers, bools, names and enums compare in place, math structs within the tolerance, arrays of plain old data with one memcmp.
+ * Structs without a comparator compare member by member, instanced objects by class, name and editable properties,
+ * types nobody registered fall back to FProperty::Identical.
+ */
+class ASSETHISTORY_API FPropertyComparators
+{
+public:
+	static FPropertyComparators& Get();
+
+	/** Game thread, while no diff runs, e.g. from a module startup. A comparator covers the subclasses of PropertyClass too */
+	void RegisterPropertyClass(FFieldClass* PropertyClass, FPropertyValueComparator Comparator);
+	/** Takes precedence over the member by member comparison */
+	void RegisterStruct(const UScriptStruct* Struct, FPropertyValueComparator Comparator);
+
+	/** A and B point to the values, not their containers. Any thread */
+	bool AreEqual(const FProperty* Property, const void* A, const void* B, double Tolerance) const;
+
+private:
+	FPropertyComparators();
+
+	bool AreStructsEqual(const UScriptStruct* Struct, const void* A, const void* B, double Tolerance) const;
+	bool AreArraysEqual(const FArrayProperty* Property, const void* A, const void* B, double Tolerance) const;
+	bool AreInstancesEqual(const FObjectPropertyBase* Property, const void* A, const void* B, double Tolerance) const;
+
+	TMap<FFieldClass*, FPropertyValueComparator> PropertyClassComparators;
+	TMap<const UScriptStruct*, FPropertyValueComparator> StructComparators;
+};
+
+namespace PropertyDiff
+{
+	/** What the details panels show, anything else can't be highlighted and isn't compared */
+	ASSETHISTORY_API bool IsCompared(const FProperty* Property);
+
+	/**
+	 * Differences between the editable properties of two objects of related classes, down to struct members and array elements.
+	 * Values go through FPropertyComparators with UAssetHistorySettings::DiffTolerance.
+	 * Safe on a worker as long as the objects are kept alive. Returns false when Progress was cancelled, OutDifferences is then partial.
+	 */
+	ASSETHISTORY_API bool CompareObjects(const UObject* A, const UObject* B, TArray<FSingleObjectDiffEntry>& OutDifferences, FDiffProgress* Progress = nullptr);
+
+	/**
+	 * What a worker may compare in place of Object. Revisions loaded for diffing never change and are returned as they are,
+	 * a live asset can be edited or undone meanwhile and is duplicated into the transient package. Game thread, keep the result referenced.
+	 */
+	ASSETHISTORY_API const UObject* MakeWorkerCopy(const UObject* Object);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Containers/Queue.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "SourceControlScheduler.h"
+
+/** One property change found by the search, between a revision and the one before it */
+struct FPropertyChangeResult
+{
+	FString AssetName;
+	FString PackageName;
+	FString OldRevision;
+	FString Revision;
+	FString UserName;
+	FDateTime Date;
+	FString PropertyPath;
+	FString OldValue;
+	FString NewValue;
+};
+
+/**
+ * Finds which data assets had a property changed within a time window.
+ * Assets come from the Asset Registry, histories from the provider cache (only the missing ones are queried),
+ * and only the revision pairs inside the window are fetched and diffed, in parallel and without loading them.
+ */
+class ASSETHISTORY_API FPropertyHistorySearch : public TSharedFromThis<FPropertyHistorySearch>
+{
+public:
+	~FPropertyHistorySearch();
+
+	/** Game thread only. PropertyName matches any segment of a property path, or a sub-path when it contains a dot */
+	void Start(const FString& InPropertyName, FTimespan InWindow);
+	void Cancel();
+
+	bool IsRunning() const { return bRunning; }
+
+	/** Moves the results found since the last call into OutResults, in the order they were found */
+	void DequeueResults(TArray<TSharedPtr<FPropertyChangeResult>>& OutResults);
+
+	FText GetStatusText() const;
+
+	/** Strips array indices and compares path segments without case */
+	static bool MatchesProperty(const FString& PropertyPath, const FString& PropertyName);
+
+private:
+	/** A data asset with the revisions in the window, newest first, plus the one before the window to diff the oldest against */
+	struct FAssetRevisions
+	{
+		FString PackageFilename;
+		FString AssetName;
+		FString PackageName;
+		TArray<TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>> Revisions;
+	};
+
+	void OnHistoryUpdated(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
+	void CollectRevisions();
+	void DiffRevisions();
+	void DiffAsset(const FAssetRevisions& Asset);
+
+	FString PropertyName;
+	FDateTime Cutoff;
+
+	/** Package filename to asset and package name, for every data asset in the project */
+	TMap<FString, TPair<FString, FString>> AssetsByFilename;
+	FSourceControlJobId HistoryQueryJob = 0;
+
+	TArray<FAssetRevisions> AssetRevisions;
+	int32 NumPairs = 0;
+	TQueue<TSharedPtr<FPropertyChangeResult>, EQueueMode::Mpsc> PendingResults;
+
+	TAtomic<bool> bRunning { false };
+	TAtomic<bool> bCancelled { false };
+	TAtomic<int32> NumPairsDone { 0 };
+	bool bQueryingHistory = false;
+};
+
+/* Tab content: property name, time window, and the streamed list of changes */
+class SPropertyHistorySearch : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SPropertyHistorySearch){}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SPropertyHistorySearch();
+
+	static const FName TabName;
+	static TSharedRef<class SDockTab> SpawnTab(const class FSpawnTabArgs& Args);
+
+private:
+	FReply OnSearchClicked();
+	FReply OnExportClicked();
+	FText GetSearchButtonText() const;
+	EActiveTimerReturnType PollResults(double InCurrentTime, float InDeltaTime);
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FPropertyChangeResult> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnResultDoubleClicked(TSharedPtr<FPropertyChangeResult> Item);
+
+	TSharedPtr<FPropertyHistorySearch> Search;
+	TSharedPtr<class SEditableTextBox> PropertyNameBox;
+	int32 WindowDays = 14;
+
+	TArray<TSharedPtr<FPropertyChangeResult>> Results;
+	TSharedPtr<SListView<TSharedPtr<FPropertyChangeResult>>> ResultListView;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "Containers/Queue.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+#include "SourceControlScheduler.h"
+
+enum class EBisectPredicate : uint8
+{
+	Equals,
+	NotEquals,
+	Less,
+	Greater,
+	Contains,
+};
+
+/** A revision the bisect read, in the order they were read */
+struct FBisectStep
+{
+	FString Revision;
+	FString UserName;
+	FDateTime Date;
+	/** Value as rendered by FTaggedPropertyTree, the class default when the revision doesn't store the property */
+	FString Value;
+	bool bDefaultValue = false;
+	bool bRead = false;
+	bool bHolds = false;
+};
+
+/**
+ * Finds the first revision of an asset where a property satisfies a predicate, assuming it keeps holding in the revisions after it.
+ * A binary search over the history: about log2(n) + 1 revisions are fetched, and each is read as a tagged property tree without LoadPackage.
+ */
+class ASSETHISTORY_API FRevisionBisect : public TSharedFromThis<FRevisionBisect>
+{
+public:
+	enum class EOutcome : uint8
+	{
+		NotStarted,
+		Running,
+		Found,
+		/** The latest revision doesn't satisfy the predicate, there is nothing to search for */
+		NeverHolds,
+		Failed,
+		Cancelled,
+	};
+
+	~FRevisionBisect();
+
+	/**
+	 * Game thread only. PropertyPath is a tagged property path, e.g. Stats.Cooldown or Items[2].Name.
+	 * Revisions without the property are evaluated with its value in AssetClass's defaults.
+	 */
+	void Start(const FString& InPackageFilename, const UClass* AssetClass, const FString& InPropertyPath, EBisectPredicate InPredicate, const FString& InOperand);
+	void Cancel();
+
+	bool IsRunning() const { return Outcome == EOutcome::Running; }
+	EOutcome GetOutcome() const { return Outcome; }
+
+	/** Moves the steps read since the last call into OutSteps */
+	void DequeueSteps(TArray<TSharedPtr<FBisectStep>>& OutSteps);
+
+	FText GetStatusText() const;
+
+	static bool Evaluate(EBisectPredicate Predicate, const FString& Value, const FString& Operand);
+	static FText GetPredicateText(EBisectPredicate Predicate);
+
+	/** Source control filename of a diffed asset: its own package when it isn't a diff copy, else the cached history that has Revision */
+	static FString FindPackageFilename(const UObject* Asset, const FString& Revision);
+
+private:
+	void OnHistoryUpdated(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult);
+	void CollectRevisions();
+	void Run();
+
+	/** Fetches and evaluates one revision, by its index oldest first */
+	TSharedPtr<FBisectStep> ReadStep(int32 Index);
+
+	FString PackageFilename;
+	FString PropertyPath;
+	EBisectPredicate Predicate = EBisectPredicate::Equals;
+	FString Operand;
+	TOptional<FString> DefaultValue;
+
+	/** Oldest first */
+	TArray<TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>> Revisions;
+	FSourceControlJobId HistoryQueryJob = 0;
+	bool bQueryingHistory = false;
+
+	TQueue<TSharedPtr<FBisectStep>, EQueueMode::Spsc> PendingSteps;
+
+	TAtomic<EOutcome> Outcome { EOutcome::NotStarted };
+	TAtomic<bool> bCancelled { false };
+	/** The predicate doesn't hold at Low and holds at High, INDEX_NONE is before the history */
+	TAtomic<int32> Low { INDEX_NONE };
+	TAtomic<int32> High { INDEX_NONE };
+	TAtomic<int32> NumRead { 0 };
+	/** Revisions that couldn't be fetched or read were skipped, the result may be later than the actual first one */
+	TAtomic<bool> bSkippedRevisions { false };
+	/** Why the bisect failed, set before Outcome */
+	FText FailureText;
+};
+
+/* Bisect window: property path, predicate and operand, then the revisions read and the one found */
+class SRevisionBisect : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SRevisionBisect){}
+		SLATE_ARGUMENT(FString, PackageFilename)
+		SLATE_ARGUMENT(const UClass*, AssetClass)
+		SLATE_ARGUMENT(FString, PropertyPath)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	virtual ~SRevisionBisect();
+
+	/** PropertyPath may be empty, the user types it in then */
+	static TSharedPtr<SWindow> CreateBisectWindow(const FString& PackageFilename, const UClass* AssetClass, const FString& PropertyPath);
+
+private:
+	FReply OnStartClicked();
+	FText GetStartButtonText() const;
+	TSharedRef<SWidget> MakePredicateMenu();
+	EActiveTimerReturnType PollSteps(double InCurrentTime, float InDeltaTime);
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FBisectStep> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	FString PackageFilename;
+	TWeakObjectPtr<const UClass> AssetClass;
+	EBisectPredicate Predicate = EBisectPredicate::Equals;
+
+	TSharedPtr<FRevisionBisect> Bisect;
+	TSharedPtr<class SEditableTextBox> PropertyPathBox;
+	TSharedPtr<class SEditableTextBox> OperandBox;
+
+	TArray<TSharedPtr<FBisectStep>> Steps;
+	TSharedPtr<SListView<TSharedPtr<FBisectStep>>> StepListView;
+};
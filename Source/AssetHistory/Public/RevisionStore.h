@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ISourceControlRevision.h"
+
+namespace RevisionDelta
+{
+	/** Copy/insert ops that turn Base into Target, found with a rolling hash over Base's blocks */
+	void Encode(TArrayView64<const uint8> Base, TArrayView64<const uint8> Target, TArray64<uint8>& OutDelta);
+
+	/** Returns false on a corrupt delta or one made against another base */
+	bool Apply(TArrayView64<const uint8> Base, TArrayView64<const uint8> Delta, TArray64<uint8>& OutTarget);
+}
+
+/** Zlib compressed files with a small header, for the revision and snapshot stores */
+namespace RevisionStoreFile
+{
+	bool WriteCompressed(const FString& Filename, TArrayView64<const uint8> Payload, int64& OutStoredSize);
+	bool ReadCompressed(const FString& Filename, TArray64<uint8>& OutPayload);
+
+	/** Hash of the full, lower case path, keeps the files of same named assets in different folders apart */
+	uint64 HashPackagePath(const FString& PackageFilename);
+
+	/** Saves next to Filename and renames over it, so neither a concurrent writer nor a reader sees a partial file */
+	bool SaveAtomically(TArrayView64<const uint8> Data, const FString& Filename);
+
+	/**
+	 * Package content as a file LoadPackage and the readers can open, named after the package, its path hash and Suffix.
+	 * A file already holding the same bytes is reused, it may be open in a loaded diff package.
+	 */
+	bool WriteTempPackage(const FString& PackageFilename, const FString& Suffix, TArrayView64<const uint8> Data, FString& OutFilename);
+}
+
+/**
+ * Local cache of downloaded revisions, under Saved/AssetHistory/Revisions.
+ * Each file keeps a full snapshot every few revisions and deltas against that snapshot in between,
+ * so any cached revision is rebuilt from at most two reads and one delta pass.
+ */
+class ASSETHISTORY_API FRevisionStore
+{
+public:
+	static FRevisionStore& Get();
+
+	/**
+	 * Same contract as ISourceControlRevision::Get: fills OutFilename with a temp file holding the revision.
+	 * Served from the store when cached, downloaded and stored otherwise. Game thread, see GetRevisionData.
+	 */
+	bool GetRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, FString& OutFilename);
+
+	/** Writes revision content to the temp file GetRevisionFile would return */
+	static bool WriteRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArrayView64<const uint8> Data, FString& OutFilename);
+
+	/**
+	 * Revision content in memory, for readers that don't need a file. Downloads and stores it on a miss.
+	 * Any thread without bAllowProviderDownload, a miss git's batch fetcher can't serve then returns false.
+	 */
+	bool GetRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArray64<uint8>& OutData, bool bAllowProviderDownload = true);
+
+	/** Downloads through ISourceControlRevision::Get without storing. Providers run their commands from the game thread, so game thread only */
+	static bool DownloadRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, TArray64<uint8>& OutData);
+
+	bool Contains(const FString& PackageFilename, const FString& Revision);
+	bool ReadRevision(const FString& PackageFilename, const FString& Revision, TArray64<uint8>& OutData);
+	bool AddRevision(const FString& PackageFilename, const FString& Revision, TArrayView64<const uint8> Data);
+
+	/** Canonical text of a stored revision (see CanonicalText), built the first time and kept next to it. False when it isn't stored or isn't readable */
+	bool ReadRevisionText(const FString& PackageFilename, const FString& Revision, TArray64<uint8>& OutText);
+
+	/** Bytes on disk against bytes the cached revisions would take as plain files */
+	void GetStats(int64& OutStoredBytes, int64& OutRawBytes);
+
+	/** Memory held by the loaded indices and the snapshot cache */
+	SIZE_T GetAllocatedSize();
+
+private:
+	struct FEntry
+	{
+		FString Revision;
+		/** Index of the snapshot this delta applies to, INDEX_NONE for snapshots */
+		int32 SnapshotIndex = INDEX_NONE;
+		int64 RawSize = 0;
+		int64 StoredSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.Revision << Entry.SnapshotIndex << Entry.RawSize << Entry.StoredSize;
+		}
+	};
+
+	struct FFileIndex
+	{
+		FString Directory;
+		TArray<FEntry> Entries;
+	};
+
+	FFileIndex& FindOrLoadIndex(const FString& PackageFilename);
+	void SaveIndex(const FFileIndex& Index);
+	/** Decompressed snapshot, shared with the cache */
+	TSharedPtr<const TArray64<uint8>> ReadSnapshot(const FString& Filename);
+
+	FString GetEntryFilename(const FFileIndex& Index, int32 EntryIndex) const;
+
+	FCriticalSection Lock;
+	TMap<FString, FFileIndex> Indices;
+
+	/** Most recently used snapshots, consecutive revisions of a file usually share one */
+	TArray<TPair<FString, TSharedPtr<const TArray64<uint8>>>> SnapshotCache;
+};
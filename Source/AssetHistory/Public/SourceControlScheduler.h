@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickableEditorObject.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlRevision.h"
+
+namespace ESourceControlJobPriority
+{
+	enum Type
+	{
+		/** Idle time warm-up */
+		Background,
+		/** Speculative fetches of what the user may open next */
+		Prefetch,
+		/** Bulk work the user started, e.g. a project wide search */
+		Normal,
+		/** Clicks. Ahead of everything else and not bound by the concurrency limit */
+		Interactive,
+	};
+}
+
+typedef uint64 FSourceControlJobId;
+
+DECLARE_DELEGATE_TwoParams(FOnRevisionDataReady, bool /*bSuccess*/, const TArray64<uint8>& /*Data*/);
+
+/**
+ * Single queue for every source control request the plugin makes.
+ * Jobs start by priority then age, within a concurrency limit, and identical requests share one job.
+ */
+class ASSETHISTORY_API FSourceControlScheduler : public FTickableEditorObject
+{
+public:
+	static FSourceControlScheduler& Get();
+
+	/**
+	 * Runs a provider operation asynchronously, OnComplete is called on the game thread with the operation that actually ran.
+	 * Status queries of the same files are merged, the merged job takes the highest priority. Game thread only.
+	 */
+	FSourceControlJobId QueueOperation(const FSourceControlOperationRef& Operation, const TArray<FString>& Files, ESourceControlJobPriority::Type Priority, const FSourceControlOperationComplete& OnComplete);
+
+	/**
+	 * Fetches a revision through the revision store on a worker, OnReady is called on a pool worker. Any thread.
+	 * Provider downloads run on the game thread, a caller that blocks it until OnReady must use the git batch fetcher or the store.
+	 */
+	FSourceControlJobId QueueRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, const FOnRevisionDataReady& OnReady);
+
+	/** Blocking fetch, for workers and for the few places that can't continue without the file. On the game thread it bypasses the queue */
+	bool FetchRevisionData(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, TArray64<uint8>& OutData);
+	bool FetchRevisionFile(const TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe>& Revision, ESourceControlJobPriority::Type Priority, FString& OutFilename);
+
+	/**
+	 * Withdraws one request: its callback is called right away as cancelled (Cancelled result, or bSuccess false).
+	 * The job itself only stops once no other request shares it.
+	 */
+	void Cancel(FSourceControlJobId JobId);
+
+	/** True while the request is queued or running */
+	bool IsActive(FSourceControlJobId JobId) const;
+
+	int32 GetNumPendingJobs() const;
+	int32 GetNumRunningJobs() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	struct FRequest
+	{
+		FSourceControlJobId Id = 0;
+		FSourceControlOperationComplete OnOperationComplete;
+		FOnRevisionDataReady OnRevisionDataReady;
+	};
+
+	struct FJob
+	{
+		uint64 Sequence = 0;
+		ESourceControlJobPriority::Type Priority = ESourceControlJobPriority::Background;
+		FString DedupeKey;
+
+		/** Either an operation or a revision */
+		FSourceControlOperationPtr Operation;
+		TArray<FString> Files;
+		TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> Revision;
+
+		TArray<FRequest> Requests;
+		bool bRunning = false;
+		bool bCancelled = false;
+		bool bFinished = false;
+	};
+
+	FSourceControlJobId AddRequest(TSharedRef<FJob> NewJob, FRequest&& Request);
+
+	/** Starts what the limit allows. Operations only start on the game thread, revisions anywhere */
+	void StartJobs();
+	void StartJob(const TSharedRef<FJob>& Job);
+
+	void OnOperationComplete(const FSourceControlOperationRef& InOperation, ECommandResult::Type InResult, TSharedRef<FJob> Job);
+	void OnRevisionDataComplete(const TSharedRef<FJob>& Job, bool bSuccess, const TArray64<uint8>& Data);
+
+	/** Takes the job out of the queues and returns who still waits on it */
+	TArray<FRequest> FinishJob(const TSharedRef<FJob>& Job);
+
+	mutable FCriticalSection Lock;
+	TArray<TSharedRef<FJob>> PendingJobs;
+	TArray<TSharedRef<FJob>> RunningJobs;
+	TMap<FString, TSharedRef<FJob>> JobsByKey;
+	FSourceControlJobId LastJobId = 0;
+	uint64 LastSequence = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+struct FDiffProgress;
+
+namespace EStructArrayRowDiffType
+{
+	enum Type
+	{
+		Unchanged,
+		Modified,
+		Added,
+		Removed,
+	};
+}
+
+/** One row of the aligned table: an element of either side, or an old and a new element paired by the array diff */
+struct FStructArrayRowDiff
+{
+	int32 OldIndex = INDEX_NONE;
+	int32 NewIndex = INDEX_NONE;
+	EStructArrayRowDiffType::Type DiffType = EStructArrayRowDiffType::Unchanged;
+	/** One bit per field of FStructArrayDiff::Fields, only for modified rows */
+	TBitArray<> ChangedFields;
+};
+
+/** A top level TArray of structs that changed, with its elements aligned. Values are only exported to text for the rows on screen */
+struct FStructArrayDiff
+{
+	const FArrayProperty* Property = nullptr;
+	const UScriptStruct* Struct = nullptr;
+	/** The fields the details panels would show, one column each */
+	TArray<const FProperty*> Fields;
+	/** Array values inside the two objects */
+	const void* OldArray = nullptr;
+	const void* NewArray = nullptr;
+
+	TArray<TSharedPtr<FStructArrayRowDiff>> Rows;
+	int32 NumChangedRows = 0;
+
+	/** Element of the row on its side, null when it only exists on the other one */
+	const uint8* GetOldElement(const FStructArrayRowDiff& Row) const;
+	const uint8* GetNewElement(const FStructArrayRowDiff& Row) const;
+};
+
+namespace StructArrayDiff
+{
+	/**
+	 * Top level arrays of structs with at least MinElements elements on either side that differ, see UAssetHistorySettings::StructArrayTableMinElements.
+	 * Elements are hashed, identical runs are aligned with a longest common subsequence and what is left between them is paired in order.
+	 * Safe on a worker as long as the objects are kept alive. Returns false when Progress was cancelled.
+	 */
+	bool DiffArrays(const UObject* OldObject, const UObject* NewObject, int32 MinElements, TArray<TSharedPtr<FStructArrayDiff>>& OutArrays, FDiffProgress* Progress = nullptr);
+
+	/** Row alignment of two element hash lists */
+	void AlignElements(TArrayView<const uint64> OldHashes, TArrayView<const uint64> NewHashes, TArray<TSharedPtr<FStructArrayRowDiff>>& OutRows);
+}
+
+/* Table diff of large struct arrays: one row per element, one column per field, changed cells highlighted. Only the visible rows are built */
+class SStructArrayDiff : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SStructArrayDiff){}
+		SLATE_ARGUMENT(TArray<TSharedPtr<FStructArrayDiff>>, Arrays)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	const TArray<TSharedPtr<FStructArrayDiff>>& GetArrays() const { return Arrays; }
+
+	/** Shows the array at ArrayIndex and scrolls to Row when it is given */
+	void SelectRow(int32 ArrayIndex, TSharedPtr<FStructArrayRowDiff> Row);
+
+private:
+	void ShowArray(int32 ArrayIndex);
+	void RefreshVisibleRows();
+
+	TSharedRef<ITableRow> OnGenerateArrayRow(TSharedPtr<FStructArrayDiff> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnArraySelectionChanged(TSharedPtr<FStructArrayDiff> Item, ESelectInfo::Type SelectInfo);
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FStructArrayRowDiff> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	TArray<TSharedPtr<FStructArrayDiff>> Arrays;
+	int32 CurrentArray = INDEX_NONE;
+	bool bChangedRowsOnly = false;
+	TArray<TSharedPtr<FStructArrayRowDiff>> VisibleRows;
+
+	TSharedPtr<SListView<TSharedPtr<FStructArrayDiff>>> ArrayListView;
+	TSharedPtr<SBox> TableContents;
+	TSharedPtr<SListView<TSharedPtr<FStructArrayRowDiff>>> RowListView;
+};
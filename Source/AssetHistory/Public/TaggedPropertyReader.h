@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DiffUtils.h"
+
+class FPackageFileReader;
+
+/** One leaf of a property tree read from a package's tagged property stream */
+struct FTaggedPropertyValue
+{
+	/** "Stats.BaseHealth", "Items[3].Name", sub-objects are prefixed with "SubObjectName:" */
+	FString Path;
+	/** Serialized property type, e.g. IntProperty */
+	FName Type;
+	/** Value rendered for display */
+	FString Value;
+	/** Hash of the resolved value, or of the bytes and package tables for blobs. This is what the diff compares */
+	uint64 Hash = 0;
+};
+
+/**
+ * Flat, path sorted property tree of an asset revision, built without LoadPackage.
+ * Tagged serialization skips values equal to the class defaults, so a property missing on one side was set back to (or away from) its default.
+ */
+class FTaggedPropertyTree
+{
+public:
+	/** Reads the asset export of an already opened package and the sub-objects it owns */
+	bool Read(const FPackageFileReader& Package);
+
+	/** Opens Filename and reads it */
+	bool ReadFile(const FString& Filename);
+
+	const TArray<FTaggedPropertyValue>& GetValues() const { return Values; }
+	const FTaggedPropertyValue* Find(const FString& Path) const;
+
+private:
+	TArray<FTaggedPropertyValue> Values;
+};
+
+struct FTaggedPropertyDifference
+{
+	FString Path;
+	EPropertyDiffType::Type DiffType = EPropertyDiffType::PropertyValueChanged;
+	FString OldValue;
+	FString NewValue;
+};
+
+namespace TaggedPropertyDiff
+{
+	/** Merge join of two sorted trees, linear in the number of leaves */
+	void Diff(const FTaggedPropertyTree& OldTree, const FTaggedPropertyTree& NewTree, TArray<FTaggedPropertyDifference>& OutDifferences);
+
+	/** Reads and diffs two package files. Returns false when either file could not be read */
+	bool DiffFiles(const FString& OldFilename, const FString& NewFilename, TArray<FTaggedPropertyDifference>& OutDifferences);
+}